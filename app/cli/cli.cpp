@@ -1,6 +1,7 @@
 #include "./cli.hpp"
 
 #include <cstdlib>    // for exit, size_t, EXIT_SUCCESS
+#include <filesystem> // for path
 #include <functional> // for function
 #include <iostream>   // for basic_ostream, basic_ios, cout, endl, operator<<
 #include <utility>    // for move
@@ -8,6 +9,8 @@
 
 #include "args.hxx" // for ValueFlag, EitherFlag, Flag, get, Subparser
 
+#include "mto/index.hpp" // for EXT
+
 namespace cli
 {
 
@@ -15,12 +18,20 @@ struct decomopose_opts {
 	args::Group decompose;
 	args::Flag hairpins;
 	args::Flag subflubbles;
+	args::Flag compact_chains;
+	args::Flag binary_pvst;
+	args::Flag forest_archive;
+	args::Flag forest_manifest;
 
 	// clang-format off
 	explicit decomopose_opts(args::Subparser &p)
 	    : decompose(p, "Decompose options", args::Group::Validators::DontCare),
 	      hairpins(decompose, "hairpins", "Find hairpins in the variation graph [default: false]", {'h', "hairpins"}),
-	      subflubbles(decompose, "subfubbles", "Find subflubbles in the variation graph [default: false]", {'s', "subflubbles"})
+	      subflubbles(decompose, "subfubbles", "Find subflubbles in the variation graph [default: false]", {'s', "subflubbles"}),
+	      compact_chains(decompose, "compact_chains", "Collapse unbranched chains of vertices before decomposing, the trees are the same. Ignored with --subflubbles or --hairpins [default: false]", {"compact-chains"}),
+	      binary_pvst(decompose, "binary_pvst", "Write the flubble trees in the binary .pvst format [default: false]", {"binary-pvst"}),
+	      forest_archive(decompose, "forest_archive", "Write all the flubble trees into one forest.pvf archive instead of a .pvst file each [default: false]", {"forest-archive"}),
+	      forest_manifest(decompose, "forest_manifest", "Write manifest.tsv with the ref paths and loci of each tree, lets call skip trees. Loads the refs [default: false]", {"forest-manifest"})
 	// clang-format on
 	{}
 };
@@ -101,6 +112,7 @@ void call_handler(args::Subparser &parser, core::config &app_config)
 	args::ValueFlag<std::string> input_gfa(parser, "gfa", "path to input gfa [required]",{'i', "input-gfa"}, args::Options::Required);
 	args::ValueFlag<std::string> forest_dir(parser, "forest_dir","dir containing flubble forest [default: .]",{'f', "forest-dir"});
 	args::ValueFlag<std::string> restrict(parser, "restrict", "Restrict variant calling to a genomic region (format: ref:start-end)", {'g', "restrict"});
+	args::Flag pack_labels(parser, "pack_labels", "Hold vertex labels 2-bit packed, uses less memory", {"pack-labels"});
 	// clang-format on
 	streaming_opts stream_opts(parser);
 	output_opts out_opts(parser);
@@ -113,6 +125,9 @@ void call_handler(args::Subparser &parser, core::config &app_config)
 	// set mandatory call opts for graph
 	app_config.set_inc_vtx_labels(true);
 	app_config.set_inc_refs(true);
+	if (pack_labels) {
+		app_config.set_pack_vtx_labels(true);
+	}
 
 	// input gfa is already a c_str
 	app_config.set_input_gfa(args::get(input_gfa));
@@ -159,6 +174,7 @@ void gfa2vcf_handler(args::Subparser &parser, core::config &app_config)
 	args::Group arguments("arguments");
 	// clang-format off
 	args::ValueFlag<std::string> input_gfa(parser, "gfa", "path to input gfa [required]", {'i', "input-gfa"}, args::Options::Required);
+	args::Flag pack_labels(parser, "pack_labels", "Hold vertex labels 2-bit packed, uses less memory", {"pack-labels"});
 	// clang-format on
 	decomopose_opts decomp_opts(parser);
 	streaming_opts stream_opts(parser);
@@ -170,6 +186,9 @@ void gfa2vcf_handler(args::Subparser &parser, core::config &app_config)
 	// set mandatory call opts for graph
 	app_config.set_inc_vtx_labels(true);
 	app_config.set_inc_refs(true);
+	if (pack_labels) {
+		app_config.set_pack_vtx_labels(true);
+	}
 
 	app_config.set_task(core::task_e::gfa2vcf);
 	app_config.set_input_gfa(args::get(input_gfa));
@@ -182,6 +201,22 @@ void gfa2vcf_handler(args::Subparser &parser, core::config &app_config)
 		if (decomp_opts.subflubbles) {
 			app_config.set_subflubbles(true);
 		}
+
+		if (decomp_opts.compact_chains) {
+			app_config.set_compact_chains(true);
+		}
+
+		if (decomp_opts.binary_pvst) {
+			app_config.set_binary_pvst(true);
+		}
+
+		if (decomp_opts.forest_archive) {
+			app_config.set_forest_archive(true);
+		}
+
+		if (decomp_opts.forest_manifest) {
+			app_config.set_forest_manifest(true);
+		}
 	}
 
 	{ // output options
@@ -252,6 +287,21 @@ void decompose_handler(args::Subparser &parser, core::config &app_config)
 
 		if (decomp_opts.subflubbles)
 			app_config.set_subflubbles(true);
+
+		if (decomp_opts.compact_chains)
+			app_config.set_compact_chains(true);
+
+		if (decomp_opts.binary_pvst)
+			app_config.set_binary_pvst(true);
+
+		if (decomp_opts.forest_archive)
+			app_config.set_forest_archive(true);
+
+		// the manifest is made from the ref walks
+		if (decomp_opts.forest_manifest) {
+			app_config.set_forest_manifest(true);
+			app_config.set_inc_refs(true);
+		}
 	}
 
 	// input gfa is already a c_str
@@ -261,6 +311,33 @@ void decompose_handler(args::Subparser &parser, core::config &app_config)
 		app_config.set_output_dir(args::get(output_dir));
 }
 
+void index_handler(args::Subparser &parser, core::config &app_config)
+{
+	args::Group arguments("arguments");
+	// clang-format off
+	args::ValueFlag<std::string> input_gfa(parser, "gfa", "path to input gfa [required]", {'i', "input-gfa"}, args::Options::Required);
+	args::ValueFlag<std::string> output(parser, "output", "Output index file [default: <input>.pvg]", {'o', "output"});
+	// clang-format on
+
+	parser.Parse();
+	app_config.set_task(core::task_e::index);
+
+	// keep the labels and the refs so the index can stand in for the GFA
+	app_config.set_inc_vtx_labels(true);
+	app_config.set_inc_refs(true);
+
+	// input gfa is already a c_str
+	app_config.set_input_gfa(args::get(input_gfa));
+
+	if (output) {
+		app_config.set_index_fp(args::get(output));
+	}
+	else {
+		std::filesystem::path fp{args::get(input_gfa)};
+		app_config.set_index_fp(fp.replace_extension(mto::index::EXT));
+	}
+}
+
 void prune_handler(args::Subparser &parser, core::config &app_config)
 {
 	args::Group arguments("arguments");
@@ -336,6 +413,8 @@ int cli(int argc, char **argv, core::config &app_config)
 			   [&](args::Subparser &parser) { call_handler(parser, app_config); });
 	args::Command info(commands, "info", "Print graph information [uses 1 thread]",
 			   [&](args::Subparser &parser) { info_handler(parser, app_config); });
+	args::Command index(commands, "index", "Write a binary graph index usable in place of the GFA",
+			    [&](args::Subparser &parser) { index_handler(parser, app_config); });
 	args::Command prune(commands, "prune", "Reduce GFA to graph structure",
 			    [&](args::Subparser &parser) { prune_handler(parser, app_config); });
 	args::Command vcf(commands, "vcf", "Analyse a VCF file against the graph",
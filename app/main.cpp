@@ -2,6 +2,7 @@
 #include "./subcommand/call.hpp"      // for do_call
 #include "./subcommand/decompose.hpp" // for do_decompose
 #include "./subcommand/gfa2vcf.hpp"   // for do_gfa2vcf
+#include "./subcommand/index.hpp"     // for do_index
 #include "./subcommand/info.hpp"      // for do_info
 #include "./subcommand/prune.hpp"     // for do_prune
 #include "./subcommand/vcf.hpp"	      // for do_vcf
@@ -27,6 +28,9 @@ int main(int argc, char *argv[])
 	case core::task_e::gfa2vcf:
 		pv::gfa2vcf::do_gfa2vcf(app_config);
 		break;
+	case core::task_e::index:
+		pv::index::do_index(app_config);
+		break;
 	case core::task_e::info:
 		pv::info::do_info(app_config);
 		break;
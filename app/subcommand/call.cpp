@@ -1,40 +1,178 @@
 #include "./call.hpp"
 
-#include <cassert>    // for assert
-#include <cstdlib>    // for size_t, exit, EXIT_FAILURE
-#include <filesystem> // for path
-#include <memory>     // for make_unique, unique_ptr
-// #include <optional>   // for optional
-#include <set>	   // for set
-#include <string>  // for basic_string, string, cha...
-#include <thread>  // for thread
-#include <utility> // for move
-#include <vector>  // for vector
+#include <algorithm>	// for sort, min, max, remove_if
+#include <cassert>	// for assert
+#include <charconv>	// for from_chars
+#include <cstdlib>	// for size_t, exit, EXIT_FAILURE
+#include <filesystem>	// for path
+#include <memory>	// for make_unique, unique_ptr
+#include <optional>	// for optional
+#include <set>		// for set
+#include <string>	// for basic_string, string, cha...
+#include <system_error>	// for errc
+#include <thread>	// for thread
+#include <utility>	// for move
+#include <vector>	// for vector
 
 #include "ita/genomics/genomics.hpp" // for gen_vcf_rec_map
 #include "ita/genomics/vcf.hpp"	     // for VcfRecIdx
+#include "ita/variation/rov.hpp"     // for parse_genomic_region
 
-#include "mto/common.hpp"    // for get_files, read_lines_to_...
-#include "mto/from_gfa.hpp"  // for to_bd
-#include "mto/from_pvst.hpp" // for read_pvst
+#include "mto/common.hpp"	 // for get_files, read_lines_to_...
+#include "mto/forest.hpp"	 // for FILE_NAME
+#include "mto/from_forest.hpp"	 // for Reader, is_forest
+#include "mto/from_gfa.hpp"	 // for to_bd
+#include "mto/from_manifest.hpp" // for read_manifest, find_skips
+#include "mto/from_pvst.hpp"	 // for read_pvst
+#include "mto/manifest.hpp"	 // for FILE_NAME, region_t
 #include "mto/to_structure_export.hpp"
-#include "mto/to_vcf.hpp"    // for VcfOutput, init_vcfs, wri...
+#include "mto/to_vcf.hpp"	 // for VcfOutput, init_vcfs, wri...
 
 #include "povu/common/bounded_queue.hpp" // for pbq, bounded_queue
+#include "povu/common/constants.hpp"	 // for INVALID_IDX
 #include "povu/common/core.hpp"		 // for pt, id_t
-#include "povu/common/log.hpp"		 // for ERR
+#include "povu/common/log.hpp"		 // for ERR, INFO
+#include "povu/common/thread.hpp"	 // for thread_pool, for_chunks
 #include "povu/graph/bidirected.hpp"	 // for VG, bd
 #include "povu/graph/pvst.hpp"		 // for Tree
 
 namespace povu::subcommands::call
 {
 namespace fs = std::filesystem;
+namespace pc = povu::constants;
+namespace pth = povu::thread;
 
 /**
- * loop through the .pvst files and read them
+ * the forest archive given as the forest dir itself or inside it, empty when
+ * there is none
  */
-void read_pvsts(const core::config &app_config, std::vector<pvst::Tree> &pvsts)
+fs::path find_forest_archive(const fs::path &forest_dir)
 {
+	fs::path fp = fs::is_directory(forest_dir)
+			      ? forest_dir / mto::forest::FILE_NAME
+			      : forest_dir;
+
+	if (fs::is_regular_file(fp) && mto::from_forest::is_forest(fp))
+		return fp;
+
+	return {};
+}
+
+/**
+ * the forest manifest next to the trees, empty when there is none
+ */
+fs::path find_manifest(const fs::path &forest_dir)
+{
+	fs::path dir = fs::is_directory(forest_dir) ? forest_dir
+						    : forest_dir.parent_path();
+	fs::path fp = dir / mto::manifest::FILE_NAME;
+
+	return fs::is_regular_file(fp) ? fp : fs::path{};
+}
+
+/**
+ * the components whose trees cannot give a record for the refs to call or
+ * within the region, see mto::from_manifest::find_skips
+ */
+std::set<std::size_t> manifest_skips(const fs::path &fp, const bd::VG &g,
+				     const std::set<pt::id_t> &vcf_ref_ids,
+				     const core::config &app_config)
+{
+	std::set<std::string> tags;
+	for (pt::id_t ref_id : vcf_ref_ids)
+		tags.insert(g.get_tag(ref_id));
+
+	std::optional<mto::manifest::region_t> region;
+	if (app_config.has_genomic_region()) {
+		std::optional<ir::genomic_region> gr = ir::parse_genomic_region(
+			app_config.get_genomic_region().value());
+		if (gr)
+			region = mto::manifest::region_t{gr->ref_name,
+							 gr->start, gr->end};
+	}
+
+	std::set<std::uint64_t> skips = mto::from_manifest::find_skips(
+		mto::from_manifest::read_manifest(fp.string()), tags, region);
+
+	return {skips.begin(), skips.end()};
+}
+
+/**
+ * component id of a .pvst file, files from decompose are named after it
+ */
+std::size_t pvst_component_id(const fs::path &fp)
+{
+	const std::string stem = fp.stem().string();
+	std::size_t id{};
+	auto [end, ec] =
+		std::from_chars(stem.data(), stem.data() + stem.size(), id);
+
+	bool is_id = ec == std::errc() && end == stem.data() + stem.size();
+	return is_id ? id : pc::INVALID_IDX;
+}
+
+/**
+ * read, parse and compute the heights of @p n trees on the thread pool
+ *
+ * @param load returns tree i, called from several threads at once
+ * @param pvsts tree i ends up at index i whatever order they finish in
+ */
+template <typename F>
+void load_pvsts(std::size_t n, std::size_t thread_count, F load,
+		std::vector<pvst::Tree> &pvsts)
+{
+	pvsts.resize(n);
+
+	auto load_range = [&](std::size_t b, std::size_t e)
+	{
+		for (std::size_t i{b}; i < e; i++) {
+			pvst::Tree pvst = load(i);
+			pvst.comp_heights();
+			pvsts[i] = std::move(pvst);
+		}
+	};
+
+	thread_count = std::min(thread_count, n);
+	if (thread_count <= 1) {
+		load_range(0, n);
+		return;
+	}
+
+	pth::thread_pool pool(thread_count);
+	pth::for_chunks(&pool, static_cast<pt::idx_t>(n), load_range);
+}
+
+/**
+ * read the trees of the forest, either from the forest archive or from the
+ * .pvst files, in increasing component id order
+ *
+ * @param skips when given the trees of these components are not read
+ */
+void read_pvsts(const core::config &app_config, std::vector<pvst::Tree> &pvsts,
+		const std::set<std::size_t> *skips = nullptr)
+{
+	const std::size_t thread_count =
+		std::max<std::size_t>(1, app_config.thread_count());
+
+	auto is_skipped = [skips](std::size_t component_id)
+	{ return skips != nullptr && skips->count(component_id) > 0; };
+
+	// one open for the whole forest
+	if (fs::path fp = find_forest_archive(app_config.get_forest_dir());
+	    !fp.empty()) {
+		mto::from_forest::Reader forest(fp.string());
+
+		std::vector<std::size_t> idxs;
+		for (std::size_t i{}; i < forest.size(); i++)
+			if (!is_skipped(forest.component_id(i)))
+				idxs.push_back(i);
+
+		auto load = [&forest, &idxs](std::size_t i)
+		{ return forest.read(idxs[i]); };
+		load_pvsts(idxs.size(), thread_count, load, pvsts);
+
+		return;
+	}
 
 	// get the list of files in the forest dir that end in .pvst
 	std::vector<fs::path> fps =
@@ -46,13 +184,24 @@ void read_pvsts(const core::config &app_config, std::vector<pvst::Tree> &pvsts)
 		exit(EXIT_FAILURE);
 	}
 
-	// TODO: [c] parallelise
-	// loop through the .pvst files and read them
-	for (std::size_t i{}; i < fps.size(); i++) {
-		pvst::Tree pvst = mto::from_pvst::read_pvst(fps[i].string());
-		pvst.comp_heights();
-		pvsts.push_back(std::move(pvst));
-	}
+	// files not named after a component are not in the manifest, keep them
+	fps.erase(std::remove_if(fps.begin(), fps.end(),
+				 [&](const fs::path &fp)
+				 { return is_skipped(pvst_component_id(fp)); }),
+		  fps.end());
+
+	// the directory order is arbitrary, sort to keep the output stable
+	std::sort(fps.begin(), fps.end(),
+		  [](const fs::path &a, const fs::path &b)
+		  {
+			  std::size_t a_id = pvst_component_id(a);
+			  std::size_t b_id = pvst_component_id(b);
+			  return a_id != b_id ? a_id < b_id : a < b;
+		  });
+
+	load_pvsts(
+		fps.size(), thread_count, [&fps](std::size_t i)
+		{ return mto::from_pvst::read_pvst(fps[i].string()); }, pvsts);
 }
 
 void get_ref_prefixes_from_file(core::config &app_config)
@@ -79,8 +228,21 @@ void do_call(core::config &app_config)
 	// read graph
 	std::thread read_graph([&] { g = mto::from_gfa::to_bd(app_config); });
 
+	/*
+	 * with a manifest the trees are read once the refs are known, so that
+	 * those that cannot give a record are not read at all. The structure
+	 * export holds every tree so it needs them all.
+	 */
+	const fs::path manifest_fp =
+		app_config.has_structure_export_path()
+			? fs::path{}
+			: find_manifest(app_config.get_forest_dir());
+
 	// read PVST
-	std::thread read_pvsts_async([&] { read_pvsts(app_config, pvsts); });
+	std::thread read_pvsts_async;
+	if (manifest_fp.empty())
+		read_pvsts_async =
+			std::thread([&] { read_pvsts(app_config, pvsts); });
 
 	// read references either from file or directly from params
 	std::thread get_refs_async([&]
@@ -110,6 +272,19 @@ void do_call(core::config &app_config)
 	assert(vcf_ref_ids.size() > 0 && "could not match ref ids to prefixes");
 #endif
 
+	if (!manifest_fp.empty()) {
+		std::set<std::size_t> skips = manifest_skips(
+			manifest_fp, *g, vcf_ref_ids, app_config);
+
+		if (app_config.verbosity() > 1)
+			INFO("Skipping the trees of {} components using {}",
+			     skips.size(), manifest_fp.string());
+
+		read_pvsts_async = std::thread(
+			[&, skips = std::move(skips)]
+			{ read_pvsts(app_config, pvsts, &skips); });
+	}
+
 	mto::to_vcf::VcfOutput vout =
 		app_config.get_stdout_vcf()
 			? mto::to_vcf::VcfOutput::to_stdout()
@@ -1,40 +1,82 @@
 #include "./decompose.hpp"
 
-#include <cstddef>    // for size_t
-#include <cstdint>    // for uint32_t
-#include <functional> // for ref, reference_wrapper
-#include <iostream>   // for basic_ostream, cerr, operat...
-#include <string>     // for basic_string, operator<<
-#include <thread>     // for thread
-#include <utility>    // for get, make_pair, pair
-#include <vector>     // for vector
+#include <algorithm>    // for max
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint64_t
+#include <filesystem>   // for path, remove
+#include <iostream>     // for basic_ostream, cerr, operat...
+#include <memory>       // for unique_ptr, make_unique
+#include <stdexcept>    // for runtime_error
+#include <string>       // for basic_string, operator<<
+#include <system_error> // for error_code
+#include <thread>       // for hardware_concurrency
+#include <utility>      // for move
+#include <vector>       // for vector
 
 #include "fmt/core.h" // for format
 
-#include "mto/from_gfa.hpp" // for to_bd
+#include "mto/forest.hpp"      // for FILE_NAME
+#include "mto/from_gfa.hpp"    // for to_bd
+#include "mto/manifest.hpp"    // for FILE_NAME
+#include "mto/to_forest.hpp"   // for Writer
 #include "mto/to_gfa.hpp"
-#include "mto/to_pvst.hpp" // for write_pvst, pv_to_pvst
-
-#include "povu/algorithms/concealed.hpp" // for find_concealed
-#include "povu/algorithms/flubbles.hpp"	 // for flubbles
-#include "povu/algorithms/midi.hpp"	 // for find_midi
-#include "povu/algorithms/parallel.hpp"	 // for find_parallel
-#include "povu/algorithms/smothered.hpp" // for find_smothered
-#include "povu/algorithms/tiny.hpp"	 // for find_tiny
-#include "povu/common/app.hpp"		 // for config
-#include "povu/common/compat.hpp"	 // for pv_cmp, format
-#include "povu/graph/bidirected.hpp"	 // for bidirected
-#include "povu/graph/pvst.hpp"		 // for pvst
-#include "povu/graph/spanning_tree.hpp"	 // for spanning_tree
-#include "povu/graph/tree_utils.hpp"	 // for tree_utils
+#include "mto/to_manifest.hpp" // for Writer, ref_ranges
+#include "mto/to_pvst.hpp"     // for write_pvst, pv_to_pvst
+
+#include "povu/algorithms/flubbles.hpp"	   // for flubbles
+#include "povu/algorithms/subflubbles.hpp" // for find_subflubbles
+#include "povu/common/app.hpp"		   // for config
+#include "povu/common/arena.hpp"	   // for Arena
+#include "povu/common/compat.hpp"	   // for pv_cmp, format
+#include "povu/common/thread.hpp"	   // for thread_pool, task_group
+#include "povu/graph/bidirected.hpp"	   // for bidirected
+#include "povu/graph/pvst.hpp"		   // for pvst
+#include "povu/graph/spanning_tree.hpp"	   // for spanning_tree
+#include "povu/graph/tree_utils.hpp"	   // for tree_utils
 
 namespace povu::subcommands::decompose
 {
 namespace ptu = povu::tree_utils;
 namespace pfl = povu::flubbles;
 
+pt::u32 thread_count(const core::config &app_config)
+{
+	unsigned int total_threads = std::thread::hardware_concurrency();
+
+	pt::u32 conf_num_threads =
+		static_cast<std::size_t>(app_config.thread_count());
+
+	return (conf_num_threads > total_threads) ? total_threads
+						  : conf_num_threads;
+}
+
+/**
+ * remove a forest archive or manifest left in the output dir by an earlier
+ * run, call prefers them over the .pvst files this run writes
+ */
+void remove_stale(const std::filesystem::path &fp)
+{
+	std::error_code ec;
+	if (std::filesystem::remove(fp, ec))
+		WARN("Removed {} from an earlier run", fp.string());
+	else if (ec)
+		throw std::runtime_error(fmt::format(
+			"Could not remove {}: {}", fp.string(), ec.message()));
+}
+
+/**
+ * @param forest when given the tree goes into this archive instead of its
+ * own .pvst file
+ * @param arena when given it must outlive the call, the spanning tree
+ * allocates from it
+ * @param pool when given the equivalence classes and the subflubbles of a
+ * large tree are found across it
+ */
 void decompose_component(bd::VG *g, std::size_t component_id,
-			 const core::config &app_config)
+			 const core::config &app_config,
+			 mto::to_forest::Writer *forest = nullptr,
+			 povu::arena::Arena *arena = nullptr,
+			 povu::thread::thread_pool *pool = nullptr)
 {
 	const std::string fn_name =
 		pv_cmp::format("[{}::{}]", MODULE, __func__);
@@ -47,10 +89,10 @@ void decompose_component(bd::VG *g, std::size_t component_id,
 	}
 #endif
 
-	pst::Tree st = pst::Tree::from_bd(*g);
+	pst::Tree st = pst::Tree::from_bd(*g, arena);
 	delete g;
 
-	pvst::Tree flubble_tree = pfl::find_flubbles(st, app_config);
+	pvst::Tree flubble_tree = pfl::find_flubbles(st, app_config, pool);
 
 #ifdef DEBUG
 	if (app_config.verbosity() > 4) {
@@ -62,34 +104,90 @@ void decompose_component(bd::VG *g, std::size_t component_id,
 
 	if (app_config.find_subflubbles()) {
 		ptu::tree_meta tm = ptu::gen_tree_meta(st);
-		povu::tiny::find_tiny(st, flubble_tree, tm);
-		povu::parallel::find_parallel(st, flubble_tree, tm);
-		povu::concealed::find_concealed(st, flubble_tree, tm);
-		povu::midi::find_midi(st, flubble_tree, tm);
-		povu::smothered::find_smothered(st, flubble_tree, tm);
+		povu::subflubbles::find_subflubbles(st, flubble_tree, tm,
+						    pool);
 	}
 
-	mto::to_pvst::write_pvst(flubble_tree, std::to_string(component_id),
-				 app_config);
+	if (forest != nullptr)
+		forest->add(component_id, flubble_tree);
+	else
+		mto::to_pvst::write_pvst(flubble_tree,
+					 std::to_string(component_id),
+					 app_config);
 
 	return;
 }
 
-std::pair<uint32_t, uint32_t> thread_count(const core::config &app_config,
-					   std::size_t item_count)
+namespace
 {
-	/* Divide the number of components into chunks for each thread */
-	unsigned int total_threads = std::thread::hardware_concurrency();
+// components with fewer vertices have no flubbles to find
+constexpr pt::idx_t MIN_VTX_COUNT = 3;
+// components lighter than this (vertices + edges) are batched into one task
+constexpr std::uint64_t SMALL_COMPONENT_WEIGHT = 1 << 12;
+// a batch of small components is closed once it is this heavy
+constexpr std::uint64_t BATCH_WEIGHT = 1 << 16;
+// first block of the arena of a component, per unit of weight
+constexpr std::uint64_t ARENA_BYTES_PER_WEIGHT = 32;
+
+/**
+ * what the components of a graph share while they are decomposed
+ */
+struct shared_t {
+	const core::config &app_config;
+	bool print_summary;
+	// whether runs of unbranched vertices are shortened first
+	bool compact;
+	mto::to_forest::Writer *forest;
+	mto::to_manifest::Writer *manifest;
+	povu::thread::thread_pool &pool;
+};
+
+void handle_component(bd::ComponentGenerator &components, pt::idx_t c,
+		      shared_t &sh)
+{
+	const core::config &app_config = sh.app_config;
+	pt::u32 component_id{c + 1};
 
-	pt::u32 conf_num_threads =
-		static_cast<std::size_t>(app_config.thread_count());
-	uint32_t num_threads = (conf_num_threads > total_threads)
-				       ? total_threads
-				       : conf_num_threads;
-	uint32_t chunk_size = item_count / num_threads;
+	if (app_config.verbosity())
+		INFO("Handling component: {}", component_id);
+
+	// the refs are only in the whole graph, components do not copy them
+	if (sh.manifest != nullptr) {
+		const bd::VG &g = components.graph();
+		sh.manifest->add(component_id, mto::to_manifest::ref_ranges(
+						    g, components.vtxs(c)));
+	}
+
+	// the per vertex lists of the component graph and its spanning tree
+	// come from one arena that is freed at once when the component is done
+	std::uint64_t w = static_cast<std::uint64_t>(components.vtx_count(c)) +
+			  components.edge_count(c);
+	povu::arena::Arena arena{w * ARENA_BYTES_PER_WEIGHT};
+
+	bd::VG *cg = components.extract(c, &arena);
+
+	if (sh.compact) {
+		bd::VG *compacted = bd::VG::compact_chains(*cg, &arena);
+		delete cg;
+		cg = compacted;
+	}
+
+	if (sh.print_summary)
+		cg->summary(false);
 
-	return std::make_pair(num_threads, chunk_size);
+	/*
+	  the classes and subflubbles of a large tree are split across the
+	  pool, workers that are free once the components ahead of them are
+	  done join in
+	*/
+	povu::thread::thread_pool *pool =
+		sh.pool.size() > 1 ? &sh.pool : nullptr;
+
+	// takes ownership of cg
+	decompose_component(cg, component_id, app_config, sh.forest, &arena,
+			    pool);
 }
+} // namespace
 
 void do_decompose(const core::config &app_config)
 {
@@ -99,62 +197,112 @@ void do_decompose(const core::config &app_config)
 	if (ll > 1)
 		INFO("Finding components");
 
-	std::vector<bd::VG *> components = bd::VG::componetize(*g);
-
-	delete g;
+	// components are built on demand so only those in flight are in memory
+	bd::ComponentGenerator components(*g, app_config.thread_count());
 
 	if (ll > 1)
 		INFO("Found {} components", components.size());
 
-	std::pair<pt::u32, pt::u32> thread_config =
-		thread_count(app_config, components.size());
-
-	pt::u32 num_threads = thread_config.first;
-	pt::u32 chunk_size = thread_config.second;
-
-	/* Create and launch threads */
-	std::vector<std::thread> threads(num_threads);
-	pt::u32 start, end;
-	for (pt::u32 thread_idx{}; thread_idx < num_threads; ++thread_idx) {
-		start = thread_idx * chunk_size;
-		end = (thread_idx == num_threads - 1)
-			      ? components.size()
-			      : (thread_idx + 1) * chunk_size;
+	pt::u32 num_threads = std::max<pt::u32>(1, thread_count(app_config));
+	bool print_summary = ll > 3 && num_threads == 1;
+
+	// the subflubbles and hairpins depend on the layout of the spanning
+	// tree, only the flubble trees are the same in a compacted graph
+	bool compact = app_config.compact_chains();
+	if (compact &&
+	    (app_config.find_subflubbles() || app_config.inc_hairpins())) {
+		WARN("Not compacting chains, the subflubbles and hairpins need "
+		     "the whole graph");
+		compact = false;
+	}
 
-		threads[thread_idx] = std::thread(
-			[start, end, num_threads, app_config, ll, &components]
+	// all the trees go into one file instead of a file per component
+	const std::filesystem::path forest_fp =
+		std::filesystem::path{app_config.get_output_dir()} /
+		mto::forest::FILE_NAME;
+	std::unique_ptr<mto::to_forest::Writer> forest;
+	if (app_config.forest_archive())
+		forest = std::make_unique<mto::to_forest::Writer>(forest_fp);
+	else
+		remove_stale(forest_fp);
+
+	// the ref ranges of each tree, for call to skip trees
+	const std::filesystem::path manifest_fp =
+		std::filesystem::path{app_config.get_output_dir()} /
+		mto::manifest::FILE_NAME;
+	std::unique_ptr<mto::to_manifest::Writer> manifest;
+	if (app_config.forest_manifest() && app_config.inc_refs())
+		manifest =
+			std::make_unique<mto::to_manifest::Writer>(manifest_fp);
+	else if (app_config.forest_manifest())
+		WARN("No manifest written, the refs were not loaded");
+
+	if (!manifest)
+		remove_stale(manifest_fp);
+
+	/*
+	 * Queue the components largest first so that the largest ones start
+	 * early and the small ones fill in the gaps, wall clock time is then
+	 * close to the time of the largest component. Small components are
+	 * queued in batches to keep the per task overhead low.
+	 */
+	povu::thread::thread_pool pool(num_threads);
+	povu::thread::task_group tg(pool);
+	shared_t sh{app_config, print_summary, compact, forest.get(),
+		    manifest.get(), pool};
+
+	std::vector<pt::idx_t> batch;
+	std::uint64_t batch_weight{};
+
+	auto run_batch = [&]()
+	{
+		if (batch.empty())
+			return;
+
+		tg.run(
+			[&, b = std::move(batch)]
 			{
-				for (pt::u32 i{start}; i < end; i++) {
-
-					pt::u32 component_id{i + 1};
-
-					if (app_config.verbosity())
-						INFO("Handling component: {}",
-						     component_id);
-
-					pt::u32 N = components[i]->vtx_count();
-					if (N < 3) {
-						// clang-format off
-						if (ll > 2)
-							INFO("Skipping component {} because it is too small. (size: {})", component_id, N);
-						// clang-format on
-						continue;
-					}
-
-					if (ll > 3 && num_threads == 1)
-						components[i]->summary(false);
-
-					// pass app_config by reference
-					decompose_component(
-						components[i], component_id,
-						std::ref(app_config));
-				}
+				for (pt::idx_t c : b)
+					handle_component(components, c, sh);
 			});
+		batch.clear();
+		batch_weight = 0;
+	};
+
+	for (pt::idx_t c : components.by_size()) {
+		pt::idx_t N = components.vtx_count(c);
+		if (N < MIN_VTX_COUNT) {
+			// clang-format off
+			if (ll > 2)
+				INFO("Skipping component {} because it is too small. (size: {})", c + 1, N);
+			// clang-format on
+			continue;
+		}
+
+		std::uint64_t w = static_cast<std::uint64_t>(N) +
+				  components.edge_count(c);
+
+		if (w >= SMALL_COMPONENT_WEIGHT) {
+			tg.run([&, c] { handle_component(components, c, sh); });
+			continue;
+		}
+
+		batch.push_back(c);
+		batch_weight += w;
+		if (batch_weight >= BATCH_WEIGHT)
+			run_batch();
 	}
+	run_batch();
 
-	// Wait for all threads to finish
-	for (auto &thread : threads)
-		thread.join();
+	tg.wait();
+
+	if (forest)
+		forest->finish();
+
+	if (manifest)
+		manifest->finish();
+
+	delete g;
 
 	return;
 }
@@ -49,6 +49,12 @@ void do_gfa2vcf(const core::config &app_config)
 	core::config decompose_config = app_config;
 	decompose_config.set_task(core::task_e::decompose);
 	decompose_config.set_output_dir(temp_dir_str);
+	// decomposition only needs the graph structure, and the refs for the
+	// manifest
+	decompose_config.set_inc_vtx_labels(false);
+	decompose_config.set_inc_refs(app_config.forest_manifest());
+	// the forest is only handed over to call, keep it in one archive
+	decompose_config.set_forest_archive(true);
 
 	try {
 		// Run decompose
@@ -0,0 +1,38 @@
+#include "./index.hpp"
+
+#include <filesystem> // for absolute, path
+#include <string>     // for string
+
+#include "mto/from_gfa.hpp"   // for to_bd
+#include "mto/from_index.hpp" // for is_index, source_gfa
+#include "mto/to_index.hpp"   // for write_index
+
+#include "povu/common/app.hpp"	     // for config
+#include "povu/common/log.hpp"	     // for INFO
+#include "povu/graph/bidirected.hpp" // for VG
+
+namespace povu::subcommands::index
+{
+namespace fs = std::filesystem;
+
+void do_index(const core::config &app_config)
+{
+	pt::u32 ll = app_config.verbosity(); // ll for log level
+	const std::string &in_fp = app_config.get_input_gfa();
+
+	// re-indexing an index keeps pointing at the original GFA
+	std::string src_gfa = mto::from_index::is_index(in_fp)
+				      ? mto::from_index::source_gfa(in_fp)
+				      : fs::absolute(in_fp).string();
+
+	bd::VG *g = mto::from_gfa::to_bd(app_config); // read graph
+
+	if (ll > 1)
+		INFO("Writing graph index to {}",
+		     app_config.get_index_fp().string());
+
+	mto::to_index::write_index(*g, src_gfa, app_config.get_index_fp());
+
+	delete g;
+}
+} // namespace povu::subcommands::index
@@ -0,0 +1,15 @@
+#ifndef PV_SUBCOMMANDS_INDEX_HPP
+#define PV_SUBCOMMANDS_INDEX_HPP
+
+#include <string_view> // for string_view
+
+#include "povu/common/app.hpp"
+
+namespace povu::subcommands::index
+{
+constexpr std::string_view MODULE = "povu::subcommands::index";
+
+void do_index(const core::config &app_config);
+} // namespace povu::subcommands::index
+
+#endif
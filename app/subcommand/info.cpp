@@ -2,7 +2,6 @@
 
 #include <iostream> // for basic_ostream, basic_ios, cerr
 #include <string>   // for basic_string, operator<<, string
-#include <vector>   // for vector
 
 #include <fmt/core.h> // for format
 
@@ -10,7 +9,7 @@
 
 #include "povu/common/compat.hpp"    // for format, pv_cmp
 #include "povu/common/core.hpp"	     // for idx_t, pt
-#include "povu/graph/bidirected.hpp" // for VG
+#include "povu/graph/bidirected.hpp" // for VG, ComponentGenerator
 
 namespace povu::subcommands::info
 {
@@ -26,20 +25,19 @@ void do_info(const core::config &app_config)
 
 	bd::VG *g = mto::from_gfa::to_bd(app_config);
 
-	std::vector<bd::VG *> components = bd::VG::componetize(*g);
-
-	delete g;
+	bd::ComponentGenerator components(*g, app_config.thread_count());
 
 	std::cerr << pv_cmp::format("{} Component count {}\n", fn_name,
 				    components.size());
 
+	// one component in memory at a time
 	for (pt::idx_t i{}; i < components.size(); ++i) {
-		bd::VG *c = components[i];
+		bd::VG *c = components.extract(i);
 		c->summary(app_config.print_tips());
 		delete c;
-		components[i] = nullptr;
 	}
-	components.clear();
+
+	delete g;
 
 	return;
 }
@@ -1,7 +1,6 @@
 #include "./prune.hpp"
 
 #include <string>
-#include <vector> // for vector
 
 #include "mto/from_gfa.hpp" // for to_bd
 #include "mto/to_gfa.hpp"   // for write_gfa
@@ -22,21 +21,24 @@ void do_prune(const core::config &app_config)
 	if (ll > 1)
 		INFO("Finding components");
 
-	std::vector<bd::VG *> components = bd::VG::componetize(*g);
-
-	delete g;
+	bd::ComponentGenerator components(*g, app_config.thread_count());
 
 	if (ll > 1)
 		INFO("Found {} components", components.size());
 
 	std::string out_dir = app_config.get_output_dir();
 
+	// one component in memory at a time
 	for (pt::u32 i{}; i < components.size(); ++i) {
+		bd::VG *c = components.extract(i);
 		std::string fp =
 			pv_cmp::format("{}/component_{}.gfa", out_dir, i + 1);
-		mto::to_gfa::write_gfa(*components[i], fp);
+		mto::to_gfa::write_gfa(*c, fp);
+		delete c;
 	}
 
+	delete g;
+
 	return;
 }
 
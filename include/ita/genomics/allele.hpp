@@ -811,7 +811,7 @@ public:
 				pt::u32 v_id = rov.get_sorted_vertex(j);
 
 				pt::u32 v_idx = g.v_id_to_idx(v_id);
-				const std::vector<pt::idx_t> &ref_idxs =
+				pv_cmp::span<const pt::idx_t> ref_idxs =
 					g.get_vertex_ref_idxs(v_idx, h_idx);
 				pt::u32 depth = ref_idxs.size();
 
@@ -820,8 +820,8 @@ public:
 
 				if (depth == 1) {
 					const lq::ref_walk *h_w =
-						g.get_ref_vec(h_idx)
-							->walk;	 // the hap walk
+						g.get_ref_walk(
+							h_idx); // the hap walk
 					pt::u32 k = ref_idxs[0]; // index in the
 								 // hap walk
 					pgt::or_e orn =
@@ -65,8 +65,8 @@ struct extension {
 			}
 			std::cerr << "\n";
 		};
-		const lq::ref_walk *ref_w1 = g.get_ref_vec(f_r_idx)->walk;
-		const lq::ref_walk *ref_w2 = g.get_ref_vec(r_r_idx)->walk;
+		const lq::ref_walk *ref_w1 = g.get_ref_walk(f_r_idx);
+		const lq::ref_walk *ref_w2 = g.get_ref_walk(r_r_idx);
 
 		print(ref_w1, f_ref_start, len);
 		print(ref_w2, r_ref_start - len + 1, len);
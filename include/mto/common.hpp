@@ -1,12 +1,18 @@
 #ifndef MT_COMMON_HPP
 #define MT_COMMON_HPP
 
+#include <cstddef>    // for size_t
 #include <filesystem> // for path
+#include <memory>     // for shared_ptr
 // #include <stdexcept>   // for invalid_argument
 #include <string>      // for string, basic_string, operator+
 #include <string_view> // for string_view
+#include <utility>     // for pair
 #include <vector>      // for vector
 
+#include "povu/graph/label_store.hpp" // for LabelStore
+#include "povu/graph/types.hpp"	      // for id_or_t
+
 namespace mto::common
 {
 inline constexpr std::string_view MODULE = "povu::io::common";
@@ -27,6 +33,70 @@ void read_lines_to_vec_str(const std::string &fp, std::vector<std::string> *v);
 void create_dir_if_not_exists(const fs::path &out_dir);
 
 void fp_to_vector(const std::string &fp, std::vector<std::string> *v);
+
+/**
+ * @brief split s based on > and < signs and using s.substr
+ *        s is in the form of >1<2 or >1>2 or <1<2 or <1>2
+ */
+std::pair<povu::types::graph::id_or_t, povu::types::graph::id_or_t>
+str_to_id_or_t(const std::string &s);
+
+/**
+ * @brief Read-only memory map of an entire file
+ *
+ * The mapping is released when the object goes out of scope. An empty file is
+ * a valid mapping with a size of zero.
+ */
+class MappedFile
+{
+	const char *data_ = nullptr;
+	std::size_t size_ = 0;
+	bool is_open_ = false;
+
+public:
+	// --------------
+	// constructor(s)
+	// --------------
+	explicit MappedFile(const std::string &fp);
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+	~MappedFile();
+
+	// ---------
+	// getter(s)
+	// ---------
+	[[nodiscard]] bool is_open() const
+	{
+		return this->is_open_;
+	}
+
+	[[nodiscard]] const char *data() const
+	{
+		return this->data_;
+	}
+
+	[[nodiscard]] std::size_t size() const
+	{
+		return this->size_;
+	}
+
+	[[nodiscard]] std::string_view view() const
+	{
+		return {this->data_, this->size_};
+	}
+
+	// the mapping outlives the sequential read, drop the read ahead hint
+	void advise_random_access() const;
+};
+
+/**
+ * @brief a label store for a graph loaded from @p file
+ *
+ * text labels stay views into @p file, which the store keeps mapped. Packed
+ * labels are copied so the mapping can go once loading is done.
+ */
+std::shared_ptr<povu::bidirected::LabelStore>
+gen_label_store(const std::shared_ptr<const MappedFile> &file, bool pack);
 }; // namespace mto::common
 
 #endif // MT_COMMON_HPP
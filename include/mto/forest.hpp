@@ -0,0 +1,59 @@
+#ifndef MT_FOREST_HPP
+#define MT_FOREST_HPP
+
+#include <cstdint>     // for uint32_t, uint64_t
+#include <string_view> // for string_view
+
+namespace mto::forest
+{
+inline constexpr std::string_view MODULE = "povu::io::forest";
+
+/*
+  On disk layout of a forest archive (.pvf)
+  -----------------------------------------
+
+  header
+  trees               binary PVSTs back to back, in the order they were added
+  index               entry_t x entry_count, sorted by component id
+  footer
+
+  Trees are appended as components are done, the index and the footer are
+  written once all of them are in. The index starts on an 8 byte boundary so
+  that it can be read in place from a memory mapping. Integers are in host
+  byte order.
+*/
+
+inline constexpr char MAGIC[8] = {'P', 'O', 'V', 'U', 'P', 'V', 'F', '\0'};
+inline constexpr std::uint32_t VERSION = 1;
+inline constexpr std::string_view EXT = ".pvf";
+// name of the archive in the output (forest) dir
+inline constexpr std::string_view FILE_NAME = "forest.pvf";
+
+struct header_t {
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t flags; // unused, for later versions
+};
+
+struct entry_t {
+	std::uint64_t component_id;
+	std::uint64_t offset; // of the tree from the start of the file
+	std::uint64_t length; // of the tree in bytes
+};
+
+struct footer_t {
+	std::uint64_t index_offset;
+	std::uint64_t entry_count;
+	char magic[8];
+};
+
+static_assert(sizeof(header_t) % 8 == 0, "header must keep 8 byte alignment");
+static_assert(sizeof(entry_t) % 8 == 0, "entries must keep 8 byte alignment");
+
+constexpr std::uint64_t align8(std::uint64_t n)
+{
+	return (n + 7) & ~static_cast<std::uint64_t>(7);
+}
+} // namespace mto::forest
+
+#endif // MT_FOREST_HPP
@@ -0,0 +1,52 @@
+#ifndef MT_IO_FROM_FOREST_HPP
+#define MT_IO_FROM_FOREST_HPP
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <string>      // for string
+#include <string_view> // for string_view
+
+#include "mto/common.hpp"      // for MappedFile
+#include "mto/forest.hpp"      // for entry_t
+#include "povu/graph/pvst.hpp" // for Tree
+
+namespace mto::from_forest
+{
+inline constexpr std::string_view MODULE = "povu::io::from_forest";
+namespace pvst = povu::pvst;
+
+/** @brief true when the file at @p fp starts with the forest archive magic */
+bool is_forest(const std::string &fp);
+
+/**
+ * Random access to the trees of a forest archive
+ *
+ * The archive is mapped once and trees are decoded straight from the
+ * mapping, so reading different trees from several threads is safe.
+ */
+class Reader
+{
+	mto::common::MappedFile file_;
+	std::string fp_;
+	const mto::forest::entry_t *entries_{nullptr};
+	std::size_t entry_count_{};
+
+public:
+	// --------------
+	// constructor(s)
+	// --------------
+	/** @throws std::runtime_error when the file is not a valid archive */
+	explicit Reader(const std::string &fp);
+
+	// ---------
+	// getter(s)
+	// ---------
+	// number of trees
+	[[nodiscard]] std::size_t size() const;
+	// trees are in increasing component id order
+	[[nodiscard]] std::uint64_t component_id(std::size_t i) const;
+	[[nodiscard]] pvst::Tree read(std::size_t i) const;
+};
+} // namespace mto::from_forest
+
+#endif // MT_IO_FROM_FOREST_HPP
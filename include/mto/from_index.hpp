@@ -0,0 +1,29 @@
+#ifndef MT_IO_FROM_INDEX_HPP
+#define MT_IO_FROM_INDEX_HPP
+
+#include <string>      // for string
+#include <string_view> // for string_view
+
+#include "povu/common/app.hpp"	     // for config
+#include "povu/graph/bidirected.hpp" // for VG
+
+namespace mto::from_index
+{
+inline constexpr std::string_view MODULE = "povu::io::from_index";
+namespace bd = povu::bidirected;
+
+/** @brief true when the file at @p fp starts with the graph index magic */
+bool is_index(const std::string &fp);
+
+/** @brief path of the GFA the index at @p fp was built from */
+std::string source_gfa(const std::string &fp);
+
+/**
+ * Load a graph from a povu graph index
+ *
+ * Remember to free the returned graph after use
+ */
+bd::VG *to_bd(const std::string &fp, const core::config &app_config);
+} // namespace mto::from_index
+
+#endif // MT_IO_FROM_INDEX_HPP
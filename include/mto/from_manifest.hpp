@@ -0,0 +1,33 @@
+#ifndef MT_IO_FROM_MANIFEST_HPP
+#define MT_IO_FROM_MANIFEST_HPP
+
+#include <cstdint>     // for uint64_t
+#include <optional>    // for optional
+#include <set>	       // for set
+#include <string>      // for string
+#include <string_view> // for string_view
+
+#include "mto/manifest.hpp" // for manifest_t, region_t
+
+namespace mto::from_manifest
+{
+inline constexpr std::string_view MODULE = "povu::io::from_manifest";
+
+/** @throws std::runtime_error when the file cannot be read or parsed */
+mto::manifest::manifest_t read_manifest(const std::string &fp);
+
+/**
+ * @brief the components whose trees cannot give a record
+ *
+ * a tree is colored only where every ref to call passes through both bounds
+ * of a flubble, so it is skipped when one of @p ref_tags does not pass
+ * through the component at all. With a region it is also skipped when the
+ * region's ref does not overlap it within the component.
+ */
+std::set<std::uint64_t>
+find_skips(const mto::manifest::manifest_t &manifest,
+	   const std::set<std::string> &ref_tags,
+	   const std::optional<mto::manifest::region_t> &region);
+} // namespace mto::from_manifest
+
+#endif // MT_IO_FROM_MANIFEST_HPP
@@ -10,7 +10,19 @@ namespace mto::from_pvst
 {
 constexpr std::string_view MODULE = "povu::io::from_pvst";
 
+/**
+ * @brief read a .pvst file in either the text or the binary format
+ */
 pvst::Tree read_pvst(const std::string &fp);
+
+/**
+ * @brief decode a PVST in the binary format
+ *
+ * @param bytes the encoded tree, such as a mapped file or a slice of one
+ * @param fp where the bytes come from, for error messages
+ * @throws std::runtime_error when the bytes are not a valid binary PVST
+ */
+pvst::Tree from_bin(std::string_view bytes, const std::string &fp);
 } // namespace mto::from_pvst
 
 // add namespace alias for povu::compat
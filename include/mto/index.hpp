@@ -0,0 +1,109 @@
+#ifndef MT_INDEX_HPP
+#define MT_INDEX_HPP
+
+#include <cstdint>     // for uint32_t, uint64_t
+#include <string_view> // for string_view
+#include <type_traits> // for remove_pointer_t
+
+#include <liteseq/refs.h> // for ref_walk
+
+namespace mto::index
+{
+inline constexpr std::string_view MODULE = "povu::io::index";
+
+/*
+  On disk layout of a povu graph index (.pvg)
+  -------------------------------------------
+
+  header
+  vertex ids          u32 x vtx_count, in vertex index order
+  edges               u32 x 4 x edge_count (v1_idx, v1_end, v2_idx, v2_end)
+  adjacency offsets   u64 x (2 x vtx_count + 1), see below
+  adjacency           u32 x adj_count, edge indexes
+  flat id map         u32 x flat_count, vertex index of id id_base + i
+  tips                u32 x 2 x tip_count (v_end, v_id)
+  label offsets       u64 x (vtx_count + 1), only when HAS_LABELS is set
+  label bytes         label_bytes chars, only when HAS_LABELS is set
+  source gfa path     src_len chars
+
+  only when HAS_REFS is set
+  refs                ref_rec_t x ref_count
+  ref names           ref_name_bytes chars, the tags and sample names
+  walk vertex ids     walk_v_id_t x step_count, the walks one after another
+  walk strands        walk_strand_t x step_count
+  walk loci           walk_locus_t x step_count
+  step offsets        u64 x (vtx_count + 1)
+  step ref ids        u32 x step_count
+  step indexes        u32 x step_count
+
+  The edges of vertex v_idx on its left are at [adjacency offsets[2 x v_idx],
+  adjacency offsets[2 x v_idx + 1]) of the adjacency and those on its right
+  follow, the CSR bd::VG::freeze packs. The edges and the adjacency are read
+  in place, so are the vertex ids and the flat id map which, with id_map and
+  id_base, are those of bd::VertexIdMap.
+
+  The walks and the vertex to step index are those of bd::VG, see
+  gen_vertex_step_index. Every section starts on an 8 byte boundary so that
+  the arrays can be read in place from a memory mapping. Integers are in host
+  byte order.
+*/
+
+inline constexpr char MAGIC[8] = {'P', 'O', 'V', 'U', 'P', 'V', 'G', '\0'};
+inline constexpr std::uint32_t VERSION = 3;
+inline constexpr std::string_view EXT = ".pvg";
+
+// header flags
+inline constexpr std::uint32_t HAS_LABELS = 1u << 0;
+inline constexpr std::uint32_t HAS_REFS = 1u << 1;
+
+// the walks are read in place, so they are stored as liteseq lays them out
+using walk_v_id_t = std::remove_pointer_t<decltype(liteseq::ref_walk::v_ids)>;
+using walk_strand_t =
+	std::remove_pointer_t<decltype(liteseq::ref_walk::strands)>;
+using walk_locus_t = std::remove_pointer_t<decltype(liteseq::ref_walk::loci)>;
+
+struct header_t {
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t flags;
+	std::uint64_t vtx_count;
+	std::uint64_t edge_count;
+	std::uint64_t tip_count;
+	std::uint64_t label_bytes;
+	std::uint64_t src_len;
+	std::uint64_t ref_count;
+	std::uint64_t ref_name_bytes;
+	std::uint64_t step_count;
+	std::uint64_t adj_count;
+	std::uint64_t flat_count;
+	std::uint32_t id_map; // bd::id_map_e
+	std::uint32_t id_base;
+	// sizes of walk_v_id_t, walk_strand_t and walk_locus_t when written
+	std::uint8_t walk_widths[8];
+};
+
+struct ref_rec_t {
+	std::uint64_t first_step; // of the walk in the walk sections
+	std::uint64_t step_count;
+	std::uint64_t tag_off; // in the ref names
+	std::uint64_t sample_off;
+	std::uint32_t tag_len;
+	std::uint32_t sample_len;
+	std::uint32_t hap_id;
+	std::uint32_t id_type; // liteseq::ref_id_type
+	std::uint64_t length;
+};
+
+static_assert(sizeof(header_t) % 8 == 0, "header must keep 8 byte alignment");
+static_assert(sizeof(ref_rec_t) % 8 == 0, "refs must keep 8 byte alignment");
+
+inline constexpr std::uint8_t WALK_WIDTHS[8] = {
+	sizeof(walk_v_id_t), sizeof(walk_strand_t), sizeof(walk_locus_t)};
+
+constexpr std::uint64_t align8(std::uint64_t n)
+{
+	return (n + 7) & ~static_cast<std::uint64_t>(7);
+}
+} // namespace mto::index
+
+#endif // MT_INDEX_HPP
@@ -0,0 +1,54 @@
+#ifndef MT_MANIFEST_HPP
+#define MT_MANIFEST_HPP
+
+#include <cstdint>     // for uint64_t
+#include <map>	       // for map
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+namespace mto::manifest
+{
+inline constexpr std::string_view MODULE = "povu::io::manifest";
+
+/*
+  The forest manifest (manifest.tsv)
+  ----------------------------------
+
+  A tab separated file next to the trees of the forest, one line per tree and
+  reference path that passes through the component of the tree
+
+  #component_id	ref	start_locus	end_locus
+  1	HG002#1#chr1	0	248387346
+
+  [start_locus, end_locus) spans the steps of the ref on the vertices of the
+  component, from the start of the first one to the end of the last one. A
+  step ends where the next one of the ref starts, or at the end of the ref
+  for its last step, so vertex labels are not needed. A tree that no ref
+  passes through is listed with its component id alone. Lines are sorted by
+  component id, then by ref.
+*/
+
+// name of the manifest in the output (forest) dir
+inline constexpr std::string_view FILE_NAME = "manifest.tsv";
+inline constexpr std::string_view HEADER =
+	"#component_id\tref\tstart_locus\tend_locus";
+
+struct ref_range_t {
+	std::string ref; // the tag (name) of the ref
+	std::uint64_t start_locus;
+	std::uint64_t end_locus; // exclusive
+};
+
+// [start, end) on the ref
+struct region_t {
+	std::string ref;
+	std::uint64_t start;
+	std::uint64_t end;
+};
+
+// the ref ranges of each tree by component id
+using manifest_t = std::map<std::uint64_t, std::vector<ref_range_t>>;
+} // namespace mto::manifest
+
+#endif // MT_MANIFEST_HPP
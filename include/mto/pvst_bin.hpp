@@ -0,0 +1,97 @@
+#ifndef MT_PVST_BIN_HPP
+#define MT_PVST_BIN_HPP
+
+#include <cstdint>     // for uint8_t, uint32_t, uint64_t, int64_t
+#include <string>      // for string
+#include <string_view> // for string_view
+
+namespace mto::pvst_bin
+{
+inline constexpr std::string_view MODULE = "povu::io::pvst_bin";
+
+/*
+  On disk layout of a binary PVST (.pvst)
+  ---------------------------------------
+
+  header
+  vertices            one record per vertex, in vertex index order
+
+  and a record is
+
+  tag                 u8, the vertex family in the low 4 bits, flags above
+  start id            varint, only when HAS_ROUTE is set
+  end id              varint, only when HAS_ROUTE is set
+  child count         varint
+  children            zigzag varint x child count, each child as the
+                      difference from the one before it, the first from the
+                      vertex itself
+
+  Varints are LEB128, 7 bits per byte with the low bits first. The text
+  format starts with a header line so the first bytes tell the two apart.
+  Integers in the header are in host byte order.
+*/
+
+inline constexpr char MAGIC[8] = {'P', 'O', 'V', 'U', 'P', 'V', 'S', 'T'};
+inline constexpr std::uint32_t VERSION = 2;
+
+struct header_t {
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t flags; // unused, for later versions
+	std::uint64_t vtx_count;
+	std::uint64_t root_idx;
+	std::uint64_t child_count; // edges in the tree
+	std::uint64_t body_bytes;  // bytes of vertex records after the header
+};
+
+// tag bits, the family is the value of pvst::vertex_family_e
+inline constexpr std::uint8_t FAM_MASK = 0x0F;
+inline constexpr std::uint8_t START_REV = 1u << 4; // start is reverse
+inline constexpr std::uint8_t END_REV = 1u << 5;   // end is reverse
+inline constexpr std::uint8_t ROUTE_E2S = 1u << 6; // route is e2s
+inline constexpr std::uint8_t HAS_ROUTE = 1u << 7;
+
+// the most bytes a 64 bit varint takes
+inline constexpr std::uint32_t MAX_VARINT_BYTES = 10;
+
+inline void put_varint(std::string &out, std::uint64_t x)
+{
+	while (x >= 0x80) {
+		out.push_back(static_cast<char>((x & 0x7F) | 0x80));
+		x >>= 7;
+	}
+	out.push_back(static_cast<char>(x));
+}
+
+/**
+ * @brief decode a varint at @p p and move @p p past it
+ * @return false when the varint runs past @p end or is too long
+ */
+inline bool get_varint(const char *&p, const char *end, std::uint64_t &x)
+{
+	x = 0;
+	for (std::uint32_t i{}; i < MAX_VARINT_BYTES && p < end; ++i) {
+		auto b = static_cast<std::uint8_t>(*p++);
+		x |= static_cast<std::uint64_t>(b & 0x7F) << (7 * i);
+		if (!(b & 0x80))
+			return true;
+	}
+
+	return false;
+}
+
+// map signed to unsigned so that small differences of either sign are short
+constexpr std::uint64_t zigzag(std::int64_t x)
+{
+	return (static_cast<std::uint64_t>(x) << 1) ^
+	       static_cast<std::uint64_t>(x >> 63);
+}
+
+constexpr std::int64_t unzigzag(std::uint64_t x)
+{
+	return static_cast<std::int64_t>(x >> 1) ^
+	       -static_cast<std::int64_t>(x & 1);
+}
+} // namespace mto::pvst_bin
+
+#endif // MT_PVST_BIN_HPP
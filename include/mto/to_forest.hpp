@@ -0,0 +1,57 @@
+#ifndef MT_IO_TO_FOREST_HPP
+#define MT_IO_TO_FOREST_HPP
+
+#include <cstdint>     // for uint64_t
+#include <filesystem>  // for path
+#include <mutex>       // for mutex
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+#include "mto/forest.hpp"      // for entry_t
+#include "povu/graph/pvst.hpp" // for Tree
+
+namespace mto::to_forest
+{
+inline constexpr std::string_view MODULE = "povu::io::to_forest";
+namespace pvst = povu::pvst;
+
+/**
+ * Writes the trees of all the components into one forest archive
+ *
+ * Trees can be added from several threads at once. Each is encoded by the
+ * calling thread and only the reservation of its place in the file is done
+ * under a lock, the bytes are then written at that offset without it.
+ */
+class Writer
+{
+	int fd_{-1};
+	std::string fp_;
+	std::mutex mtx_;
+	std::uint64_t end_{}; // offset of the next tree
+	std::vector<mto::forest::entry_t> entries_;
+	bool finished_{false};
+
+public:
+	// --------------
+	// constructor(s)
+	// --------------
+	/** @throws std::runtime_error when the file cannot be created */
+	explicit Writer(const std::filesystem::path &fp);
+	Writer(const Writer &) = delete;
+	Writer &operator=(const Writer &) = delete;
+	Writer(Writer &&) = delete;
+	Writer &operator=(Writer &&) = delete;
+	~Writer();
+
+	// ---------
+	// setter(s)
+	// ---------
+	/** @brief append the tree of a component, safe to call concurrently */
+	void add(std::uint64_t component_id, const pvst::Tree &bt);
+	/** @brief write the index, no tree can be added afterwards */
+	void finish();
+};
+} // namespace mto::to_forest
+
+#endif // MT_IO_TO_FOREST_HPP
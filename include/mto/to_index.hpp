@@ -0,0 +1,27 @@
+#ifndef MT_IO_TO_INDEX_HPP
+#define MT_IO_TO_INDEX_HPP
+
+#include <filesystem>  // for path
+#include <string>      // for string
+#include <string_view> // for string_view
+
+#include "povu/graph/bidirected.hpp" // for VG
+
+namespace mto::to_index
+{
+inline constexpr std::string_view MODULE = "povu::io::to_index";
+namespace bd = povu::bidirected;
+
+/**
+ * Serialize a graph to the povu graph index format
+ *
+ * @param [in] g the graph, labels are written when any vertex has one and
+ * the refs with the vertex to step index when they were loaded
+ * @param [in] src_gfa path of the GFA the graph was read from
+ * @param [in] fp output file path
+ */
+void write_index(const bd::VG &g, const std::string &src_gfa,
+		 const std::filesystem::path &fp);
+} // namespace mto::to_index
+
+#endif // MT_IO_TO_INDEX_HPP
@@ -0,0 +1,59 @@
+#ifndef MT_IO_TO_MANIFEST_HPP
+#define MT_IO_TO_MANIFEST_HPP
+
+#include <cstdint>     // for uint64_t
+#include <filesystem>  // for path
+#include <mutex>       // for mutex
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <utility>     // for pair
+#include <vector>      // for vector
+
+#include "mto/manifest.hpp"	     // for ref_range_t
+#include "povu/common/compat.hpp"    // for pv_cmp
+#include "povu/common/core.hpp"	     // for pt
+#include "povu/graph/bidirected.hpp" // for VG
+
+namespace mto::to_manifest
+{
+inline constexpr std::string_view MODULE = "povu::io::to_manifest";
+
+/**
+ * @brief the range of loci of each ref on the vertices @p v_idxs of @p g,
+ * sorted by ref
+ *
+ * @p g must have its refs and vertex step index
+ */
+std::vector<mto::manifest::ref_range_t>
+ref_ranges(const bd::VG &g, pv_cmp::span<const pt::idx_t> v_idxs);
+
+/**
+ * Collects the ref ranges of the trees of a forest and writes them out as
+ * the forest manifest once all of them are in
+ */
+class Writer
+{
+	std::string fp_;
+	std::mutex mtx_;
+	std::vector<std::pair<std::uint64_t,
+			      std::vector<mto::manifest::ref_range_t>>>
+		trees_;
+
+public:
+	// --------------
+	// constructor(s)
+	// --------------
+	explicit Writer(const std::filesystem::path &fp);
+
+	// ---------
+	// setter(s)
+	// ---------
+	/** @brief add the ranges of a tree, safe to call concurrently */
+	void add(std::uint64_t component_id,
+		 std::vector<mto::manifest::ref_range_t> ranges);
+	/** @throws std::runtime_error when the file cannot be written */
+	void finish();
+};
+} // namespace mto::to_manifest
+
+#endif // MT_IO_TO_MANIFEST_HPP
@@ -14,6 +14,11 @@ namespace pvst = povu::pvst;
 
 void write_pvst(const pvst::Tree &bt, const std::string &base_name,
 		const core::config &app_config);
+
+/**
+ * @brief encode @p bt in the binary PVST format, the bytes of a whole file
+ */
+std::string to_bin(const pvst::Tree &bt);
 } // namespace mto::to_pvst
 
 // add namespace alias for povu::compat
@@ -2,8 +2,10 @@
 #define PV_CONCEALED_HPP
 
 #include <string_view> // for string_view
+#include <vector>      // for vector
 
 #include "povu/common/constants.hpp"	// for constants
+#include "povu/common/core.hpp"		// for pt, idx_t
 #include "povu/graph/pvst.hpp"		// for Tree
 #include "povu/graph/spanning_tree.hpp" // for Tree
 #include "povu/graph/tree_utils.hpp"	// for tree_meta
@@ -21,6 +23,35 @@ namespace pvst = povu::pvst;
 namespace pc = povu::constants;
 namespace ptu = povu::tree_utils;
 
+// slubbles in flubble or flubble slubbles
+struct fl_sls {
+	pt::idx_t fl_v_idx;
+	std::vector<pvst::Concealed> ii_adj;
+	std::vector<pvst::Concealed> ji_adj;
+	pt::idx_t m;
+	pt::idx_t n;
+
+	pt::idx_t size() const
+	{
+		return ii_adj.size() + ji_adj.size();
+	}
+};
+
+/**
+ * @brief set m and n of a flubble and find the concealed bubbles in it
+ *
+ * does not change the PVST beyond @p ft_v, the slubbles are added by
+ * update_pvst::add_concealed
+ */
+fl_sls find_in_flubble(const pst::Tree &st, const ptu::tree_meta &tm,
+		       pt::idx_t ft_v_idx, pvst::Flubble &ft_v);
+
+namespace update_pvst
+{
+void add_concealed(const pst::Tree &st, pvst::Tree &vst,
+		   const ptu::tree_meta &tm, const fl_sls &slubbles);
+} // namespace update_pvst
+
 void find_concealed(const pst::Tree &st, pvst::Tree &ft,
 		    const ptu::tree_meta &tm);
 } // namespace povu::concealed
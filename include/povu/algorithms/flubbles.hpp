@@ -9,6 +9,7 @@
 #include "povu/common/app.hpp"		// for config
 #include "povu/common/constants.hpp"	// for INVALID_IDX
 #include "povu/common/core.hpp"		// for pt, idx_t, id_t
+#include "povu/common/thread.hpp"	// for thread_pool
 #include "povu/graph/pvst.hpp"		// for Tree
 #include "povu/graph/spanning_tree.hpp" // for Tree
 #include "povu/graph/tree_utils.hpp"	// for tree_utils
@@ -23,6 +24,7 @@ namespace ptu = povu::tree_utils;
 namespace pvst = povu::pvst;
 namespace pgt = povu::types::graph;
 namespace pst = povu::spanning_tree;
+namespace pth = povu::thread;
 
 // a hairpin boundary
 struct boundary {
@@ -39,12 +41,16 @@ struct oic_t {
 	pt::id_t id;
 	pt::id_t st_idx;
 	pt::idx_t cls;
+	// entries of the same class that follow this one in the uncompacted
+	// graph, see bd::VG::compact_chains
+	pt::idx_t folded{};
 };
 
 struct eq_class_stack_t {
 	std::vector<oic_t> s; // stack of equivalence classes
 	std::vector<pt::idx_t>
 		next_seen; // next seen index for each equivalence class
+	pt::idx_t cls_count{}; // one more than the highest class in s
 
 	// constructor
 	eq_class_stack_t(pt::idx_t exp_size)
@@ -58,8 +64,14 @@ struct eq_class_stack_t {
 /**
  * @brief Generate flubble tree from spanning tree
  *
+ * The equivalence classes of a large tree are found across the workers of
+ * @p pool, the blocks of its graph below a cut vertex each on one thread. The
+ * tree ends up with the same classes, backedges and hi values as when it is
+ * done on the calling thread, which also takes part and may itself be a
+ * worker of a busy pool.
  */
-pvst::Tree find_flubbles(pst::Tree &t, const core::config &app_config);
+pvst::Tree find_flubbles(pst::Tree &t, const core::config &app_config,
+			 pth::thread_pool *pool = nullptr);
 
 /**
  * @brief Sidecar path used to carry decomposition-only flubble state into the
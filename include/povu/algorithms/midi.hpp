@@ -1,7 +1,9 @@
 #ifndef PV_MISC_HPP
 #define PV_MISC_HPP
 
+#include <map>	       // for map
 #include <string_view> // for string_view
+#include <vector>      // for vector
 
 #include "povu/common/constants.hpp"	// for constants
 #include "povu/graph/pvst.hpp"		// for Tree
@@ -20,6 +22,16 @@ namespace pvst = povu::pvst;
 namespace pc = povu::constants;
 namespace ptu = povu::tree_utils;
 
+// the midi bubbles of a flubble, does not change the PVST
+std::vector<pvst::MidiBubble> find_in_flubble(const pst::Tree &st,
+					      const pvst::Tree &pvst,
+					      pt::idx_t ft_v_idx);
+
+// add midi bubbles to the PVST, they are added in key order
+void add_midi(const ptu::tree_meta &tm,
+	      std::map<pt::idx_t, std::vector<pvst::MidiBubble>> &midis,
+	      pvst::Tree &pvst);
+
 void find_midi(const pst::Tree &st, pvst::Tree &pvst, const ptu::tree_meta &tm);
 } // namespace povu::midi
 
@@ -19,6 +19,10 @@ namespace pvst = povu::pvst;
 namespace pgt = povu::types::graph;
 namespace pst = povu::spanning_tree;
 
+// a leaf flubble with parallel edges in its trunk or in its one branch
+bool is_parallel(const pst::Tree &st, const ptu::tree_meta &tm,
+		 const pvst::Flubble &ft_v);
+
 void find_parallel(const pst::Tree &st, pvst::Tree &ft,
 		   const ptu::tree_meta &tm);
 
@@ -2,6 +2,7 @@
 #define PV_SMOTHERED_HPP
 
 #include <string_view> // for string_view
+#include <vector>      // for vector
 
 #include "povu/common/constants.hpp"	// for constants
 #include "povu/graph/pvst.hpp"		// for Tree
@@ -20,6 +21,34 @@ namespace pvst = povu::pvst;
 namespace pc = povu::constants;
 namespace ptu = povu::tree_utils;
 
+struct fl_sls {
+	pt::idx_t cn_v_idx;
+	std::vector<pvst::Smothered> g_adj;
+	std::vector<pvst::Smothered> s_adj;
+
+	pt::idx_t size() const
+	{
+		return g_adj.size() + s_adj.size();
+	}
+
+	// Constructor for fl_sls
+	fl_sls(pt::idx_t cn_v_idx_)
+	    : cn_v_idx(cn_v_idx_), g_adj(std::vector<pvst::Smothered>{}),
+	      s_adj(std::vector<pvst::Smothered>{})
+	{}
+};
+
+/**
+ * @brief the smothered bubbles of a concealed vertex
+ *
+ * empty if @p ft_v_idx is not a concealed vertex, does not change the PVST
+ */
+fl_sls find_in_concealed(const pst::Tree &st, const pvst::Tree &pvst,
+			 const ptu::tree_meta &tm, pt::idx_t ft_v_idx);
+
+void add_smothered(const pst::Tree &st, pvst::Tree &pvst,
+		   const std::vector<fl_sls> &al_smo);
+
 void find_smothered(const pst::Tree &st, pvst::Tree &ft,
 		    const ptu::tree_meta &tm);
 } // namespace povu::smothered
@@ -0,0 +1,44 @@
+#ifndef PV_SUBFLUBBLES_HPP
+#define PV_SUBFLUBBLES_HPP
+
+#include <string_view> // for string_view
+
+#include "povu/common/core.hpp"		// for pt, u32
+#include "povu/common/thread.hpp"	// for thread_pool
+#include "povu/graph/pvst.hpp"		// for Tree
+#include "povu/graph/spanning_tree.hpp" // for Tree
+#include "povu/graph/tree_utils.hpp"	// for tree_meta
+
+namespace povu::subflubbles
+{
+inline constexpr std::string_view MODULE = "povu::subflubbles";
+
+namespace pst = povu::spanning_tree;
+namespace pvst = povu::pvst;
+namespace ptu = povu::tree_utils;
+namespace pth = povu::thread;
+
+/**
+ * @brief find the tiny, parallel, concealed, midi and smothered bubbles
+ *
+ * The same as calling find_tiny, find_parallel, find_concealed, find_midi and
+ * find_smothered in that order, the PVST ends up with the same vertices in the
+ * same order, but the flubbles are visited once: the tiny, parallel and
+ * concealed checks of a flubble are made together, midi bubbles are only
+ * looked for in flubbles with at least two concealed children once all the
+ * concealed bubbles are in and smothered bubbles only in the concealed
+ * vertices that were just added.
+ *
+ * Finding the bubbles of a flubble or concealed vertex only reads the PVST so
+ * in a large tree that is split across the workers of @p pool, the results
+ * are kept per vertex and added to the PVST in vertex order afterwards.
+ *
+ * The calling thread runs the split work along with any free workers of
+ * @p pool, so it may itself be a worker of a busy pool.
+ */
+void find_subflubbles(const pst::Tree &st, pvst::Tree &ft,
+		      const ptu::tree_meta &tm,
+		      pth::thread_pool *pool = nullptr);
+} // namespace povu::subflubbles
+
+#endif // PV_SUBFLUBBLES_HPP
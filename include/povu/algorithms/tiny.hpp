@@ -19,6 +19,10 @@ namespace pst = povu::spanning_tree;
 namespace pvst = povu::pvst;
 namespace pgt = povu::types::graph;
 
+// a leaf flubble whose trunk or branches hold a single vertex
+bool is_tiny(const pst::Tree &st, const ptu::tree_meta &tm,
+	     const pvst::Flubble &ft_v);
+
 void find_tiny(const pst::Tree &st, pvst::Tree &pvst, const ptu::tree_meta &tm);
 
 } // namespace povu::tiny
@@ -23,6 +23,7 @@ enum class task_e : uint8_t {
 	call,	   // call variants
 	decompose, // deconstruct a graph
 	gfa2vcf,   // convert GFA directly to VCF
+	index,	   // write a binary graph index
 	info,	   // print graph information
 	prune,	   // leave only the graph structure
 	vcf,	   // analyse a VCF against a graph
@@ -97,6 +98,8 @@ inline const char *to_str(task_e t)
 		return "decompose";
 	case task_e::gfa2vcf:
 		return "gfa2vcf";
+	case task_e::index:
+		return "index";
 	case task_e::info:
 		return "info";
 	case task_e::prune:
@@ -133,13 +136,20 @@ private:
 	/* graph decomposition */
 	bool inc_hairpins_{false};     // whether to include hairpins
 	bool find_subflubbles_{false}; // whether to find subflubbles
+	bool compact_chains_{false};   // whether to collapse unbranched chains
+	bool binary_pvst_{false};      // whether to write binary .pvst files
+	bool forest_archive_{false};   // whether to write one forest archive
+	bool forest_manifest_{false};  // whether to write the forest manifest
 	// directory containing the flb files (the forest)
 	std::filesystem::path forest_dir{"."};
 
 	/* variation graph config */
-	std::string input_gfa{};     // path to input gfa
-	bool inc_vtx_labels_{false}; // whether to include vertex labels
-	bool inc_refs_{false};	     // whether to include references/paths
+	std::string input_gfa{};      // path to input gfa
+	bool inc_vtx_labels_{false};  // whether to include vertex labels
+	bool inc_refs_{false};	      // whether to include references/paths
+	bool pack_vtx_labels_{false}; // whether to 2-bit pack vertex labels
+	// output path when writing a graph index
+	std::filesystem::path index_fp_{};
 
 	std::size_t chunk_size_{100};
 	std::size_t queue_len_{4};
@@ -203,6 +213,30 @@ public:
 		return this->find_subflubbles_;
 	}
 
+	[[nodiscard]]
+	bool compact_chains() const
+	{
+		return this->compact_chains_;
+	}
+
+	[[nodiscard]]
+	bool binary_pvst() const
+	{
+		return this->binary_pvst_;
+	}
+
+	[[nodiscard]]
+	bool forest_archive() const
+	{
+		return this->forest_archive_;
+	}
+
+	[[nodiscard]]
+	bool forest_manifest() const
+	{
+		return this->forest_manifest_;
+	}
+
 	[[nodiscard]]
 	std::string get_input_gfa() const
 	{
@@ -239,6 +273,11 @@ public:
 		return this->inc_refs_;
 	}
 
+	bool pack_vtx_labels() const
+	{
+		return this->pack_vtx_labels_;
+	}
+
 	[[nodiscard]]
 	std::size_t get_chunk_size() const
 	{
@@ -306,6 +345,12 @@ public:
 		return this->structure_export_path_.has_value();
 	}
 
+	[[nodiscard]]
+	const std::filesystem::path &get_index_fp() const
+	{
+		return this->index_fp_;
+	}
+
 	[[nodiscard]]
 	task_e get_task() const
 	{
@@ -351,6 +396,26 @@ public:
 		this->find_subflubbles_ = b;
 	}
 
+	void set_compact_chains(bool b)
+	{
+		this->compact_chains_ = b;
+	}
+
+	void set_binary_pvst(bool b)
+	{
+		this->binary_pvst_ = b;
+	}
+
+	void set_forest_archive(bool b)
+	{
+		this->forest_archive_ = b;
+	}
+
+	void set_forest_manifest(bool b)
+	{
+		this->forest_manifest_ = b;
+	}
+
 	void set_chunk_size(std::size_t s)
 	{
 		this->chunk_size_ = s;
@@ -376,6 +441,11 @@ public:
 		this->inc_refs_ = b;
 	}
 
+	void set_pack_vtx_labels(bool b)
+	{
+		this->pack_vtx_labels_ = b;
+	}
+
 	void set_ref_input_format(input_format_e f)
 	{
 		this->ref_input_format = f;
@@ -421,6 +491,11 @@ public:
 		this->input_gfa = s;
 	}
 
+	void set_index_fp(const std::filesystem::path &p)
+	{
+		this->index_fp_ = p;
+	}
+
 	void set_forest_dir(const std::string &s)
 	{
 		this->forest_dir = s;
@@ -470,6 +545,10 @@ public:
 			  << "\n";
 		std::cerr << spc << "input gfa: " << this->input_gfa << "\n";
 		std::cerr << spc << "output dir: " << this->output_dir << "\n";
+		if (this->inc_vtx_labels_)
+			std::cerr << spc << "pack labels: "
+				  << (this->pack_vtx_labels_ ? "yes" : "no")
+				  << "\n";
 
 		if (this->get_task() == task_e::call) {
 			std::cerr << spc << "forest dir: " << this->forest_dir
@@ -502,6 +581,22 @@ public:
 			std::cerr << spc << "find subflubbles: "
 				  << (this->find_subflubbles() ? "yes" : "no")
 				  << "\n";
+			std::cerr << spc << "compact chains: "
+				  << (this->compact_chains() ? "yes" : "no")
+				  << "\n";
+			std::cerr << spc << "pvst format: "
+				  << (this->binary_pvst() ? "binary" : "text")
+				  << "\n";
+			std::cerr << spc << "forest archive: "
+				  << (this->forest_archive() ? "yes" : "no")
+				  << "\n";
+			std::cerr << spc << "forest manifest: "
+				  << (this->forest_manifest() ? "yes" : "no")
+				  << "\n";
+		}
+		else if (this->get_task() == task_e::index) {
+			std::cerr << spc << "index file: " << this->index_fp_
+				  << "\n";
 		}
 		else if (this->get_task() == task_e::info) {
 			//
@@ -0,0 +1,134 @@
+#ifndef POVU_ARENA_HPP
+#define POVU_ARENA_HPP
+
+#include <cstddef>     // for size_t, byte, max_align_t
+#include <memory>      // for unique_ptr, allocator, align
+#include <new>	       // for bad_array_new_length
+#include <type_traits> // for true_type
+#include <vector>      // for vector
+
+namespace povu::arena
+{
+
+/**
+ * A monotonic arena
+ *
+ * Memory is handed out from large blocks by bumping a pointer and is only
+ * given back all at once, by release() or when the arena is destroyed.
+ * Freeing a single allocation does nothing. Not thread safe, an arena is meant
+ * to be used by the one thread that works on a component.
+ */
+class Arena
+{
+	static constexpr std::size_t MIN_BLOCK_SIZE = std::size_t{1} << 12;
+	static constexpr std::size_t DEFAULT_BLOCK_SIZE = std::size_t{1} << 16;
+
+	std::vector<std::unique_ptr<std::byte[]>> blocks_;
+	std::byte *cur_{nullptr};
+	std::size_t left_{}; // bytes left in the current block
+	std::size_t next_block_size_;
+	std::size_t used_{}; // bytes handed out
+
+	void *grow(std::size_t n, std::size_t align);
+
+public:
+	// --------------
+	// constructor(s)
+	// --------------
+	// @param initial_size the size of the first block, later ones double
+	explicit Arena(std::size_t initial_size = DEFAULT_BLOCK_SIZE);
+	Arena(const Arena &) = delete;
+	Arena &operator=(const Arena &) = delete;
+
+	// ---------
+	// getter(s)
+	// ---------
+	[[nodiscard]] std::size_t used() const;
+	[[nodiscard]] std::size_t block_count() const;
+
+	// ---------
+	// setter(s)
+	// ---------
+	void *allocate(std::size_t n, std::size_t align)
+	{
+		void *p = this->cur_;
+		if (std::align(align, n, p, this->left_) == nullptr)
+			return this->grow(n, align);
+
+		this->cur_ = static_cast<std::byte *>(p) + n;
+		this->left_ -= n;
+		this->used_ += n;
+		return p;
+	}
+
+	// free every block at once, whatever was allocated from the arena must
+	// not be used afterwards
+	void release();
+};
+
+/**
+ * An allocator over an Arena
+ *
+ * Without an arena it falls back to the heap so a container can be used the
+ * same way whether or not it is given one.
+ */
+template <typename T> class allocator
+{
+	Arena *arena_;
+
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	allocator(Arena *arena = nullptr) noexcept : arena_(arena)
+	{}
+
+	template <typename U>
+	allocator(const allocator<U> &other) noexcept : arena_(other.arena())
+	{}
+
+	[[nodiscard]] Arena *arena() const noexcept
+	{
+		return this->arena_;
+	}
+
+	T *allocate(std::size_t n)
+	{
+		if (this->arena_ == nullptr)
+			return std::allocator<T>{}.allocate(n);
+
+		if (n > static_cast<std::size_t>(-1) / sizeof(T))
+			throw std::bad_array_new_length();
+
+		return static_cast<T *>(
+			this->arena_->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T *p, std::size_t n) noexcept
+	{
+		// arena memory is only freed with the arena
+		if (this->arena_ == nullptr)
+			std::allocator<T>{}.deallocate(p, n);
+	}
+
+	template <typename U>
+	friend bool operator==(const allocator &a,
+			       const allocator<U> &b) noexcept
+	{
+		return a.arena() == b.arena();
+	}
+
+	template <typename U>
+	friend bool operator!=(const allocator &a,
+			       const allocator<U> &b) noexcept
+	{
+		return !(a == b);
+	}
+};
+
+template <typename T> using vector = std::vector<T, allocator<T>>;
+
+} // namespace povu::arena
+
+#endif // POVU_ARENA_HPP
@@ -19,6 +19,12 @@
 #include <fmt/format.h>
 #endif
 
+#if __cplusplus >= 202002L
+#include <span>
+#else
+#include <cstddef>
+#endif
+
 namespace povu::compat
 {
 #if HAS_STD_FORMAT
@@ -53,6 +59,65 @@ bool contains(const Container &c, const Key &key)
 	return c.find(key) != c.end();
 }
 
+// span
+// span is C++20
+// a non-owning view over a contiguous run of elements
+#if __cplusplus >= 202002L
+using std::span;
+#else
+template <typename T> class span
+{
+	T *data_ = nullptr;
+	std::size_t size_ = 0;
+
+public:
+	constexpr span() noexcept = default;
+	constexpr span(T *data, std::size_t size) noexcept
+	    : data_(data), size_(size)
+	{}
+
+	constexpr T *data() const noexcept
+	{
+		return data_;
+	}
+
+	constexpr std::size_t size() const noexcept
+	{
+		return size_;
+	}
+
+	constexpr bool empty() const noexcept
+	{
+		return size_ == 0;
+	}
+
+	constexpr T *begin() const noexcept
+	{
+		return data_;
+	}
+
+	constexpr T *end() const noexcept
+	{
+		return data_ + size_;
+	}
+
+	constexpr T &front() const
+	{
+		return data_[0];
+	}
+
+	constexpr T &back() const
+	{
+		return data_[size_ - 1];
+	}
+
+	constexpr T &operator[](std::size_t i) const
+	{
+		return data_[i];
+	}
+};
+#endif
+
 } // namespace povu::compat
 
 // add namespace alias for povu::compat
@@ -1,12 +1,14 @@
 #ifndef POVU_THREAD_HPP
 #define POVU_THREAD_HPP
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstddef>
 #include <exception>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -161,6 +163,81 @@ auto thread_pool::submit(F &&f) -> std::future<std::invoke_result_t<F &>>
 	return fut;
 }
 
+// tasks per thread, more than one so that uneven chunks even out
+inline constexpr pt::idx_t TASKS_PER_THREAD = 4;
+
+// the chunks of a for_chunks call, kept alive by the helpers that outlive it
+struct chunks_t {
+	std::atomic<pt::idx_t> next{0};
+	pt::idx_t done{0}; // guarded by mx
+	std::exception_ptr error;
+	std::mutex mx;
+	std::condition_variable cv;
+};
+
+/**
+ * call f(first, last) on chunks of [0, n), in the pool if there is one
+ *
+ * The calling thread and helpers queued on the pool claim the chunks from a
+ * counter. The caller runs chunks until there are none left and then waits
+ * only for those a helper is already running, never for a helper to start,
+ * so the split work does not wait behind the tasks queued before it. A helper
+ * that starts once all the chunks are claimed returns at once.
+ */
+template <typename F> void for_chunks(thread_pool *pool, pt::idx_t n, F f)
+{
+	if (pool == nullptr) {
+		f(0, n);
+		return;
+	}
+
+	const pt::idx_t task_count = pool->size() * TASKS_PER_THREAD;
+	const pt::idx_t chunk = std::max<pt::idx_t>(
+		1, (n + task_count - 1) / task_count);
+	const pt::idx_t chunk_count = (n + chunk - 1) / chunk;
+
+	auto s = std::make_shared<chunks_t>();
+
+	// f is only used after a chunk is claimed, the caller is still waiting
+	auto claim = [s, &f, n, chunk, chunk_count]()
+	{
+		for (;;) {
+			pt::idx_t i = s->next.fetch_add(1);
+			if (i >= chunk_count)
+				return;
+
+			pt::idx_t b = i * chunk;
+			pt::idx_t e = std::min<pt::idx_t>(n, b + chunk);
+
+			std::exception_ptr error;
+			try {
+				f(b, e);
+			}
+			catch (...) {
+				error = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lk(s->mx);
+			if (error && !s->error)
+				s->error = error;
+			if (++s->done == chunk_count)
+				s->cv.notify_all();
+		}
+	};
+
+	const std::size_t helper_count =
+		std::min<std::size_t>(pool->size(), chunk_count);
+	for (std::size_t h{}; h < helper_count; h++)
+		pool->enqueue(claim);
+
+	claim();
+
+	std::unique_lock<std::mutex> lk(s->mx);
+	s->cv.wait(lk, [&] { return s->done == chunk_count; });
+	if (s->error)
+		std::rethrow_exception(s->error);
+}
+
 /**
  * Divide the number of components into chunks for each thread
  * @param tc: (thread_count) number of threads to use
@@ -2,17 +2,24 @@
 #define BIDIRECTED_HPP
 
 #include <cstddef>	 // for size_t
+#include <cstdint>	 // for uint64_t
 #include <iostream>	 // for ostream
 #include <liteseq/gfa.h> // for gfa_free, gfa_props
+#include <memory>	 // for shared_ptr
 #include <optional>	 // for optional
 #include <set>		 // for set
 #include <string>	 // for string, basic_string
 #include <string_view>	 // for string_view
+#include <unordered_map> // for unordered_map
 #include <vector>	 // for vector
 
-#include "liteseq/refs.h"	 // for ref
-#include "povu/common/core.hpp"	 // for pt, idx_t, id_t, op_t
-#include "povu/common/utils.hpp" // for pu, TwoWayMap
+#include "liteseq/refs.h"	   // for ref
+#include "povu/common/arena.hpp"     // for Arena, vector
+#include "povu/common/compat.hpp"    // for span
+#include "povu/common/constants.hpp" // for INVALID_IDX
+#include "povu/common/core.hpp"	     // for pt, idx_t, id_t, op_t
+#include "povu/common/utils.hpp"     // for pu
+#include "povu/graph/label_store.hpp" // for LabelStore, label_enc_e
 #include "povu/graph/types.hpp"	 // for v_end_e, side_n_id_t, side_n_idx_t
 #include "povu/refs/refs.hpp"	 // for pr, Ref, Refs
 
@@ -22,6 +29,7 @@ inline constexpr std::string_view MODULE = "povu::bidirected";
 
 using namespace povu::types::graph;
 namespace pgt = povu::types::graph;
+namespace pa = povu::arena;
 
 namespace lq = liteseq;
 
@@ -60,50 +68,226 @@ public:
 
 class Vertex
 {
-	pt::id_t v_id_;	    // this is the sequence name in the GFA file. Maybe
-			    // Should support strings.
-	std::string label_; // or sequence
-
-	// indexes to the edge vector in Graph
-	std::set<pt::idx_t> e_l;
-	std::set<pt::idx_t> e_r;
+	pt::id_t v_id_; // this is the sequence name in the GFA file. Maybe
+			// Should support strings.
+	// the label (or sequence) lives in the graph's label store
+	const LabelStore *labels_;
+	pt::idx_t label_idx_;
+
+	// indexes to the edge vector in Graph, sorted and unique
+	// while the graph is loading each side owns its vector, VG::freeze
+	// moves them into a single CSR array owned by the graph and keeps views
+	// into it
+	pa::vector<pt::idx_t> e_l;
+	pa::vector<pt::idx_t> e_r;
+	pv_cmp::span<const pt::idx_t> csr_l_;
+	pv_cmp::span<const pt::idx_t> csr_r_;
 
 public:
 	// --------------
 	// constructor(s)
 	// --------------
-	Vertex(pt::id_t v_id, const std::string &label = "");
+	// the edge vectors are allocated from @p arena when given
+	Vertex(pt::id_t v_id, const LabelStore *labels = nullptr,
+	       pt::idx_t label_idx = pc::INVALID_IDX,
+	       pa::Arena *arena = nullptr);
 
 	// ---------
 	// getter(s)
 	// ---------
 	[[nodiscard]] pt::id_t id() const;
 	[[nodiscard]] pt::u32 get_length() const; // length of the label
-	[[nodiscard]] const std::string &get_label() const;
+	[[nodiscard]] pt::idx_t get_label_idx() const;
+	[[nodiscard]] std::string get_label() const;
 	// reverse complement of the label
 	[[nodiscard]] std::string get_rc_label() const;
-	[[nodiscard]] const std::set<pt::idx_t> &get_edges_l() const;
-	[[nodiscard]] const std::set<pt::idx_t> &get_edges_r() const;
+	void append_label(std::string &out) const;
+	void append_rc_label(std::string &out) const;
+	[[nodiscard]] pv_cmp::span<const pt::idx_t> get_edges_l() const;
+	[[nodiscard]] pv_cmp::span<const pt::idx_t> get_edges_r() const;
 
 	// ---------
 	// setter(s)
 	// ---------
 	void add_edge_l(pt::idx_t e_idx);
 	void add_edge_r(pt::idx_t e_idx);
+	// drop the owned edge vectors in favour of views into the graph's CSR
+	void freeze(pv_cmp::span<const pt::idx_t> l,
+		    pv_cmp::span<const pt::idx_t> r);
+};
+
+/**
+ * how a VertexIdMap resolves a segment id to a vertex index
+ *
+ * dense: ids are base, base + 1, ... in insertion order, the index is id - base
+ * flat: ids span a compact range, the index is read from a vector over it
+ * hashed: ids are sparse, the index is looked up in a hash map
+ */
+enum class id_map_e {
+	dense,
+	flat,
+	hashed
+};
+std::string_view to_str(id_map_e m);
+
+/**
+ * segment id <-> vertex index
+ *
+ * starts out dense and degrades to flat then hashed as inserted ids stop
+ * fitting the cheaper mode. Unknown ids and indexes map to 0.
+ */
+class VertexIdMap
+{
+	// a flat range may be this many times the vertex count (plus slack)
+	static constexpr pt::idx_t FLAT_MAX_SPREAD = 4;
+	static constexpr pt::idx_t FLAT_SLACK = 1024;
+
+	id_map_e mode_{id_map_e::dense};
+	pt::id_t base_{}; // the id at offset 0 of the dense or flat range
+	// views into the vectors below or into memory the owner of the map
+	// keeps alive, see from_parts
+	pv_cmp::span<const pt::id_t> idx_to_id_;
+	pv_cmp::span<const pt::idx_t> flat_; // v_idx of id base_ + i or
+					     // INVALID_IDX
+	std::vector<pt::id_t> idx_to_id_buf_;
+	std::vector<pt::idx_t> flat_buf_;
+	std::unordered_map<pt::id_t, pt::idx_t> hashed_;
+
+	[[nodiscard]] bool fits_flat(std::uint64_t span) const;
+	void to_flat();
+	void to_hashed();
+	// point the views at the vectors after they changed
+	void view_bufs();
+
+public:
+	// --------------
+	// constructor(s)
+	// --------------
+	VertexIdMap() = default;
+	// the views would point into the other map
+	VertexIdMap(const VertexIdMap &) = delete;
+	VertexIdMap &operator=(const VertexIdMap &) = delete;
+	VertexIdMap(VertexIdMap &&) = default;
+	VertexIdMap &operator=(VertexIdMap &&) = default;
+
+	// -----------------
+	// factory method(s)
+	// -----------------
+	/**
+	 * @brief the map whose mode, base, ids and flat are the ones given
+	 *
+	 * @p idx_to_id and @p flat are not copied and must outlive the map, a
+	 * hashed map rebuilds its hash map from @p idx_to_id. No ids can be
+	 * pushed back after.
+	 */
+	static VertexIdMap from_parts(id_map_e mode, pt::id_t base,
+				      pv_cmp::span<const pt::id_t> idx_to_id,
+				      pv_cmp::span<const pt::idx_t> flat);
+
+	// ---------
+	// getter(s)
+	// ---------
+	[[nodiscard]] id_map_e mode() const
+	{
+		return this->mode_;
+	}
+
+	[[nodiscard]] pt::id_t base() const
+	{
+		return this->base_;
+	}
+
+	// the segment id of each vertex index
+	[[nodiscard]] pv_cmp::span<const pt::id_t> ids() const
+	{
+		return this->idx_to_id_;
+	}
+
+	// empty unless flat
+	[[nodiscard]] pv_cmp::span<const pt::idx_t> flat() const
+	{
+		return this->flat_;
+	}
+
+	[[nodiscard]] pt::idx_t size() const
+	{
+		return static_cast<pt::idx_t>(this->idx_to_id_.size());
+	}
+
+	[[nodiscard]] pt::idx_t get_idx(pt::id_t v_id) const
+	{
+		switch (this->mode_) {
+		case id_map_e::dense: {
+			pt::id_t off = v_id - this->base_; // wraps below base
+			return off < this->size() ? off : pt::idx_t{};
+		}
+		case id_map_e::flat: {
+			pt::id_t off = v_id - this->base_;
+			if (off >= this->flat_.size() ||
+			    this->flat_[off] == pc::INVALID_IDX)
+				return pt::idx_t{};
+			return this->flat_[off];
+		}
+		default: {
+			auto it = this->hashed_.find(v_id);
+			return it == this->hashed_.end() ? pt::idx_t{}
+							 : it->second;
+		}
+		}
+	}
+
+	[[nodiscard]] pt::id_t get_id(pt::idx_t v_idx) const
+	{
+		return v_idx < this->size() ? this->idx_to_id_[v_idx]
+					    : pt::id_t{};
+	}
+
+	// ---------
+	// setter(s)
+	// ---------
+	void reserve(pt::idx_t vtx_count);
+	// map v_id to the next index, size() before the call
+	void push_back(pt::id_t v_id);
 };
 
 class VariationGraph
 {
 	std::vector<Vertex> vertices;
 	std::set<pgt::side_n_id_t> tips_; // the set of side and id of the tips
-	pu::TwoWayMap<std::size_t, std::size_t>
-		v_id_to_idx_; // TODO: reserve size
+	VertexIdMap v_ids_;
+	// shared with the components made from this graph
+	std::shared_ptr<LabelStore> labels_;
+	// where the vertices allocate their edge vectors, the heap if null
+	pa::Arena *arena_{nullptr};
+
+	// a view into the vector below or into backing_
+	pv_cmp::span<const Edge> edges_;
+	std::vector<Edge> edges_buf_;
+
+	// per vertex, see get_folded, empty when compact_chains folded none
+	std::vector<pt::idx_t> folded_;
 
-	std::vector<Edge> edges;
+	// packed adjacency, each vertex's left then right edge indexes
+	std::vector<pt::idx_t> adj_;
+	bool frozen_{false};
 
-	// i is the vertex index, j is the ref index
-	std::vector<std::vector<std::vector<pt::idx_t>>> vertex_to_step_matrix_;
+	/*
+	  vertex to step index in CSR form
+	  the steps of v_idx are at [step_offsets_[v_idx],
+	  step_offsets_[v_idx + 1]) of step_ref_ids_ and step_idxs_ sorted by
+	  ref id then by step index
+	  views into the vectors below or into backing_
+	*/
+	pv_cmp::span<const std::uint64_t> step_offsets_;
+	pv_cmp::span<const pt::id_t> step_ref_ids_;
+	pv_cmp::span<const pt::idx_t> step_idxs_;
+	std::vector<std::uint64_t> step_offsets_buf_;
+	std::vector<pt::id_t> step_ref_ids_buf_;
+	std::vector<pt::idx_t> step_idxs_buf_;
 	pr::Refs refs_;
+	// what the ref walks, the step index and, once set_frozen, the id map,
+	// the edges and the adjacency view when read from an index
+	std::shared_ptr<const void> backing_;
 
 	lq::gfa_props *gfa;
 
@@ -125,21 +309,41 @@ public:
 	// -----------------
 	// factory method(s)
 	// -----------------
-	// return a vector of connected components as VG objects
+	// return a vector of connected components as VG objects, ordered by
+	// their smallest vertex index
 	static std::vector<VariationGraph *>
-	componetize(const VariationGraph &g);
+	componetize(const VariationGraph &g, std::size_t thread_count = 1);
+	/**
+	 * @brief a copy of g with runs of unbranched vertices shortened
+	 *
+	 * a run of vertices with one edge on each side is replaced by its two
+	 * end vertices. The first end keeps the number of vertices dropped
+	 * from the run, see get_folded, so that the flubble tree found in the
+	 * copy is that of g. The subflubbles can differ. Refs are not copied.
+	 *
+	 * @param arena when given the vertices of the copy allocate their edge
+	 *        vectors from it, see set_arena
+	 */
+	static VariationGraph *compact_chains(const VariationGraph &g,
+					      pa::Arena *arena = nullptr);
 
 	// ---------
 	// getter(s)
 	// ---------
 	pt::idx_t v_id_to_idx(pt::id_t v_id) const;
 	pt::id_t v_idx_to_id(pt::idx_t v_idx) const;
+	// which lookup the segment ids ended up needing
+	id_map_e id_map_mode() const;
 
 	pt::idx_t vtx_count() const;
+	bool is_frozen() const;
 	pt::idx_t edge_count() const;
 	const std::set<pgt::side_n_id_t> &tips() const;
+	const std::shared_ptr<LabelStore> &get_label_store() const;
+	// the vertices compact_chains dropped from the run starting at v_idx
+	pt::idx_t get_folded(pt::idx_t v_idx) const;
 	const Edge &get_edge(pt::idx_t e_idx) const;
-	Edge &get_edge_mut(pt::idx_t e_idx);
+	const VertexIdMap &get_id_map() const;
 	// TODO replace vertex with v?
 	const Vertex &get_vertex_by_idx(pt::idx_t v_idx) const;
 	const Vertex &get_vertex_by_id(pt::id_t v_id) const;
@@ -166,16 +370,26 @@ public:
 	 */
 	std::set<pt::id_t>
 	get_refs_in_sample(std::string_view sample_name) const;
-	const lq::ref *get_ref_vec(pt::id_t ref_id) const;
+	const lq::ref_walk *get_ref_walk(pt::id_t ref_id) const;
 
 	/** for GFA 1.1 returns the no of P lines in the graph */
 	pt::u32 get_hap_count() const;
 
-	const std::vector<pt::idx_t> &
+	/** @brief sorted step indexes of the vertex in the ref walk */
+	pv_cmp::span<const pt::idx_t>
 	get_vertex_ref_idxs(pt::idx_t v_idx, pt::id_t ref_id) const;
-
-	const std::vector<std::vector<pt::idx_t>> &
-	get_vertex_refs(pt::idx_t v_id) const;
+	/**
+	 * @brief the ref ids of all the steps of the vertex, sorted
+	 *
+	 * the step index of each is at the same position in get_vertex_steps
+	 */
+	pv_cmp::span<const pt::id_t>
+	get_vertex_step_refs(pt::idx_t v_idx) const;
+	pv_cmp::span<const pt::idx_t> get_vertex_steps(pt::idx_t v_idx) const;
+	// the whole step index, empty unless the refs were loaded
+	pv_cmp::span<const std::uint64_t> get_step_offsets() const;
+	pv_cmp::span<const pt::id_t> get_step_ref_ids() const;
+	pv_cmp::span<const pt::idx_t> get_step_idxs() const;
 
 	pt::idx_t get_ploidy(const std::string &sample_name) const;
 	pt::idx_t get_ploidy_id(const std::string &sample_name,
@@ -189,16 +403,68 @@ public:
 	// setter(s)
 	// ---------
 	void add_tip(pt::id_t v_id, pgt::v_end_e end);
+	/**
+	 * @brief replace the label store, only before any vertex is added
+	 *
+	 * labels added afterwards that lie inside the store's backing buffer
+	 * are kept as views into it
+	 */
+	void set_label_store(std::shared_ptr<LabelStore> labels);
+	/**
+	 * @brief allocate the edge vectors of the vertices from @p arena, only
+	 * before any vertex is added
+	 *
+	 * the arena must outlive the graph
+	 */
+	void set_arena(pa::Arena *arena);
 	// returns the index (v_idx) of the added vertex
-	pt::idx_t add_vertex(pt::id_t v_id, const std::string &label);
+	pt::idx_t add_vertex(pt::id_t v_id, std::string_view label);
+	// add a vertex whose label is already in the label store
+	pt::idx_t add_labelled_vertex(pt::id_t v_id, pt::idx_t label_idx);
 	// returns the index (e_idx) of the added edge
 	pt::idx_t add_edge(pt::id_t v1_id, pgt::v_end_e v1_end, pt::id_t v2_id,
 			   pgt::v_end_e v2_end);
 	void add_all_refs(lq::ref **refs, pt::idx_t ref_count);
+	void add_ref(pr::Ref r);
+	/**
+	 * @brief keep @p backing alive as long as the graph
+	 *
+	 * for the ref walks and the step index when they are views into it
+	 */
+	void set_backing(std::shared_ptr<const void> backing);
+	/**
+	 * @brief use a step index laid out as gen_vertex_step_index does
+	 *
+	 * the spans are not copied, see set_backing
+	 */
+	void set_vertex_step_index(pv_cmp::span<const std::uint64_t> offsets,
+				   pv_cmp::span<const pt::id_t> ref_ids,
+				   pv_cmp::span<const pt::idx_t> step_idxs);
+	/**
+	 * @brief pack the adjacency of every vertex into one CSR array
+	 *
+	 * call once the graph is fully loaded, no edges can be added after
+	 */
+	void freeze();
+	/**
+	 * @brief adopt the vertices and edges of a graph already frozen
+	 *
+	 * the edges of v_idx on its left are at [adj_offsets[2 * v_idx],
+	 * adj_offsets[2 * v_idx + 1]) of adj and those on its right follow up
+	 * to adj_offsets[2 * v_idx + 2], as freeze packs them. Only on a
+	 * graph with no vertices, the spans are not copied, see set_backing.
+	 *
+	 * @param label_idxs the label of each vertex in the label store, no
+	 *        labels when empty
+	 */
+	void set_frozen(VertexIdMap v_ids, pv_cmp::span<const Edge> edges,
+			pv_cmp::span<const std::uint64_t> adj_offsets,
+			pv_cmp::span<const pt::idx_t> adj,
+			pv_cmp::span<const pt::idx_t> label_idxs);
 	// pt::id_t add_ref(const std::string &label, char delim);
 	void shrink_to_fit();
-	void set_vtx_ref_idx(pt::id_t v_id, pt::id_t ref_id,
-			     pt::idx_t step_idx);
+	/** @brief build the vertex to step index from the ref walks */
+	void gen_vertex_step_index(std::size_t thread_count);
 	void gen_genotype_metadata();
 
 	// -----
@@ -211,6 +477,71 @@ public:
 
 using VG = VariationGraph;
 // typedef VariationGraph VG;
+
+/**
+ * Hands out the connected components of a graph one at a time.
+ *
+ * The components are found up front but only as vertex index buckets, a
+ * component's VG is built when it is extracted. Workers that extract, use and
+ * delete one component at a time keep only the components in flight in
+ * memory. extract can be called from several threads at once. The graph must
+ * outlive the generator.
+ */
+class ComponentGenerator
+{
+	const VG &g_;
+	pt::idx_t comp_count_{};
+
+	// the vertices of component c are at
+	// [vtx_offsets_[c], vtx_offsets_[c + 1]) of comp_vtxs_ in index order
+	std::vector<pt::idx_t> vtx_offsets_;
+	std::vector<pt::idx_t> comp_vtxs_;
+	std::vector<pt::idx_t> edge_counts_;
+	// same layout for the tips
+	std::vector<pt::idx_t> tip_offsets_;
+	std::vector<pgt::side_n_id_t> comp_tips_;
+
+	// set when an edge is first met, components share no edges
+	std::vector<char> added_edges_;
+
+public:
+	// --------------
+	// constructor(s)
+	// --------------
+	ComponentGenerator(const VG &g, std::size_t thread_count = 1);
+
+	// ---------
+	// getter(s)
+	// ---------
+	// the number of components
+	[[nodiscard]] pt::idx_t size() const;
+	// the graph the components are made from
+	[[nodiscard]] const VG &graph() const;
+	// vertex and edge counts of component c, known without extracting it
+	[[nodiscard]] pt::idx_t vtx_count(pt::idx_t c) const;
+	[[nodiscard]] pt::idx_t edge_count(pt::idx_t c) const;
+	// indexes in the source graph of the vertices of component c, sorted
+	[[nodiscard]] pv_cmp::span<const pt::idx_t> vtxs(pt::idx_t c) const;
+	/**
+	 * @brief the component indexes, largest first by vertex plus edge count
+	 *
+	 * ties keep the order of the components' smallest vertex index
+	 */
+	[[nodiscard]] std::vector<pt::idx_t> by_size() const;
+
+	// -----
+	// other
+	// -----
+	/**
+	 * @brief build the VG of component c, the caller owns it
+	 *
+	 * each component can be extracted only once
+	 *
+	 * @param arena when given the vertices allocate their edge vectors from
+	 * it, it must outlive the VG
+	 */
+	VG *extract(pt::idx_t c, pa::Arena *arena = nullptr);
+};
 } // namespace povu::bidirected
 
 // NOLINTNEXTLINE(misc-unused-alias-decls)
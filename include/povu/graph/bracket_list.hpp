@@ -1,14 +1,14 @@
 #ifndef B_LIST_HPP
 #define B_LIST_HPP
 
-#include <cstddef>
-#include <list>
-#include <unordered_map>
+#include <cstddef> // for size_t
+#include <vector>  // for vector
+
+#include "povu/common/constants.hpp" // for INVALID_IDX
+#include "povu/common/core.hpp"	     // for pt, idx_t
 
 namespace povu::bracket_list
 {
-class Bracket;
-typedef std::list<Bracket> BracketList;
 
 /*
  * Bracket
@@ -37,27 +37,80 @@ public:
 };
 
 /*
- * BracketList wrapper
- * -------------------
- *
+ * BracketList
+ * -----------
+ *  the ends and length of a list of brackets held in a BracketPool
+ */
+struct BracketList {
+	pt::idx_t head{pc::INVALID_IDX}; // the top of the list
+	pt::idx_t tail{pc::INVALID_IDX};
+	std::size_t size{};
+};
+
+/*
+ * BracketPool
+ * -----------
+ *  the bracket lists of all the vertices of a tree
  *
+ *  Each backedge is pushed onto a list only once so its bracket is kept at the
+ *  index of the backedge and the lists are linked through those indexes.
+ *  Pushing, deleting and concatenating lists do not allocate, apart from the
+ *  pool growing past the backedges it was made for, and concatenating is
+ *  constant time. Lists that share no brackets can be changed at once as long
+ *  as the pool does not grow.
  */
-class WBracketList
+class BracketPool
 {
-	BracketList brackets;
-	std::unordered_map<std::size_t, std::list<Bracket>::iterator>
-		bracket_map;
+	struct node_t {
+		Bracket br;
+		pt::idx_t prev;
+		pt::idx_t next;
+		bool linked; // in a list, false before a push and after a del
+	};
+
+	std::vector<node_t> nodes_;	 // indexed by backedge idx
+	std::vector<BracketList> lists_; // indexed by vertex idx
+
+	/*
+	  only filled in DEBUG builds, to check that a bracket is deleted from
+	  the list it is in. The list a bracket is in is found by following
+	  the lists it was moved to from the one it was pushed onto
+	*/
+	std::vector<pt::idx_t> pushed_to_; // indexed by backedge idx
+	// indexed by vertex idx, the list its brackets were concatenated onto
+	// or INVALID_IDX
+	std::vector<pt::idx_t> moved_to_;
+
+	// the vertex idx of the list the bracket of be_idx is in
+	[[nodiscard]] pt::idx_t owner(std::size_t be_idx) const;
 
 public:
-	WBracketList();
-	void push(Bracket br);
-	std::size_t size() const;
-	Bracket &top();
-	BracketList &get_bracket_list();
-	std::unordered_map<std::size_t, std::list<Bracket>::iterator>
-	get_bracket_map();
-	void del(std::size_t backedge_id);
-	void concat(WBracketList *other);
+	// --------------
+	// constructor(s)
+	// --------------
+	BracketPool() = default;
+	// room for the brackets of backedge idxs below be_count
+	BracketPool(std::size_t vtx_count, std::size_t be_count);
+
+	// ---------
+	// getter(s)
+	// ---------
+	[[nodiscard]] std::size_t size(std::size_t v_idx) const;
+	// the bracket at the top of the list of v, the list must not be empty
+	Bracket &top(std::size_t v_idx);
+
+	// ---------
+	// setter(s)
+	// ---------
+	// v_idx's list must not have been concatenated onto another
+	void push(std::size_t v_idx, std::size_t be_idx, std::size_t be_id);
+	// does nothing if the bracket of be_idx is not in a list, otherwise it
+	// must be in the list of v_idx
+	void del(std::size_t v_idx, std::size_t be_idx);
+	// move the brackets of c_v_idx to the top of the list of p_v_idx
+	void concat(std::size_t p_v_idx, std::size_t c_v_idx);
+	// free all the lists at once
+	void clear();
 };
 
 } // namespace povu::bracket_list
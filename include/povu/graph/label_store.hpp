@@ -0,0 +1,99 @@
+#ifndef POVU_LABEL_STORE_HPP
+#define POVU_LABEL_STORE_HPP
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <memory>      // for shared_ptr
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+#include "povu/common/constants.hpp" // for INVALID_IDX
+#include "povu/common/core.hpp"	     // for pt, idx_t, u32
+
+namespace povu::bidirected
+{
+
+/**
+ * text: labels are kept as they appear in the input
+ * packed: ACGT labels take 2 bits per base, any other label is kept as text
+ */
+enum class label_enc_e {
+	text,
+	packed
+};
+std::string_view to_str(label_enc_e e);
+
+/**
+ * Vertex labels (sequences) held apart from the vertices
+ *
+ * Text labels are (offset, length) views into a backing buffer, either an
+ * external one such as the mmapped GFA, which the store keeps alive, or text
+ * the store copied in because it was not inside that buffer. A graph and the
+ * components made from it share one store instead of copying the labels.
+ *
+ * Labels are only added while a graph is loading, reads are safe to share
+ * between threads.
+ */
+class LabelStore
+{
+	struct entry_t {
+		std::uint64_t off; // in bases when packed else in bytes
+		pt::u32 len;
+		bool packed;
+	};
+
+	label_enc_e enc_;
+
+	// text at offsets below backing_size_ is in the backing buffer, the
+	// rest is in owned_
+	std::shared_ptr<const void> backing_owner_;
+	const char *backing_{nullptr};
+	std::size_t backing_size_{};
+	std::string owned_;
+
+	std::vector<std::uint64_t> packed_; // 32 bases per word, first base low
+	std::uint64_t packed_len_{};	    // in bases
+
+	std::vector<entry_t> entries_;
+
+	[[nodiscard]] bool in_backing(std::string_view label) const;
+	[[nodiscard]] const char *text_at(const entry_t &e) const;
+	void pack(std::string_view label);
+
+public:
+	// --------------
+	// constructor(s)
+	// --------------
+	explicit LabelStore(label_enc_e enc = label_enc_e::text);
+	// @param owner keeps the memory behind @p backing alive
+	LabelStore(std::shared_ptr<const void> owner, std::string_view backing,
+		   label_enc_e enc = label_enc_e::text);
+
+	// ---------
+	// getter(s)
+	// ---------
+	[[nodiscard]] label_enc_e encoding() const;
+	[[nodiscard]] pt::idx_t size() const;
+	[[nodiscard]] pt::u32 length(pt::idx_t l_idx) const;
+	// bytes held by the store itself, the backing buffer is not counted
+	[[nodiscard]] std::size_t owned_bytes() const;
+
+	// append the label or its reverse complement to @p out
+	void append(pt::idx_t l_idx, std::string &out) const;
+	void append_rc(pt::idx_t l_idx, std::string &out) const;
+
+	// ---------
+	// setter(s)
+	// ---------
+	void reserve(pt::idx_t label_count);
+	/**
+	 * @return the index of the label, INVALID_IDX for an empty label which
+	 * takes no space
+	 */
+	pt::idx_t add(std::string_view label);
+};
+
+} // namespace povu::bidirected
+
+#endif // POVU_LABEL_STORE_HPP
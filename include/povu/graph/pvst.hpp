@@ -4,7 +4,11 @@
 #include <algorithm>
 #include <optional>
 #include <stack>
+#include <stdexcept>
 #include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
 
 #include "povu/common/compat.hpp"
 #include "povu/common/constants.hpp"
@@ -159,6 +163,9 @@ inline std::ostream &operator<<(std::ostream &os, route_e r)
 	return os << to_str(r);
 }
 
+// the two bounds of a vertex in the order they appear in its label
+typedef std::pair<pgt::id_or_t, pgt::id_or_t> label_bounds_t;
+
 // bounds in the bidirected graph
 struct route_params_t {
 	pgt::id_or_t start;
@@ -235,6 +242,8 @@ public:
 	virtual std::string as_str() const = 0;
 	// TODO: make this result a const reference?
 	virtual std::optional<route_params_t> get_route_params() const = 0;
+	// for some vertices the label order is not the route order
+	virtual std::optional<label_bounds_t> get_label_bounds() const = 0;
 	virtual ~VertexBase() = default;
 
 	// -------
@@ -277,6 +286,11 @@ public:
 	{
 		return std::nullopt; // dummy vertex does not have route params
 	}
+
+	std::optional<label_bounds_t> get_label_bounds() const override
+	{
+		return std::nullopt;
+	}
 };
 
 class SnE : public VertexBase
@@ -301,6 +315,12 @@ public:
 	{
 		return std::nullopt; // dummy vertex does not have route params
 	}
+
+	[[nodiscard]]
+	std::optional<label_bounds_t> get_label_bounds() const override
+	{
+		return std::nullopt;
+	}
 };
 
 class Flubble : public VertexBase
@@ -405,6 +425,11 @@ public:
 	// ------
 	// others
 	// ------
+	std::optional<label_bounds_t> get_label_bounds() const override
+	{
+		return label_bounds_t{this->a_, this->z_};
+	}
+
 	std::string as_str() const override
 	{
 		return pv_cmp::format("{}{}", this->a_.as_str(),
@@ -514,16 +539,18 @@ public:
 	// ------
 	// others
 	// ------
+	std::optional<label_bounds_t> get_label_bounds() const override
+	{
+		if (with_ai()) // formed with a
+			return label_bounds_t{this->fl_b_, this->cn_b_};
+		else // formed with z
+			return label_bounds_t{this->cn_b_, this->fl_b_};
+	}
+
 	std::string as_str() const override
 	{
-		if (with_ai()) { // formed with a
-			return pv_cmp::format("{}{}", this->fl_b_.as_str(),
-					      this->cn_b_.as_str());
-		}
-		else { // formed with z
-			return pv_cmp::format("{}{}", this->cn_b_.as_str(),
-					      this->fl_b_.as_str());
-		}
+		auto [l, r] = *this->get_label_bounds();
+		return pv_cmp::format("{}{}", l.as_str(), r.as_str());
 	}
 };
 
@@ -615,24 +642,19 @@ public:
 		return route_params_t{this->sm_b_, this->cn_b_, this->route_};
 	}
 
+	std::optional<label_bounds_t> get_label_bounds() const override
+	{
+		// with g the label starts with the ancestor, with s with sm_b
+		if (this->cn_type_ == cb_e::g && this->cn_b_is_ans_)
+			return label_bounds_t{this->cn_b_, this->sm_b_};
+		else
+			return label_bounds_t{this->sm_b_, this->cn_b_};
+	}
+
 	std::string as_str() const override
 	{
-		if (this->cn_type_ == cb_e::g) {  // g
-			if (this->cn_b_is_ans_) { // cn_b is ancestor of sm_b
-				return pv_cmp::format("{}{}",
-						      this->cn_b_.as_str(),
-						      this->sm_b_.as_str());
-			}
-			else { // sm_b is ancestor of cn_b
-				return pv_cmp::format("{}{}",
-						      this->sm_b_.as_str(),
-						      this->cn_b_.as_str());
-			}
-		}
-		else { // s
-			return pv_cmp::format("{}{}", this->sm_b_.as_str(),
-					      this->cn_b_.as_str());
-		}
+		auto [l, r] = *this->get_label_bounds();
+		return pv_cmp::format("{}{}", l.as_str(), r.as_str());
 	}
 };
 
@@ -708,6 +730,11 @@ public:
 				      this->route_};
 	}
 
+	std::optional<label_bounds_t> get_label_bounds() const override
+	{
+		return label_bounds_t{this->g_, this->s_};
+	}
+
 	std::string as_str() const override
 	{
 		return pv_cmp::format("{}{}", this->g_.as_str(),
@@ -715,15 +742,47 @@ public:
 	}
 };
 
+// a vertex of any family, held by value
+using vertex_t =
+	std::variant<Dummy, SnE, Flubble, Concealed, Smothered, MidiBubble>;
+
 // always has a dummy root vertex
 class Tree
 {
-	std::vector<std::unique_ptr<pvst::VertexBase>> vertices;
+	// the vertices are kept by value in one vector so adding a vertex
+	// invalidates references and pointers to the others
+	std::vector<vertex_t> vertices;
 	std::vector<pt::idx_t> parent_v; // parent of each vertex
-	std::vector<std::vector<pt::idx_t>>
-		children_v;  // children of each vertex
+	// children of each vertex. While the tree is built each vertex owns its
+	// vector, freeze moves them into the CSR arrays ch_offsets_ and ch_
+	std::vector<std::vector<pt::idx_t>> children_v;
+	std::vector<pt::idx_t> ch_offsets_;
+	std::vector<pt::idx_t> ch_;
+	bool frozen_{false};
 	pt::idx_t root_idx_; // index of the root vertex in the vertices vector
 
+	static const pvst::VertexBase &as_base(const vertex_t &v)
+	{
+		return std::visit(
+			[](const auto &x) -> const pvst::VertexBase & {
+				return x;
+			},
+			v);
+	}
+
+	static pvst::VertexBase &as_base(vertex_t &v)
+	{
+		return std::visit(
+			[](auto &x) -> pvst::VertexBase & { return x; }, v);
+	}
+
+	void throw_if_frozen() const
+	{
+		if (this->frozen_) {
+			throw std::logic_error("the PVST is frozen");
+		}
+	}
+
 public:
 	// --------------
 	// constructor(s)
@@ -741,6 +800,12 @@ public:
 			std::vector<std::vector<pt::idx_t>>(1 + expected_size);
 	}
 
+	// trees are large, they only move so that none is copied by accident
+	Tree(const Tree &) = delete;
+	Tree &operator=(const Tree &) = delete;
+	Tree(Tree &&) = default;
+	Tree &operator=(Tree &&) = default;
+
 	// ---------
 	// getter(s)
 	// ---------
@@ -762,22 +827,17 @@ public:
 
 	const pvst::VertexBase &get_vertex(pt::idx_t v_idx) const
 	{
-		return *this->vertices[v_idx];
-	}
-
-	const pvst::VertexBase *get_vertex_const_ptr(pt::idx_t v_idx) const
-	{
-		return this->vertices[v_idx].get();
+		return as_base(this->vertices[v_idx]);
 	}
 
 	pvst::VertexBase &get_vertex_mut(pt::idx_t v_idx)
 	{
-		return *this->vertices[v_idx];
+		return as_base(this->vertices[v_idx]);
 	}
 
 	const pvst::VertexBase &get_parent(pt::idx_t v_idx) const
 	{
-		return *this->vertices[parent_v[v_idx]];
+		return as_base(this->vertices[parent_v[v_idx]]);
 	}
 
 	pt::idx_t get_parent_idx(pt::idx_t v_idx) const
@@ -786,15 +846,34 @@ public:
 	}
 
 	// TODO: rename to get_children_idxs()
-	const std::vector<pt::idx_t> &get_children(pt::idx_t v_idx) const
+	[[nodiscard]] pv_cmp::span<const pt::idx_t>
+	get_children(pt::idx_t v_idx) const
 	{
-		return this->children_v[v_idx];
+		if (!this->frozen_) {
+			if (v_idx >= this->children_v.size()) {
+				return {};
+			}
+
+			const auto &ch = this->children_v[v_idx];
+			return {ch.data(), ch.size()};
+		}
+
+		if (v_idx + 1 >= this->ch_offsets_.size()) {
+			return {};
+		}
+
+		pt::idx_t b = this->ch_offsets_[v_idx];
+		return {this->ch_.data() + b, this->ch_offsets_[v_idx + 1] - b};
 	}
 
 	bool is_leaf(pt::idx_t v_idx) const
 	{
-		return v_idx >= this->children_v.size() ||
-		       this->children_v[v_idx].empty();
+		return this->get_children(v_idx).empty();
+	}
+
+	[[nodiscard]] bool is_frozen() const
+	{
+		return this->frozen_;
 	}
 
 	// ---------
@@ -811,8 +890,8 @@ public:
 		}
 
 		// reset heights
-		for (auto &v : this->vertices) {
-			v->set_height(0);
+		for (vertex_t &v : this->vertices) {
+			as_base(v).set_height(0);
 		}
 
 		// compute heights using DFS
@@ -848,6 +927,14 @@ public:
 		this->root_idx_ = v_idx;
 	}
 
+	// make room for @p vtx_count vertices without reallocating
+	void reserve(pt::idx_t vtx_count)
+	{
+		this->vertices.reserve(vtx_count);
+		this->parent_v.reserve(vtx_count);
+		this->children_v.reserve(vtx_count);
+	}
+
 	/**
 	 * @brief Add a vertex to the tree
 	 * @param v Vertex to be added
@@ -856,6 +943,8 @@ public:
 	template <typename T>
 	pt::idx_t add_vertex(T v)
 	{
+		this->throw_if_frozen();
+
 		pt::idx_t v_idx = this->vertices.size();
 		v.set_idx(v_idx); // set the index of the vertex
 
@@ -871,16 +960,16 @@ public:
 							   // has enough space
 		}
 
-		// create a unique pointer to the vertex and add it to the
-		// vertices vector
-		auto ptr = std::make_unique<T>(v);
-		this->vertices.push_back(std::move(ptr));
+		this->vertices.emplace_back(std::in_place_type<T>,
+					    std::move(v));
 
 		return v_idx;
 	}
 
 	void add_edge(pt::idx_t parent, pt::idx_t child)
 	{
+		this->throw_if_frozen();
+
 		while (child >= this->parent_v.size()) {
 			this->parent_v.push_back(pc::INVALID_ID);
 		}
@@ -893,6 +982,8 @@ public:
 
 	void del_edge(pt::idx_t parent, pt::idx_t child)
 	{
+		this->throw_if_frozen();
+
 		this->parent_v[child] = pc::INVALID_IDX;
 
 		std::vector<pt::idx_t> &children = this->children_v[parent];
@@ -902,6 +993,71 @@ public:
 		}
 	}
 
+	/**
+	 * @brief move the children of all the vertices into one CSR array
+	 *
+	 * for a tree that is done, afterwards vertices and edges can no longer
+	 * be added or removed
+	 */
+	void freeze()
+	{
+		if (this->frozen_) {
+			return;
+		}
+
+		this->ch_offsets_.assign(this->children_v.size() + 1, 0);
+		for (pt::idx_t v_idx{}; v_idx < this->children_v.size();
+		     v_idx++) {
+			this->ch_offsets_[v_idx + 1] =
+				this->ch_offsets_[v_idx] +
+				this->children_v[v_idx].size();
+		}
+
+		this->ch_.clear();
+		this->ch_.reserve(this->ch_offsets_.back());
+		for (const std::vector<pt::idx_t> &ch : this->children_v) {
+			this->ch_.insert(this->ch_.end(), ch.begin(), ch.end());
+		}
+
+		std::vector<std::vector<pt::idx_t>>().swap(this->children_v);
+		this->frozen_ = true;
+	}
+
+	/**
+	 * @brief freeze a tree whose children are already in CSR form, such as
+	 * a tree read from a binary PVST
+	 *
+	 * the tree must not have any edges yet. The children of v are
+	 * ch[ch_offsets[v], ch_offsets[v + 1])
+	 */
+	void freeze(std::vector<pt::idx_t> ch_offsets,
+		    std::vector<pt::idx_t> ch)
+	{
+		this->throw_if_frozen();
+
+		if (ch_offsets.size() != this->vtx_count() + 1 ||
+		    ch_offsets.back() != ch.size()) {
+			throw std::invalid_argument(
+				"CSR children do not match the vertices");
+		}
+
+		for (pt::idx_t v_idx{}; v_idx < this->vtx_count(); v_idx++) {
+			for (pt::idx_t i = ch_offsets[v_idx];
+			     i < ch_offsets[v_idx + 1]; i++) {
+				if (ch[i] >= this->vtx_count()) {
+					throw std::out_of_range(
+						"Vertex index out of range");
+				}
+				this->parent_v[ch[i]] = v_idx;
+			}
+		}
+
+		this->ch_offsets_ = std::move(ch_offsets);
+		this->ch_ = std::move(ch);
+		std::vector<std::vector<pt::idx_t>>().swap(this->children_v);
+		this->frozen_ = true;
+	}
+
 	// ----
 	// misc
 	// ----
@@ -2,22 +2,22 @@
 #define SPANNING_TREE_HPP
 
 #include <cstddef> // for size_t
-#include <map>	   // for map
 #include <ostream> // for ostream
 #include <set>	   // for set
 #include <utility> // for pair
 #include <vector>  // for vector
 
-#include "bidirected.hpp"	// for VG, bd
-#include "bracket_list.hpp"	// for WBracketList, Bracket, BracketList
-#include "povu/common/core.hpp" // for pt, idx_t, id_t
-#include "types.hpp"		// for color_e, v_type_e
+#include "bidirected.hpp"	  // for VG, bd
+#include "povu/common/arena.hpp"  // for Arena, vector
+#include "povu/common/compat.hpp" // for span
+#include "povu/common/core.hpp"	  // for pt, idx_t, id_t
+#include "types.hpp"		  // for color_e, v_type_e
 
 namespace povu::spanning_tree
 {
 using namespace povu::types::graph;
-using namespace povu::bracket_list;
 namespace pgt = povu::types::graph;
+namespace pa = povu::arena;
 
 enum class be_type_e {
 	// tree_edge, // TODO: remove
@@ -90,11 +90,30 @@ public:
  */
 class Vertex
 {
-	// indexes of the children edges in the tree_edges vector
-	std::set<pt::idx_t>
-		child_e_idxs_;	 // children // index to the tree_edges vector
-	std::set<pt::idx_t> obe; // out back edges
-	std::set<pt::idx_t> ibe; // in back edges
+public:
+	// views into the CSR array of a frozen tree
+	struct adj_t {
+		pv_cmp::span<const pt::idx_t> child_e_idxs;
+		pv_cmp::span<const pt::idx_t> child_v_idxs;
+		pv_cmp::span<const pt::idx_t> obe;
+		pv_cmp::span<const pt::idx_t> ibe;
+		// sorted and unique, only set by Tree::freeze
+		pv_cmp::span<const pt::idx_t> obe_tgts;
+		pv_cmp::span<const pt::idx_t> ibe_srcs;
+	};
+
+private:
+	// indexes of the children edges in the tree_edges vector, the v_idxs of
+	// the children and the indexes of the out and in back edges in the
+	// back_edges vector. They are appended in increasing order so they are
+	// sorted. While the tree is built each vertex owns its vectors,
+	// Tree::freeze moves them into a single CSR array owned by the tree and
+	// keeps views into it
+	pa::vector<pt::idx_t> child_e_idxs_;
+	pa::vector<pt::idx_t> child_v_idxs_;
+	pa::vector<pt::idx_t> obe; // out back edges
+	pa::vector<pt::idx_t> ibe; // in back edges
+	adj_t csr_;
 
 	pt::idx_t dfs_num_;	 // Preorder DFS traversal number
 	pt::idx_t parent_e_idx_; // id to idx // index to the tree edge vector ?
@@ -114,7 +133,9 @@ public:
 	// --------------
 	// constructor(s)
 	// --------------
-	Vertex(pt::idx_t dfs_num, pt::idx_t g_v_id, v_type_e type);
+	// the owned vectors are allocated from @p arena when given
+	Vertex(pt::idx_t dfs_num, pt::idx_t g_v_id, v_type_e type,
+	       pa::Arena *arena = nullptr);
 
 	// ---------
 	// getter(s)
@@ -129,13 +150,17 @@ public:
 	pt::idx_t g_v_id() const;
 	v_type_e type() const;
 
-	std::set<pt::idx_t> const &get_obe() const;
-	std::set<pt::idx_t> const &get_ibe() const;
+	[[nodiscard]] pv_cmp::span<const pt::idx_t> get_obe() const;
+	[[nodiscard]] pv_cmp::span<const pt::idx_t> get_ibe() const;
+	// empty until the tree is frozen
+	[[nodiscard]] pv_cmp::span<const pt::idx_t> get_obe_tgts() const;
+	[[nodiscard]] pv_cmp::span<const pt::idx_t> get_ibe_srcs() const;
 
 	// get the index of the edge that points to the parent in the tree
 	pt::idx_t get_parent_e_idx() const;
 
-	std::set<pt::idx_t> const &get_child_edge_idxs() const;
+	[[nodiscard]] pv_cmp::span<const pt::idx_t> get_child_edge_idxs() const;
+	[[nodiscard]] pv_cmp::span<const pt::idx_t> get_children() const;
 	pt::idx_t child_count() const;
 
 	// ---------
@@ -143,7 +168,10 @@ public:
 	// ---------
 	void add_obe(pt::idx_t obe_id);
 	void add_ibe(pt::idx_t ibe_id);
-	void add_child_e_idx(pt::idx_t e_id);
+	// the tree edge at e_idx goes to the child at c_v_idx
+	void add_child(pt::idx_t e_idx, pt::idx_t c_v_idx);
+	// drop the owned vectors in favour of views into the tree's CSR
+	void freeze(const adj_t &csr);
 
 	// the index of the parent node in the tree vertex
 	void set_parent_e_idx(pt::idx_t e_idx);
@@ -163,26 +191,18 @@ class Tree
 	std::vector<Edge> tree_edges;
 	std::vector<BackEdge> back_edges;
 
-	// TODO: move the bracket list don't keep creating a new one
-	// a BracketList for each node
-	// the list of backedges bracketing a node
-	// a bracketList is a backedge with some metadata around it
-	// std::vector<BracketList *> bracket_lists;
-	std::vector<WBracketList *> bracket_lists;
-
-	// the index of an edge or backedge in the input graph
-	// key is the graph_idx and the value is the tree_idx or the backedge
-	// idx
-	std::map<std::size_t, std::pair<be_type_e, std::size_t>> g_edge_idx_map;
-
-	// tree idx to graph edge idx
-	std::map<std::size_t, std::size_t> tree_graph_idx_map_;
+	// tree edges and backedges share one dense id space, the index in the
+	// back_edges vector of the backedge with a given id, INVALID_IDX for
+	// the ids of tree edges
+	std::vector<pt::idx_t> be_id_to_idx_;
 
-	// a map from the back edge id to the index in the back_edges vector
-	std::map<std::size_t, std::size_t> be_id_to_idx_map_;
+	// packed adjacency of the vertices, see Vertex::adj_t
+	std::vector<pt::idx_t> adj_;
+	bool frozen_{false};
 
-	// a map from the back edge id to the index in the back_edges vector
-	std::map<std::size_t, std::size_t> te_id_to_idx_map_;
+	// bd::VG::get_folded of the vertex each tree vertex comes from, empty
+	// when the graph has no folded runs
+	std::vector<pt::idx_t> folded_;
 
 	/*
 	  a map from the edge id (in the spanning tree) to the index in the
@@ -207,14 +227,21 @@ class Tree
 
 	static const size_t root_node_index{}; // 0
 
-	std::size_t equiv_class_count_;
-
 public:
 	// --------------
 	// constructor(s)
 	// --------------
 	Tree(std::size_t size);
-	static Tree from_bd(const bd::VG &g);
+	/**
+	 * @param arena when given the vertices allocate the lists they own
+	 * until the tree is frozen from it, it must outlive the tree
+	 */
+	static Tree from_bd(const bd::VG &g, pa::Arena *arena = nullptr);
+	// vertices hold views into adj_ so a copy would point into the original
+	Tree(const Tree &) = delete;
+	Tree &operator=(const Tree &) = delete;
+	Tree(Tree &&) = default;
+	Tree &operator=(Tree &&) = default;
 
 	// ---------
 	// destructor(s)
@@ -244,52 +271,32 @@ public:
 	// returns a node index
 	// a set?
 
-	// takes a vertex index and returns pair:
-	//   first => backedge id
-	//   second =>  node idx of the target vertex
-	std::set<std::pair<std::size_t, std::size_t>>
-	get_obe_w_id(std::size_t vertex);
-	std::set<std::pair<std::size_t, std::size_t>>
-	get_ibe_w_id(std::size_t vertex);
-
-	// take a vertex index and return an edge id and the child node index
-	std::set<std::pair<std::size_t, std::size_t>>
-	get_children_w_id(std::size_t vertex);
-
-	// return edges that point to children of the vertex
-	[[deprecated("use get_child_edges_mut()")]]
-	std::vector<Edge> get_child_edges(pt::idx_t v_idx);
-	std::vector<Edge> get_child_edges_mut(pt::idx_t v_idx);
-	std::vector<pt::idx_t> get_child_edge_idxs(pt::idx_t v_idx) const;
-	// returns v_idxs of the children of the vertex
-	std::set<std::size_t> get_children(pt::idx_t v_idx) const;
+	[[nodiscard]] pv_cmp::span<const pt::idx_t>
+	get_child_edge_idxs(pt::idx_t v_idx) const;
+	// returns v_idxs of the children of the vertex, sorted
+	[[nodiscard]] pv_cmp::span<const pt::idx_t>
+	get_children(pt::idx_t v_idx) const;
 	pt::idx_t get_child_count(pt::idx_t v_idx) const;
+	// the run vertices folded into the graph vertex of v_idx
+	[[nodiscard]] pt::idx_t get_folded(pt::idx_t v_idx) const;
 
-	// get index of the  be in back_edges vector
-	std::set<std::size_t> get_obe_idxs(std::size_t vertex) const;
-	std::set<std::size_t> get_ibe_idxs(std::size_t vertex) const;
+	// get index of the  be in back_edges vector, sorted
+	[[nodiscard]] pv_cmp::span<const pt::idx_t>
+	get_obe_idxs(std::size_t vertex) const;
+	[[nodiscard]] pv_cmp::span<const pt::idx_t>
+	get_ibe_idxs(std::size_t vertex) const;
 
-	size_t list_size(std::size_t vertex);
 	size_t get_hi(std::size_t vertex);
 
 	bool is_desc(pt::idx_t a, pt::idx_t d) const;
 
-	/**
-	 * @brief get indexes of the vertices the obes from this vertex points
-	 * to (tgt/targets)
-	 */
-	[[deprecated("use get_obe_tgt_v_idxs()")]]
-	std::set<size_t>
-	get_obe(std::size_t vertex); // get backedge target indexes
-	std::set<pt::idx_t> get_obe_tgt_v_idxs(std::size_t v_idx) const;
+	// sorted and unique, the tree must be frozen
+	[[nodiscard]] pv_cmp::span<const pt::idx_t>
+	get_obe_tgt_v_idxs(std::size_t v_idx) const;
 
-	/**
-	 * @brief get sources of the vertices the ibes from this vertex points
-	 * from (srcs)
-	 */
-	[[deprecated("use get_ibe_src_v_idxs()")]]
-	std::set<size_t> get_ibe(std::size_t vertex);
-	std::set<pt::idx_t> get_ibe_src_v_idxs(std::size_t v_idx) const;
+	// sorted and unique, the tree must be frozen
+	[[nodiscard]] pv_cmp::span<const pt::idx_t>
+	get_ibe_src_v_idxs(std::size_t v_idx) const;
 
 	/**
 	 * @brief a reference to the tree edge given the index in the tree_edges
@@ -308,8 +315,6 @@ public:
 	 */
 	// const Edge& get_tree_edge_by_id(std::size_t edge_id) const;
 
-	std::size_t get_graph_edge_id(std::size_t tree_edge_id) const;
-
 	// std::size_t get_edge_idx(std::size_t edge_id) const;
 
 	// return reference to a back edge given the
@@ -321,6 +326,7 @@ public:
 	// backedge
 	BackEdge get_backedge_given_id(std::size_t backedge_id);
 
+	bool is_frozen() const;
 	bool is_root(std::size_t vertex) const;
 	bool is_leaf(std::size_t vertex) const;
 
@@ -349,9 +355,6 @@ public:
 
 	std::size_t get_sorted_g(std::size_t idx);
 
-	const std::map<std::size_t, std::pair<be_type_e, std::size_t>> &
-	get_g_edge_idx_map() const;
-
 	// -------
 	// setters
 	// -------
@@ -369,6 +372,13 @@ public:
 	void set_sort_g(std::size_t idx, std::size_t vertex);
 
 	void add_vertex(Vertex &&v);
+	/**
+	 * @brief pack the adjacency of every vertex into one CSR array
+	 *
+	 * call once the equivalence classes are set, no edges can be added
+	 * after
+	 */
+	void freeze();
 
 	// set the dfs number of a vertex
 	void set_dfs_num(std::size_t vertex, std::size_t dfs_num);
@@ -380,20 +390,6 @@ public:
 
 	void set_hi(std::size_t vertex, std::size_t val);
 
-	// vst
-	void concat_bracket_lists(std::size_t parent_vertex,
-				  std::size_t child_vertex);
-	void del_bracket(std::size_t vertex, std::size_t backedge_idx);
-	void push(std::size_t vertex, std::size_t backege_idx);
-
-	// get the bracket on top of the bracket list for v
-	Bracket &top(std::size_t vertex);
-
-	// return the current equivalence class count then increment it
-	std::size_t new_class();
-
-	BracketList &get_bracket_list(std::size_t vertex);
-
 	// ------------
 	// I/O
 	// ------------
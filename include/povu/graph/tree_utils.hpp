@@ -2,6 +2,7 @@
 #define PV_TREE_UTILS_HPP
 
 #include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
 #include <iostream>    // for basic_ostream, operator<<, cerr
 #include <map>	       // for map
 #include <string>      // for operator<<
@@ -41,19 +42,53 @@ struct BranchingMeta {
 // key is a vertex idx and value is the branching meta data
 using BranchDesc = std::map<pt::idx_t, BranchingMeta>;
 
+/**
+ * Range minimum queries over an array in constant time
+ *
+ * The array is cut into blocks of 64. A sparse table holds the position of
+ * the minimum of every run of 2^k blocks and, inside a block, each position
+ * has a mask of the positions that are the minimum of the block from them up
+ * to it. Memory is O(n). The array is not kept and has to be passed to query.
+ */
+class RMQ
+{
+	std::vector<std::uint64_t> masks_;
+	// level k starts at k * block_count_, the positions of the minima of
+	// the 2^k blocks starting at each block
+	std::vector<pt::idx_t> sparse_;
+	pt::idx_t block_count_{};
+
+	[[nodiscard]] pt::idx_t in_block(pt::idx_t l, pt::idx_t r) const;
+
+public:
+	// --------------
+	// constructor(s)
+	// --------------
+	RMQ() = default;
+	explicit RMQ(const std::vector<pt::idx_t> &a);
+
+	// ---------
+	// getter(s)
+	// ---------
+	// the position of the first minimum of @p a in [l, r]
+	[[nodiscard]] pt::idx_t query(const std::vector<pt::idx_t> &a,
+				      pt::idx_t l, pt::idx_t r) const;
+};
+
 struct tree_meta {
 	std::vector<pt::idx_t> E;
 	std::vector<pt::idx_t> D;
+	RMQ D_rmq; // over D, for find_lca
 
 	std::vector<pt::idx_t>
 		first; // idx is v_idx value is the first time it is seen in E
 	std::vector<pt::idx_t> lo;  // LoA
 	std::vector<pt::idx_t> HiD; // HiD
 
-	std::map<pt::idx_t, pt::idx_t>
-		pre; // idx is the pre-order the value is the v_idx
-	std::map<pt::idx_t, pt::idx_t>
-		post; // idx is the post-order the value is the v_idx
+	// idx is the pre-order (post-order) the value is the v_idx, pre and
+	// post orders share one counter so the other orders are INVALID_IDX
+	std::vector<pt::idx_t> pre;
+	std::vector<pt::idx_t> post;
 
 	// Gather all backedges
 	std::vector<pt::idx_t> B;
@@ -7,6 +7,8 @@
 #include <set>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include <liteseq/gfa.h>
 
@@ -90,7 +92,13 @@ public:
 
 class Ref
 {
-	const lq::ref *ref_ptr_; // pointer to the original liteseq ref
+	std::string tag_;
+	std::string sample_name_;
+	pt::id_t hap_id_{};
+	lq::ref_id_type id_type_{};
+	pt::id_t length_{};
+	// the arrays are owned by liteseq or by the mapping of a graph index
+	lq::ref_walk walk_{};
 
 	// make default constructor private
 	Ref() = default;
@@ -100,9 +108,28 @@ public:
 	// constructor(s)
 	// --------------
 	static Ref from_lq_ref(const lq::ref *r)
+	{
+		const char *t = lq::get_tag(r);
+		if (t == nullptr)
+			std::cerr << "Failed to get tag for ref\n";
+
+		return from_parts(t == nullptr ? "" : t,
+				  lq::get_sample_name(r), lq::get_hap_id(r),
+				  lq::get_ref_id_type(r), lq::get_hap_len(r),
+				  *r->walk);
+	}
+
+	static Ref from_parts(std::string tag, std::string sample_name,
+			      pt::id_t hap_id, lq::ref_id_type id_type,
+			      pt::id_t length, const lq::ref_walk &walk)
 	{
 		Ref ref;
-		ref.ref_ptr_ = r;
+		ref.tag_ = std::move(tag);
+		ref.sample_name_ = std::move(sample_name);
+		ref.hap_id_ = hap_id;
+		ref.id_type_ = id_type;
+		ref.length_ = length;
+		ref.walk_ = walk;
 		return ref;
 	}
 
@@ -110,25 +137,27 @@ public:
 	// getter(s)
 	// ---------
 	[[nodiscard]]
-	std::string tag() const
+	const std::string &tag() const
 	{
-		const char *t = lq::get_tag(this->ref_ptr_);
-		if (t == nullptr)
-			std::cerr << "Failed to get tag for ref\n";
-		return t;
+		return this->tag_;
 	}
 
 	[[nodiscard]]
 	pt::id_t get_hap_id() const
 	{
-		return lq::get_hap_id(this->ref_ptr_);
+		return this->hap_id_;
+	}
+
+	[[nodiscard]]
+	lq::ref_id_type get_id_type() const
+	{
+		return this->id_type_;
 	}
 
 	[[nodiscard]]
 	ref_format_e get_format() const
 	{
-		lq::ref_id_type rt = lq::get_ref_id_type(this->ref_ptr_);
-		if (rt == lq::ref_id_type::REF_ID_PANSN) {
+		if (this->id_type_ == lq::ref_id_type::REF_ID_PANSN) {
 			return ref_format_e::PANSN;
 		}
 		else {
@@ -137,25 +166,26 @@ public:
 	}
 
 	[[nodiscard]]
-	std::string get_sample_name() const
+	const std::string &get_sample_name() const
 	{
-		return lq::get_sample_name(this->ref_ptr_);
+		return this->sample_name_;
 	}
 
 	[[nodiscard]]
 	pt::id_t get_length() const
 	{
-		return lq::get_hap_len(this->ref_ptr_);
+		return this->length_;
+	}
+
+	[[nodiscard]]
+	const lq::ref_walk *get_walk() const
+	{
+		return &this->walk_;
 	}
 };
 
 class Refs
 {
-	lq::ref **refs_ptr_ptr{};
-
-	pt::idx_t ref_count_{};
-
-	// TODO we are storing this pointer twice. Let's not do that.
 	std::vector<Ref> refs_;
 
 	// sample name to ploidy metadata
@@ -188,13 +218,7 @@ public:
 	[[nodiscard]]
 	pt::id_t ref_count() const
 	{
-		return ref_count_;
-	}
-
-	[[nodiscard]]
-	const lq::ref *get_lq_ref_ptr(pt::idx_t ref_idx) const
-	{
-		return refs_ptr_ptr[ref_idx];
+		return static_cast<pt::id_t>(this->refs_.size());
 	}
 
 	[[nodiscard]]
@@ -265,8 +289,7 @@ public:
 	std::optional<pt::id_t> get_ref_id(std::string_view tag) const
 	{
 		for (pt::id_t ref_id{}; ref_id < this->ref_count(); ref_id++) {
-			const char *t = lq::get_tag(this->refs_ptr_ptr[ref_id]);
-			if (tag == t)
+			if (tag == this->refs_[ref_id].tag())
 				return ref_id;
 		}
 
@@ -280,9 +303,9 @@ public:
 	{
 		std::set<pt::id_t> in_sample;
 		for (pt::id_t ref_id{}; ref_id < this->ref_count(); ref_id++) {
-			const lq::ref *r = this->refs_ptr_ptr[ref_id];
-			const char *r_sn = lq::get_sample_name(r);
-			lq::ref_id_type rt = lq::get_ref_id_type(r);
+			const Ref &r = this->refs_[ref_id];
+			const std::string &r_sn = r.get_sample_name();
+			lq::ref_id_type rt = r.get_id_type();
 			if (rt == lq::ref_id_type::REF_ID_PANSN) {
 				if (r_sn == sample_name)
 					in_sample.insert(ref_id);
@@ -293,7 +316,7 @@ public:
 			}
 
 			// as a fallback, match using the tag
-			if (pu::is_prefix(sample_name, lq::get_tag(r)))
+			if (pu::is_prefix(sample_name, r.tag()))
 				in_sample.insert(ref_id);
 		}
 
@@ -303,9 +326,8 @@ public:
 	[[nodiscard]]
 	std::set<pt::id_t> get_shared_samples(pt::id_t ref_id) const
 	{
-		const lq::ref *r = this->refs_ptr_ptr[ref_id];
-		const char *sample_name = lq::get_sample_name(r);
-		return this->get_refs_in_sample(sample_name);
+		const Ref &r = this->refs_.at(ref_id);
+		return this->get_refs_in_sample(r.get_sample_name());
 	}
 
 	[[nodiscard]]
@@ -330,30 +352,30 @@ public:
 	// ---------
 	// setter(s)
 	// ---------
-	void add_all_refs(lq::ref **refs, pt::idx_t ref_count)
+	void add_ref(Ref r)
 	{
-		this->ref_count_ = ref_count;
-		this->refs_ptr_ptr = refs;
-		for (pt::idx_t ref_idx{}; ref_idx < ref_count; ++ref_idx) {
-			Ref ref = Ref::from_lq_ref(refs_ptr_ptr[ref_idx]);
-			this->refs_.emplace_back(ref);
-		}
+		const std::string &sn = r.get_sample_name();
+		if (r.get_format() == ref_format_e::PANSN) {
+			pt::u32 hap_id = r.get_hap_id();
 
-		for (const Ref &r : this->refs_) {
-			std::string sn = r.get_sample_name();
-			if (r.get_format() == ref_format_e::PANSN) {
-				pt::u32 hap_id = r.get_hap_id();
+			// add hap id to sample's ploidy meta
+			if (!pv_cmp::contains(this->sn2pm, sn))
+				this->sn2pm[sn] = ploidy_meta{};
 
-				// add hap id to sample's ploidy meta
-				if (!pv_cmp::contains(this->sn2pm, sn))
-					this->sn2pm[sn] = ploidy_meta{};
-
-				this->sn2pm[sn].value().add_hap_id(hap_id);
-			}
-			else {
-				this->sn2pm[sn] = std::nullopt;
-			}
+			this->sn2pm[sn].value().add_hap_id(hap_id);
+		}
+		else {
+			this->sn2pm[sn] = std::nullopt;
 		}
+
+		this->refs_.emplace_back(std::move(r));
+	}
+
+	void add_all_refs(lq::ref **refs, pt::idx_t ref_count)
+	{
+		this->refs_.reserve(this->refs_.size() + ref_count);
+		for (pt::idx_t ref_idx{}; ref_idx < ref_count; ++ref_idx)
+			this->add_ref(Ref::from_lq_ref(refs[ref_idx]));
 	}
 
 	void gen_genotype_metadata()
@@ -369,8 +391,8 @@ public:
 			const std::set<pt::id_t> &sample_refs =
 				this->get_shared_samples(ref_id);
 
-			const lq::ref *r = this->refs_ptr_ptr[ref_id];
-			const char *col_name = lq::get_sample_name(r);
+			const std::string &col_name =
+				this->refs_[ref_id].get_sample_name();
 
 			if (sample_refs.empty()) {
 				PL_ERR("No sample names found for ref_id {}",
@@ -44,10 +44,10 @@ broad_walk lineup(const bd::VG &g, const std::vector<pt::u32> &sorted_w,
 		unrolled.insert(it, es);
 	};
 
-	const lq::ref_walk *h_w = g.get_ref_vec(h_idx)->walk; // the hap walk
+	const lq::ref_walk *h_w = g.get_ref_walk(h_idx); // the hap walk
 	for (pt::u32 j{}; j < J; j++) {
 		pt::u32 v_id = sorted_w[j];
-		const std::vector<pt::u32> &positions =
+		pv_cmp::span<const pt::u32> positions =
 			g.get_vertex_ref_idxs(g.v_id_to_idx(v_id), h_idx);
 
 		for (pt::u32 i : positions) { // index in the hap walk
@@ -136,7 +136,7 @@ void gen_inv_recs(const bd::VG &g, const ist::st &it_,
 			for (const ist::alt &a : v.get_alts(alt_h_idx))
 				if (a.len == len)
 					alt_set.emplace_back(
-						g.get_ref_vec(a.h_idx)->walk,
+						g.get_ref_walk(a.h_idx),
 						a.h_idx, a.h_start, len);
 
 		return alt_set;
@@ -149,8 +149,7 @@ void gen_inv_recs(const bd::VG &g, const ist::st &it_,
 
 		for (auto &[len, alts] : v.get_same_len_alts()) {
 
-			const lq::ref_walk *ref_h_w =
-				g.get_ref_vec(ref_h_idx)->walk;
+			const lq::ref_walk *ref_h_w = g.get_ref_walk(ref_h_idx);
 
 			pt::u32 s = ref_h_start;
 			pt::u32 t = ref_h_start + len - 1;
@@ -170,7 +169,7 @@ void gen_inv_recs(const bd::VG &g, const ist::st &it_,
 							ref_h_w->v_ids[s], tc,
 							ref_h_w->v_ids[t]);
 
-			ia::hap_slice ref_sl = {g.get_ref_vec(ref_h_idx)->walk,
+			ia::hap_slice ref_sl = {g.get_ref_walk(ref_h_idx),
 						ref_h_idx, ref_h_start, len};
 			pt::u32 pos = ref_sl.comp_pos(ir::var_type_e::subr);
 
@@ -213,8 +212,7 @@ void gen_inv_recs(const bd::VG &g, const ist::st &it_,
 			//	     v.get_alts(alt_h_idx)) {
 			//		if (a.len == len) {
 			//			alt_set.emplace_back(
-			//				g.get_ref_vec(a.h_idx)
-			//					->walk,
+			//				g.get_ref_walk(a.h_idx),
 			//				a.h_idx, a.h_start,
 			//				len);
 			//		}
@@ -19,10 +19,10 @@ namespace povu::genomics::graph
  *
  *@param v the vertex
  *@param ve the vertex end
- *@return a set of edge indices
+ *@return a view of the edge indices
  */
-inline const std::set<pt::idx_t> edges_at_end(const bd::Vertex &v,
-					      pgt::v_end_e ve) noexcept
+inline pv_cmp::span<const pt::idx_t> edges_at_end(const bd::Vertex &v,
+						  pgt::v_end_e ve) noexcept
 {
 	return ve == pgt::v_end_e::l ? v.get_edges_l() : v.get_edges_r();
 }
@@ -120,7 +120,7 @@ ita::bfs::BfsTree comp_bfs_tree(const bd::VG &g, pvst::route_e route,
 
 		pgt::v_end_e ve = get_v_end(o, ve_dir);
 		const bd::Vertex &v = g.get_vertex_by_idx(v_idx);
-		const std::set<pt::idx_t> &nbr_edges = edges_at_end(v, ve);
+		pv_cmp::span<const pt::idx_t> nbr_edges = edges_at_end(v, ve);
 
 		for (pt::u32 e_idx : nbr_edges) {
 			const bd::Edge &e = g.get_edge(e_idx);
@@ -165,19 +165,16 @@ ita::bfs::BfsTree comp_bfs_tree(const bd::VG &g, pvst::route_e route,
 void find_laps(const bd::VG &g, pt::u32 h_idx, pt::id_t u, pt::id_t v,
 	       std::vector<pt::slice> &laps)
 {
-	std::vector<pt::u32> u_hap_idxs =
+	// the step index keeps these sorted
+	pv_cmp::span<const pt::u32> u_hap_idxs =
 		g.get_vertex_ref_idxs(g.v_id_to_idx(u), h_idx);
 
-	std::vector<pt::u32> v_hap_idxs =
+	pv_cmp::span<const pt::u32> v_hap_idxs =
 		g.get_vertex_ref_idxs(g.v_id_to_idx(v), h_idx);
 
 	if (u_hap_idxs.empty() || v_hap_idxs.empty())
 		return;
 
-	// sort
-	std::sort(u_hap_idxs.begin(), u_hap_idxs.end());
-	std::sort(v_hap_idxs.begin(), v_hap_idxs.end());
-
 	pt::u32 N = std::min((u_hap_idxs.size()), v_hap_idxs.size());
 
 	for (pt::u32 i{}; i < N; i++) {
@@ -217,8 +214,7 @@ std::list<pt::u32> gen_sort(const bd::VG &g, ir::RoV &rov,
 			if (dbg && !laps.empty())
 				std::cerr << "\n" << h_idx << "\t";
 
-			const liteseq::ref_walk *rw =
-				g.get_ref_vec(h_idx)->walk;
+			const liteseq::ref_walk *rw = g.get_ref_walk(h_idx);
 
 			for (const auto &lap : laps) {
 				auto [start, len] = lap.data();
@@ -309,7 +305,7 @@ std::list<pt::u32> gen_sort(const bd::VG &g, ir::RoV &rov,
 		// if (dbg && !laps.empty())
 		//	std::cerr << "->" << "\t";
 
-		const liteseq::ref_walk *rw = g.get_ref_vec(h_idx)->walk;
+		const liteseq::ref_walk *rw = g.get_ref_walk(h_idx);
 
 		for (const auto &lap : laps) {
 			auto [start, len] = lap.data();
@@ -414,7 +410,7 @@ std::list<pt::u32> gen_sort_old(const bd::VG &g, ir::RoV &rov,
 		if (dbg && !laps.empty())
 			std::cerr << "->" << "\t";
 
-		const liteseq::ref_walk *rw = g.get_ref_vec(h_idx)->walk;
+		const liteseq::ref_walk *rw = g.get_ref_walk(h_idx);
 
 		for (const auto &lap : laps) {
 			auto [start, len] = lap.data();
@@ -525,7 +521,7 @@ pt::status_t enum_walks(const bd::VG &g, pvst::route_e route, idx_or_t src,
 
 		pgt::v_end_e ve = get_v_end(o, ve_dir);
 		const bd::Vertex &v = g.get_vertex_by_idx(v_idx);
-		const std::set<pt::idx_t> &nbr_edges = edges_at_end(v, ve);
+		pv_cmp::span<const pt::idx_t> nbr_edges = edges_at_end(v, ve);
 
 		for (pt::u32 e_idx : nbr_edges) {
 			const bd::Edge &e = g.get_edge(e_idx);
@@ -596,8 +592,7 @@ pt::status_t find_walks(const bd::VG &g, ir::RoV &rov)
 			if (dbg && !laps.empty())
 				std::cerr << "\n" << h_idx << "\t";
 
-			const liteseq::ref_walk *rw =
-				g.get_ref_vec(h_idx)->walk;
+			const liteseq::ref_walk *rw = g.get_ref_walk(h_idx);
 
 			for (const auto &lap : laps) {
 				auto [start, len] = lap.data();
@@ -16,10 +16,10 @@ bool has_all_refs(const bd::VG &g, const std::set<pt::id_t> &to_call_ref_ids,
 		  pt::u32 s_v_idx, pt::u32 t_v_idx)
 {
 	for (pt::u32 r_idx : to_call_ref_ids) {
-		const std::vector<pt::idx_t> &s_idxs =
+		pv_cmp::span<const pt::idx_t> s_idxs =
 			g.get_vertex_ref_idxs(s_v_idx, r_idx);
 
-		const std::vector<pt::idx_t> &t_idxs =
+		pv_cmp::span<const pt::idx_t> t_idxs =
 			g.get_vertex_ref_idxs(t_v_idx, r_idx);
 
 		if (s_idxs.empty() || t_idxs.empty())
@@ -33,10 +33,10 @@ bool has_any_refs(const bd::VG &g, const std::set<pt::id_t> &to_call_ref_ids,
 		  pt::u32 s_v_idx, pt::u32 t_v_idx)
 {
 	for (pt::u32 r_idx : to_call_ref_ids) {
-		const std::vector<pt::idx_t> &s_idxs =
+		pv_cmp::span<const pt::idx_t> s_idxs =
 			g.get_vertex_ref_idxs(s_v_idx, r_idx);
 
-		const std::vector<pt::idx_t> &t_idxs =
+		pv_cmp::span<const pt::idx_t> t_idxs =
 			g.get_vertex_ref_idxs(t_v_idx, r_idx);
 
 		if (s_idxs.empty() || t_idxs.empty())
@@ -66,13 +66,12 @@ std::optional<pt::u32> find_vertex(const bd::VG &g, const pvst::Tree &pvst,
 	};
 
 	do {
-		const pvst::VertexBase *v =
-			pvst.get_vertex_const_ptr(pvst_v_idx);
+		const pvst::VertexBase &v = pvst.get_vertex(pvst_v_idx);
 
-		if (v->get_route_params() == std::nullopt)
+		if (v.get_route_params() == std::nullopt)
 			return std::nullopt;
 
-		auto [l, r, _] = v->get_route_params().value();
+		auto [l, r, _] = v.get_route_params().value();
 		auto [start_id, __] = l;
 		auto [stop_id, ___] = r;
 
@@ -116,16 +115,16 @@ std::set<pt::u32> color_pvst(const bd::VG &g, const pvst::Tree &pvst,
 		pt::u32 curr_pvst_v_idx = s.top();
 		s.pop();
 
-		const pvst::VertexBase *curr_v_ptr =
-			pvst.get_vertex_const_ptr(curr_pvst_v_idx);
+		const pvst::VertexBase &curr_v =
+			pvst.get_vertex(curr_pvst_v_idx);
 
-		if (pvst::to_clan(curr_v_ptr->get_fam()) ==
+		if (pvst::to_clan(curr_v.get_fam()) ==
 		    pvst::vc_e::subflubble)
 			continue;
 
 		// if the current vertex has route params
-		if (curr_v_ptr->get_route_params() != std::nullopt) {
-			auto [l, r, _] = curr_v_ptr->get_route_params().value();
+		if (curr_v.get_route_params() != std::nullopt) {
+			auto [l, r, _] = curr_v.get_route_params().value();
 			auto [start_id, __] = l;
 			auto [stop_id, ___] = r;
 
@@ -149,7 +148,7 @@ std::set<pt::u32> color_pvst(const bd::VG &g, const pvst::Tree &pvst,
 		}
 
 		// push children to stack
-		const std::vector<pt::idx_t> &children_idxs =
+		pv_cmp::span<const pt::idx_t> children_idxs =
 			pvst.get_children(curr_pvst_v_idx);
 
 		for (pt::idx_t c_idx : children_idxs)
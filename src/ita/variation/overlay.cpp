@@ -242,7 +242,7 @@ ia::hap_slice hap_sl_from_lap(const bd::VG &g, const ia::rov_boundaries &cxt,
 		     h_idx, cxt.to_string(), start, end, len);
 	}
 
-	return ia::hap_slice{g.get_ref_vec(h_idx)->walk, h_idx, start, len};
+	return ia::hap_slice{g.get_ref_walk(h_idx), h_idx, start, len};
 }
 
 std::optional<ia::hap_slice> hap_sl_from_lap_alt(const bd::VG &g,
@@ -301,7 +301,7 @@ std::optional<ia::hap_slice> hap_sl_from_lap_alt(const bd::VG &g,
 		     h_idx, cxt.to_string(), start, end, len);
 	}
 
-	return ia::hap_slice{g.get_ref_vec(h_idx)->walk, h_idx, start, len};
+	return ia::hap_slice{g.get_ref_walk(h_idx), h_idx, start, len};
 }
 
 ia::rov_boundaries gen_cxt(pt::u32 u, pt::u32 v, const ext_lap &lap)
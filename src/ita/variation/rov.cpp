@@ -142,9 +142,9 @@ bool pvst_vertex_overlaps_region(const bd::VG &g,
 	pt::idx_t end_v_idx = g.v_id_to_idx(end_v_id);
 
 	// Get step indices for these vertices on the reference
-	const std::vector<pt::idx_t> &start_steps =
+	pv_cmp::span<const pt::idx_t> start_steps =
 		g.get_vertex_ref_idxs(start_v_idx, ref_id);
-	const std::vector<pt::idx_t> &end_steps =
+	pv_cmp::span<const pt::idx_t> end_steps =
 		g.get_vertex_ref_idxs(end_v_idx, ref_id);
 
 	// If either vertex is not on this reference, skip
@@ -153,9 +153,8 @@ bool pvst_vertex_overlaps_region(const bd::VG &g,
 	}
 
 	// Get the reference walk to access genomic positions (loci)
-	const lq::ref *ref_ptr = g.get_ref_vec(ref_id);
-	const lq::ref_walk *ref_w = ref_ptr->walk;
-	pt::idx_t ref_step_count = lq::get_step_count(ref_ptr);
+	const lq::ref_walk *ref_w = g.get_ref_walk(ref_id);
+	pt::idx_t ref_step_count = ref_w->step_count;
 
 	// Check if any genomic position falls within the region
 	// Use actual genomic coordinates (loci) instead of step indices
@@ -189,7 +188,7 @@ void find_pvst_rovs(const bd::VG &g, const pvst::Tree &pvst,
 {
 
 	for (pt::u32 i : colored_vtxs) { // i is pvst_v_idx
-		const pvst::VertexBase *v = pvst.get_vertex_const_ptr(i);
+		const pvst::VertexBase *v = &pvst.get_vertex(i);
 
 		// Apply region filtering if specified
 		if (region.has_value() && region_ref_id.has_value()) {
@@ -135,15 +135,15 @@ std::optional<extension> extend_link(const bd::VG &g, const link_pair &lp,
 	//				? std::make_pair(ref_r_id, alt_r_id)
 	//				: std::make_pair(alt_r_id, ref_r_id);
 
-	const lq::ref_walk *ref_h_w = g.get_ref_vec(ref_r_id)->walk;
-	const lq::ref_walk *alt_h_w = g.get_ref_vec(alt_r_id)->walk;
+	const lq::ref_walk *ref_h_w = g.get_ref_walk(ref_r_id);
+	const lq::ref_walk *alt_h_w = g.get_ref_walk(alt_r_id);
 
 	// INFO("hee");
 	// std::cerr << "(ref: " << ref_h_w->v_ids[ref_link.idx] << ", ";
 	// std::cerr << "alt: " << alt_h_w->v_ids[alt_link.idx] << ")\n";
 
-	// const lq::ref_walk *f_ref_w = g.get_ref_vec(f_r_id)->walk;
-	// const lq::ref_walk *r_ref_w = g.get_ref_vec(r_r_id)->walk;
+	// const lq::ref_walk *f_ref_w = g.get_ref_walk(f_r_id);
+	// const lq::ref_walk *r_ref_w = g.get_ref_walk(r_r_id);
 
 	// auto [_, f_limit_left, f_limit_right, _] = fwd_link;
 	// auto [_, r_limit_left, r_limit_right, __] = rev_link;
@@ -300,18 +300,16 @@ void extend_links(const bd::VG &g, const chain_t &c, pt::u32 ref_r_id,
 std::vector<pt::slice> find_hap_slices(const bd::VG &g, pt::u32 h_idx,
 				       pt::u32 u_v_id, pt::u32 v_v_id)
 {
-	std::vector<pt::u32> u_positions =
+	// the step index keeps these sorted
+	pv_cmp::span<const pt::u32> u_positions =
 		g.get_vertex_ref_idxs(g.v_id_to_idx(u_v_id), h_idx);
 
-	std::vector<pt::u32> v_positions =
+	pv_cmp::span<const pt::u32> v_positions =
 		g.get_vertex_ref_idxs(g.v_id_to_idx(v_v_id), h_idx);
 
 	if (u_positions.empty() || v_positions.empty())
 		return {};
 
-	std::sort(u_positions.begin(), u_positions.end());
-	std::sort(v_positions.begin(), v_positions.end());
-
 	std::vector<pt::slice> slices;
 	pt::u32 N = std::min(u_positions.size(), v_positions.size());
 
@@ -331,8 +329,8 @@ std::vector<pt::slice> find_hap_slices(const bd::VG &g, pt::u32 h_idx,
 bool is_slice_in_hap(const bd::VG &g, pt::u32 ref_h_idx, pt::u32 ref_h_start,
 		     pt::u32 len, pt::u32 h_idx)
 {
-	const lq::ref_walk *h_w1 = g.get_ref_vec(ref_h_idx)->walk;
-	const lq::ref_walk *h_w2 = g.get_ref_vec(h_idx)->walk;
+	const lq::ref_walk *h_w1 = g.get_ref_walk(ref_h_idx);
+	const lq::ref_walk *h_w2 = g.get_ref_walk(h_idx);
 
 	pt::u32 s = ref_h_start;
 	pt::u32 N = ref_h_start + len;
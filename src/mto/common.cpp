@@ -1,6 +1,10 @@
 #include <cstddef> // for size_t
 #include <cstdlib> // for exit, EXIT_FAILURE
-#include <fstream> // for basic_ifstream, basic_istream, basic_ios
+#include <fcntl.h>    // for open, O_RDONLY
+#include <fstream>    // for basic_ifstream, basic_istream, basic_ios
+#include <sys/mman.h> // for mmap, munmap, madvise
+#include <sys/stat.h> // for fstat
+#include <unistd.h>   // for close
 
 #include "mto/common.hpp"
 
@@ -78,6 +82,90 @@ void fp_to_vector(const std::string &fp, std::vector<std::string> *v)
 	v->shrink_to_fit();
 }
 
+std::pair<povu::types::graph::id_or_t, povu::types::graph::id_or_t>
+str_to_id_or_t(const std::string &s)
+{
+	namespace pgt = povu::types::graph;
+
+	// find the first > or <
+	auto first = s.find_first_of("><");
+	auto last = s.find_last_of("><");
+
+	// substring based on first and last occurences and store them as size_t
+	pgt::id_or_t srt, end;
+
+	srt.v_id = std::stoull(s.substr(first + 1, last - first - 1));
+	srt.orientation =
+		s[first] == '>' ? pgt::or_e::forward : pgt::or_e::reverse;
+
+	end.v_id = std::stoull(s.substr(last + 1, s.size() - last - 1));
+	end.orientation =
+		s[last] == '>' ? pgt::or_e::forward : pgt::or_e::reverse;
+
+	return {srt, end};
+}
+
+MappedFile::MappedFile(const std::string &fp)
+{
+	int fd = ::open(fp.c_str(), O_RDONLY);
+	if (fd < 0)
+		return;
+
+	struct stat st;
+	if (::fstat(fd, &st) != 0) {
+		::close(fd);
+		return;
+	}
+
+	this->size_ = static_cast<std::size_t>(st.st_size);
+	if (this->size_ == 0) { // mmap rejects zero length mappings
+		::close(fd);
+		this->is_open_ = true;
+		return;
+	}
+
+	void *addr =
+		::mmap(nullptr, this->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // the mapping keeps its own reference to the file
+
+	if (addr == MAP_FAILED) {
+		this->size_ = 0;
+		return;
+	}
+
+	// the file is consumed front to back, let the kernel read ahead
+	::madvise(addr, this->size_, MADV_SEQUENTIAL);
+
+	this->data_ = static_cast<const char *>(addr);
+	this->is_open_ = true;
+}
+
+MappedFile::~MappedFile()
+{
+	if (this->data_ != nullptr)
+		::munmap(const_cast<char *>(this->data_), this->size_);
+}
+
+void MappedFile::advise_random_access() const
+{
+	if (this->data_ != nullptr)
+		::madvise(const_cast<char *>(this->data_), this->size_,
+			  MADV_RANDOM);
+}
+
+std::shared_ptr<povu::bidirected::LabelStore>
+gen_label_store(const std::shared_ptr<const MappedFile> &file, bool pack)
+{
+	namespace bd = povu::bidirected;
+
+	if (pack)
+		return std::make_shared<bd::LabelStore>(
+			bd::label_enc_e::packed);
+
+	file->advise_random_access();
+	return std::make_shared<bd::LabelStore>(file, file->view());
+}
+
 void create_dir_if_not_exists(const fs::path &out_dir)
 {
 	if (!fs::exists(out_dir)) {
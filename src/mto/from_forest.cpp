@@ -0,0 +1,107 @@
+#include "mto/from_forest.hpp"
+
+#include <cstring>   // for memcmp, memcpy
+#include <fstream>   // for ifstream
+#include <stdexcept> // for runtime_error, out_of_range
+
+#include "mto/from_pvst.hpp" // for from_bin
+
+namespace mto::from_forest
+{
+namespace mf = mto::forest;
+
+namespace
+{
+std::string invalid_forest_msg(const std::string &fp, const std::string &detail)
+{
+	return "Invalid forest archive '" + fp + "': " + detail;
+}
+} // namespace
+
+bool is_forest(const std::string &fp)
+{
+	std::ifstream in(fp, std::ios::binary);
+	char magic[sizeof(mf::MAGIC)] = {};
+	in.read(magic, sizeof(magic));
+
+	return in && std::memcmp(magic, mf::MAGIC, sizeof(mf::MAGIC)) == 0;
+}
+
+// --------------
+// constructor(s)
+// --------------
+
+Reader::Reader(const std::string &fp) : file_{fp}, fp_{fp}
+{
+	auto fail = [&](const std::string &detail)
+	{
+		throw std::runtime_error(invalid_forest_msg(fp, detail));
+	};
+
+	if (!this->file_.is_open())
+		fail("could not open file");
+
+	const std::uint64_t size = this->file_.size();
+	if (size < sizeof(mf::header_t) + sizeof(mf::footer_t))
+		fail("file is too small");
+
+	mf::header_t h{};
+	std::memcpy(&h, this->file_.data(), sizeof(h));
+	if (std::memcmp(h.magic, mf::MAGIC, sizeof(mf::MAGIC)) != 0)
+		fail("not a povu forest archive");
+
+	if (h.version != mf::VERSION)
+		fail("unsupported version " + std::to_string(h.version));
+
+	mf::footer_t f{};
+	std::memcpy(&f, this->file_.data() + size - sizeof(f), sizeof(f));
+	if (std::memcmp(f.magic, mf::MAGIC, sizeof(mf::MAGIC)) != 0)
+		fail("file is truncated or was not finished");
+
+	const std::uint64_t index_end = size - sizeof(f);
+	if (f.index_offset < sizeof(h) || f.index_offset > index_end ||
+	    f.index_offset % 8 != 0 ||
+	    f.entry_count != (index_end - f.index_offset) / sizeof(mf::entry_t))
+		fail("bad index");
+
+	this->entries_ = reinterpret_cast<const mf::entry_t *>(
+		this->file_.data() + f.index_offset);
+	this->entry_count_ = f.entry_count;
+
+	for (std::size_t i{}; i < this->entry_count_; ++i) {
+		const mf::entry_t &e = this->entries_[i];
+		if (e.offset < sizeof(h) || e.length > f.index_offset ||
+		    e.offset > f.index_offset - e.length)
+			fail("tree " + std::to_string(i) + " is out of bounds");
+	}
+
+	// trees are read in any order
+	this->file_.advise_random_access();
+}
+
+// ---------
+// getter(s)
+// ---------
+
+std::size_t Reader::size() const
+{
+	return this->entry_count_;
+}
+
+std::uint64_t Reader::component_id(std::size_t i) const
+{
+	return this->entries_[i].component_id;
+}
+
+pvst::Tree Reader::read(std::size_t i) const
+{
+	if (i >= this->entry_count_)
+		throw std::out_of_range("Tree index out of range");
+
+	const mf::entry_t &e = this->entries_[i];
+	std::string_view bytes{this->file_.data() + e.offset, e.length};
+
+	return mto::from_pvst::from_bin(
+		bytes, this->fp_ + ":" + std::to_string(e.component_id));
+}
+} // namespace mto::from_forest
@@ -1,18 +1,25 @@
+#include <algorithm> // for adjacent_find, is_sorted, stable_sort, lower_bound
+#include <array>     // for array
+#include <charconv>  // for from_chars
 // #include <chrono>	 // for milliseconds
 #include <cstddef>	 // for size_t
-#include <fstream>	 // for ifstream
+#include <cstring>	 // for memchr
+#include <memory>	 // for make_shared, shared_ptr
 #include <liteseq/gfa.h> // for gfa_config, gfa...
 // #include <optional>	 // for optional
-#include <stdexcept> // for runtime_error
-#include <string>    // for basic_string
-#include <thread>    // for thread, sleep_for
-
-#include <liteseq/refs.h> // for get_step_count
+#include <stdexcept>   // for runtime_error
+#include <string>      // for basic_string
+#include <string_view> // for string_view
+#include <utility>     // for pair
+#include <vector>      // for vector
 
+#include "mto/common.hpp" // for MappedFile
 #include "mto/from_gfa.hpp"
+#include "mto/from_index.hpp" // for is_index, to_bd
 
 #include "povu/common/core.hpp" // for pt, idx_t, id_t
 #include "povu/common/log.hpp"	// for WARN
+#include "povu/common/thread.hpp" // for thread_pool, task_group
 #include "povu/graph/types.hpp" // for v_end_e
 
 namespace mto::from_gfa
@@ -25,23 +32,53 @@ namespace pgt = povu::types::graph;
 
 namespace
 {
+namespace mc = mto::common;
+namespace pth = povu::thread;
+
 std::string invalid_gfa_msg(const std::string &gfa_fp,
 			    const std::string &detail)
 {
 	return "Invalid GFA '" + gfa_fp + "': " + detail;
 }
 
-void validate_segment_line(const std::string &gfa_fp, const std::string &line,
-			   std::size_t line_no)
+/**
+ * an S record as it appears in the mapped file, the views are only valid
+ * while the mapping is alive
+ */
+struct segment_rec_t {
+	std::string_view name;
+	std::string_view seq;
+};
+
+/**
+ * an L record with sides already resolved i.e. the side of each vertex
+ * the edge is incident with
+ */
+struct link_rec_t {
+	pt::id_t v1_id;
+	pgt::v_end_e v1_end;
+	pt::id_t v2_id;
+	pgt::v_end_e v2_end;
+};
+
+struct gfa_recs_t {
+	std::vector<std::pair<pt::id_t, std::string_view>> segments;
+	std::vector<link_rec_t> links;
+	// only the S records are read, liteseq parses the rest on the refs path
+	bool segments_only{false};
+};
+
+segment_rec_t validate_segment_line(const std::string &gfa_fp,
+				    std::string_view line, std::size_t line_no)
 {
 	const std::size_t first_tab = line.find('\t');
-	if (first_tab == std::string::npos)
+	if (first_tab == std::string_view::npos)
 		throw std::runtime_error(invalid_gfa_msg(
 			gfa_fp, "S record on line " + std::to_string(line_no) +
 					" is missing a segment id and sequence"));
 
 	const std::size_t second_tab = line.find('\t', first_tab + 1);
-	if (second_tab == std::string::npos)
+	if (second_tab == std::string_view::npos)
 		throw std::runtime_error(invalid_gfa_msg(
 			gfa_fp, "S record on line " + std::to_string(line_no) +
 					" is missing a sequence"));
@@ -52,20 +89,178 @@ void validate_segment_line(const std::string &gfa_fp, const std::string &line,
 		throw std::runtime_error(invalid_gfa_msg(
 			gfa_fp, "S record on line " + std::to_string(line_no) +
 					" has an empty sequence"));
+
+	return {line.substr(first_tab + 1, second_tab - first_tab - 1),
+		line.substr(seq_begin, seq_end == std::string_view::npos
+					       ? std::string_view::npos
+					       : seq_end - seq_begin)};
 }
 
-void validate_gfa_for_liteseq(const std::string &gfa_fp)
+pt::id_t parse_segment_id(const std::string &gfa_fp, std::string_view name,
+			  char rec_type, std::size_t line_no)
 {
-	std::ifstream in(gfa_fp);
-	if (!in)
-		throw std::runtime_error(
-			invalid_gfa_msg(gfa_fp, "could not open file"));
+	pt::id_t v_id{};
+	const char *last = name.data() + name.size();
+	auto [ptr, ec] = std::from_chars(name.data(), last, v_id);
+	if (name.empty() || ec != std::errc() || ptr != last)
+		throw std::runtime_error(invalid_gfa_msg(
+			gfa_fp, std::string(1, rec_type) + " record on line " +
+					std::to_string(line_no) +
+					" has a non-numeric segment id '" +
+					std::string(name) + "'"));
+
+	return v_id;
+}
+
+/**
+ * Split the first columns of @p line at tabs into @p cols, returns the
+ * number of columns found, at most cols.size()
+ */
+template <std::size_t N>
+std::size_t split_cols(std::string_view line,
+		       std::array<std::string_view, N> &cols)
+{
+	std::size_t col_count{};
+	std::size_t pos{};
+	while (col_count < N && pos <= line.size()) {
+		std::size_t tab = line.find('\t', pos);
+		if (tab == std::string_view::npos)
+			tab = line.size();
+		cols[col_count++] = line.substr(pos, tab - pos);
+		pos = tab + 1;
+	}
+
+	return col_count;
+}
+
+link_rec_t parse_link_line(const std::string &gfa_fp, std::string_view line,
+			   std::size_t line_no)
+{
+	// L <from> <from orient> <to> <to orient> [overlap] ...
+	std::array<std::string_view, 5> cols;
+	const std::size_t col_count = split_cols(line, cols);
+
+	auto to_side = [&](std::string_view o, bool is_from) -> pgt::v_end_e
+	{
+		if (o.size() != 1 || (o[0] != '+' && o[0] != '-'))
+			throw std::runtime_error(invalid_gfa_msg(
+				gfa_fp, "L record on line " +
+						std::to_string(line_no) +
+						" has an invalid orientation"));
+
+		// an edge leaves the from segment on its right side when
+		// forward and enters the to segment on its left side
+		bool fwd = o[0] == '+';
+		return fwd == is_from ? pgt::v_end_e::r : pgt::v_end_e::l;
+	};
+
+	if (col_count < cols.size())
+		throw std::runtime_error(invalid_gfa_msg(
+			gfa_fp, "L record on line " + std::to_string(line_no) +
+					" has fewer than 5 columns"));
+
+	return {parse_segment_id(gfa_fp, cols[1], 'L', line_no),
+		to_side(cols[2], true),
+		parse_segment_id(gfa_fp, cols[3], 'L', line_no),
+		to_side(cols[4], false)};
+}
+
+void validate_path_line(const std::string &gfa_fp, std::string_view line,
+			std::size_t line_no)
+{
+	// P <name> <id><+|->,<id><+|->,... [overlaps]
+	std::array<std::string_view, 3> cols;
+	auto fail = [&](const std::string &what)
+	{
+		throw std::runtime_error(invalid_gfa_msg(
+			gfa_fp, "P record on line " + std::to_string(line_no) +
+					" " + what));
+	};
+
+	if (split_cols(line, cols) < 3 || cols[1].empty())
+		fail("is missing a path name or segments");
+
+	std::string_view segs = cols[2];
+	if (segs.empty())
+		fail("has no segments");
+
+	for (std::size_t pos{}; pos <= segs.size();) {
+		std::size_t comma = segs.find(',', pos);
+		if (comma == std::string_view::npos)
+			comma = segs.size();
+
+		std::string_view step = segs.substr(pos, comma - pos);
+		if (step.size() < 2 || (step.back() != '+' && step.back() != '-'))
+			fail("has an invalid orientation");
+
+		step.remove_suffix(1);
+		parse_segment_id(gfa_fp, step, 'P', line_no);
+		pos = comma + 1;
+	}
+}
+
+void validate_walk_line(const std::string &gfa_fp, std::string_view line,
+			std::size_t line_no)
+{
+	// W <sample> <hap idx> <seq id> <start> <end> <walk>
+	std::array<std::string_view, 7> cols;
+	auto fail = [&](const std::string &what)
+	{
+		throw std::runtime_error(invalid_gfa_msg(
+			gfa_fp, "W record on line " + std::to_string(line_no) +
+					" " + what));
+	};
+
+	if (split_cols(line, cols) < 7 || cols[1].empty() || cols[3].empty())
+		fail("has fewer than 7 columns");
+
+	std::string_view walk = cols[6];
+	if (walk.empty())
+		fail("has no segments");
+
+	for (std::size_t pos{}; pos < walk.size();) {
+		if (walk[pos] != '>' && walk[pos] != '<')
+			fail("has an invalid orientation");
+
+		std::size_t next = walk.find_first_of("<>", pos + 1);
+		if (next == std::string_view::npos)
+			next = walk.size();
 
-	std::string line;
-	std::size_t line_no = 1;
-	while (std::getline(in, line)) {
+		parse_segment_id(gfa_fp, walk.substr(pos + 1, next - pos - 1),
+				 'W', line_no);
+		pos = next;
+	}
+}
+
+/**
+ * Walk a run of whole GFA lines once.
+ *
+ * Every record is validated; when @p recs is not null S and L records are
+ * also collected so that the graph can be built without reading the file
+ * again. With recs->segments_only only the S records are read. Newlines and tabs are located with memchr which libc vectorizes.
+ *
+ * @param [in] first_line_no line number of the first line in @p gfa
+ * @return the number of lines scanned
+ */
+std::size_t scan_gfa(const std::string &gfa_fp, std::string_view gfa,
+		     std::size_t first_line_no, gfa_recs_t *recs)
+{
+	const char *curr = gfa.data();
+	const char *end = gfa.data() + gfa.size();
+	std::size_t line_no = first_line_no;
+	const bool all_recs = recs == nullptr || !recs->segments_only;
+
+	while (curr < end) {
+		const char *nl = static_cast<const char *>(
+			std::memchr(curr, '\n', end - curr));
+		const char *line_end = nl == nullptr ? end : nl;
+
+		std::string_view line(curr, line_end - curr);
 		if (!line.empty() && line.back() == '\r')
-			line.pop_back();
+			line.remove_suffix(1);
+
+		curr = line_end + 1;
+
 		if (line.empty()) {
 			++line_no;
 			continue;
@@ -73,13 +268,30 @@ void validate_gfa_for_liteseq(const std::string &gfa_fp)
 
 		switch (line.front()) {
 		case 'H':
-		case 'L':
+			break;
 		case 'P':
+			if (all_recs)
+				validate_path_line(gfa_fp, line, line_no);
+			break;
 		case 'W':
+			if (all_recs)
+				validate_walk_line(gfa_fp, line, line_no);
 			break;
-		case 'S':
-			validate_segment_line(gfa_fp, line, line_no);
+		case 'L':
+			if (recs != nullptr && all_recs)
+				recs->links.push_back(
+					parse_link_line(gfa_fp, line, line_no));
+			break;
+		case 'S': {
+			segment_rec_t s =
+				validate_segment_line(gfa_fp, line, line_no);
+			if (recs != nullptr)
+				recs->segments.emplace_back(
+					parse_segment_id(gfa_fp, s.name, 'S',
+							 line_no),
+					s.seq);
 			break;
+		}
 		default:
 			throw std::runtime_error(invalid_gfa_msg(
 				gfa_fp,
@@ -92,9 +304,239 @@ void validate_gfa_for_liteseq(const std::string &gfa_fp)
 		++line_no;
 	}
 
-	if (in.bad())
-		throw std::runtime_error(
-			invalid_gfa_msg(gfa_fp, "could not read file"));
+	return line_no - first_line_no;
+}
+
+/**
+ * Split the mapping into at most @p chunk_count runs of whole lines
+ */
+std::vector<std::string_view> chunk_at_lines(std::string_view gfa,
+					     std::size_t chunk_count)
+{
+	// below this a chunk is not worth a task
+	constexpr std::size_t MIN_CHUNK_BYTES = 1 << 20;
+
+	chunk_count = std::max<std::size_t>(
+		1, std::min(chunk_count, gfa.size() / MIN_CHUNK_BYTES));
+
+	std::vector<std::string_view> chunks;
+	chunks.reserve(chunk_count);
+
+	std::size_t begin{};
+	for (std::size_t i{1}; i <= chunk_count && begin < gfa.size(); ++i) {
+		std::size_t end = gfa.size();
+		if (i < chunk_count) {
+			std::size_t nl =
+				gfa.find('\n', (gfa.size() / chunk_count) * i);
+			end = nl == std::string_view::npos
+				      ? gfa.size()
+				      : std::max(begin, nl + 1);
+		}
+
+		chunks.push_back(gfa.substr(begin, end - begin));
+		begin = end;
+	}
+
+	return chunks;
+}
+
+/**
+ * Scan the mapped GFA with one task per chunk of lines.
+ *
+ * Chunks are parsed into their own buffers and then appended in file order so
+ * the result is identical to a serial scan. Line numbers are only known once
+ * every earlier chunk has been counted, so the first failing chunk is scanned
+ * again with its global line number to report the same error a serial scan
+ * would.
+ */
+void scan_gfa_parallel(const std::string &gfa_fp, std::string_view gfa,
+		       std::size_t thread_count, gfa_recs_t *recs)
+{
+	std::vector<std::string_view> chunks =
+		chunk_at_lines(gfa, thread_count);
+	const std::size_t N = chunks.size();
+
+	if (N <= 1) {
+		scan_gfa(gfa_fp, gfa, 1, recs);
+		return;
+	}
+
+	std::vector<gfa_recs_t> chunk_recs(recs != nullptr ? N : 0);
+	for (gfa_recs_t &r : chunk_recs)
+		r.segments_only = recs->segments_only;
+	std::vector<std::size_t> line_counts(N, 0);
+	std::vector<char> failed(N, 0);
+
+	{
+		pth::thread_pool pool(std::min(thread_count, N));
+		pth::task_group tg(pool);
+		for (std::size_t i{}; i < N; ++i) {
+			tg.run(
+				[&, i]()
+				{
+					gfa_recs_t *r = recs != nullptr
+								? &chunk_recs[i]
+								: nullptr;
+					try {
+						line_counts[i] =
+							scan_gfa(gfa_fp,
+								 chunks[i], 1,
+								 r);
+					}
+					catch (const std::runtime_error &) {
+						failed[i] = 1;
+					}
+				});
+		}
+		tg.wait();
+	}
+
+	for (std::size_t i{}, line_no{1}; i < N; line_no += line_counts[i++]) {
+		if (!failed[i])
+			continue;
+
+		gfa_recs_t scratch;
+		scan_gfa(gfa_fp, chunks[i], line_no,
+			 recs != nullptr ? &scratch : nullptr);
+	}
+
+	if (recs == nullptr)
+		return;
+
+	std::size_t seg_count{};
+	std::size_t link_count{};
+	for (const gfa_recs_t &r : chunk_recs) {
+		seg_count += r.segments.size();
+		link_count += r.links.size();
+	}
+
+	recs->segments.reserve(seg_count);
+	recs->links.reserve(link_count);
+	for (gfa_recs_t &r : chunk_recs) {
+		recs->segments.insert(recs->segments.end(),
+				      r.segments.begin(), r.segments.end());
+		recs->links.insert(recs->links.end(), r.links.begin(),
+				   r.links.end());
+		r = gfa_recs_t{}; // release the chunk buffers early
+	}
+}
+
+// sort the segments by id unless they already are
+void sort_segments(gfa_recs_t *recs)
+{
+	auto by_id = [](const auto &a, const auto &b)
+	{
+		return a.first < b.first;
+	};
+
+	std::vector<std::pair<pt::id_t, std::string_view>> &segs =
+		recs->segments;
+	if (!std::is_sorted(segs.begin(), segs.end(), by_id))
+		std::stable_sort(segs.begin(), segs.end(), by_id);
+}
+
+/** the sequence of segment @p v_id, empty when there is no such segment */
+std::string_view find_seq(const gfa_recs_t &recs, pt::id_t v_id)
+{
+	auto it = std::lower_bound(recs.segments.begin(), recs.segments.end(),
+				   v_id, [](const auto &s, pt::id_t id)
+				   { return s.first < id; });
+
+	return it == recs.segments.end() || it->first != v_id
+		       ? std::string_view()
+		       : it->second;
+}
+
+/**
+ * Number of the first line of @p gfa that @p is_match accepts, 0 if none.
+ *
+ * The records do not keep their line numbers, so a record found invalid
+ * only after the scan is located again with this.
+ */
+template <typename F> std::size_t find_line(std::string_view gfa, F is_match)
+{
+	std::size_t line_no{1};
+	for (std::size_t pos{}; pos < gfa.size(); ++line_no) {
+		std::size_t nl = gfa.find('\n', pos);
+		if (nl == std::string_view::npos)
+			nl = gfa.size();
+
+		std::string_view line = gfa.substr(pos, nl - pos);
+		if (!line.empty() && line.back() == '\r')
+			line.remove_suffix(1);
+
+		if (is_match(line))
+			return line_no;
+
+		pos = nl + 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Check the segment ids that a scan cannot, because the records they are in
+ * are valid on their own, @p recs must be sorted
+ */
+void validate_segment_ids(const std::string &gfa_fp, std::string_view gfa,
+			  const gfa_recs_t &recs)
+{
+	if (recs.segments.empty())
+		throw std::runtime_error(invalid_gfa_msg(
+			gfa_fp, "no S records, the graph has no vertices"));
+
+	const auto &segs = recs.segments;
+	auto dup = std::adjacent_find(segs.begin(), segs.end(),
+				      [](const auto &a, const auto &b)
+				      { return a.first == b.first; });
+	if (dup != segs.end()) {
+		// the sort is stable, the second S record of the id is invalid
+		const pt::id_t dup_id = dup->first;
+		std::size_t seen{};
+		auto is_dup = [&](std::string_view line)
+		{
+			if (line.empty() || line.front() != 'S')
+				return false;
+
+			std::string_view name =
+				validate_segment_line(gfa_fp, line, 0).name;
+			pt::id_t v_id = parse_segment_id(gfa_fp, name, 'S', 0);
+			return v_id == dup_id && seen++ == 1;
+		};
+		std::size_t line_no = find_line(gfa, is_dup);
+
+		throw std::runtime_error(invalid_gfa_msg(
+			gfa_fp, "S record on line " + std::to_string(line_no) +
+					" repeats segment id " +
+					std::to_string(dup_id)));
+	}
+
+	// S records always have a sequence
+	auto is_segment = [&](pt::id_t v_id)
+	{
+		return !find_seq(recs, v_id).empty();
+	};
+
+	for (std::size_t i{}; i < recs.links.size(); ++i) {
+		const link_rec_t &l = recs.links[i];
+		const pt::id_t v_id = is_segment(l.v1_id) ? l.v2_id : l.v1_id;
+		if (is_segment(v_id))
+			continue;
+
+		// the links are kept in file order, this is the ith L record
+		std::size_t seen{};
+		auto is_link = [&](std::string_view line)
+		{
+			return !line.empty() && line.front() == 'L' &&
+			       seen++ == i;
+		};
+		std::size_t line_no = find_line(gfa, is_link);
+
+		throw std::runtime_error(invalid_gfa_msg(
+			gfa_fp, "L record on line " + std::to_string(line_no) +
+					" refers to missing segment " +
+					std::to_string(v_id)));
+	}
 }
 
 void validate_liteseq_result(const std::string &gfa_fp, lq::gfa_props *gfa)
@@ -111,21 +553,80 @@ void validate_liteseq_result(const std::string &gfa_fp, lq::gfa_props *gfa)
 		throw std::runtime_error(
 			invalid_gfa_msg(gfa_fp, "liteseq returned no vertices"));
 }
+
+void populate_tips(bd::VG &vg, const core::config &app_config)
+{
+	for (std::size_t v_idx{}; v_idx < vg.vtx_count(); ++v_idx) {
+		const bd::Vertex &v = vg.get_vertex_by_idx(v_idx);
+
+		// TODO: [c] improve logic on handling isolated vertices
+		if (v.get_edges_l().empty() && v.get_edges_r().empty()) {
+			if (app_config.verbosity() > 2)
+				WARN("isolated vertex {}", v.id());
+			vg.add_tip(v.id(), pgt::v_end_e::l);
+		}
+		else if (v.get_edges_l().empty()) {
+			vg.add_tip(v.id(), pgt::v_end_e::l);
+		}
+		else if (v.get_edges_r().empty()) {
+			vg.add_tip(v.id(), pgt::v_end_e::r);
+		}
+	}
+}
+
+/**
+ * Build the graph straight from the mapped file without going through
+ * liteseq. Only possible when references are not requested because the
+ * reference walks are owned by liteseq.
+ */
+bd::VG *native_to_bd(const std::string &gfa_fp,
+		     const std::shared_ptr<const mc::MappedFile> &gfa_file,
+		     const core::config &app_config)
+{
+	gfa_recs_t recs;
+	scan_gfa_parallel(gfa_fp, gfa_file->view(), app_config.thread_count(),
+			  &recs);
+
+	// liteseq hands out vertices in ascending id order, keep that order
+	sort_segments(&recs);
+	validate_segment_ids(gfa_fp, gfa_file->view(), recs);
+
+	auto *vg = new bd::VG(recs.segments.size(), recs.links.size(), 0);
+
+	const bool with_labels = app_config.inc_vtx_labels();
+	if (with_labels) {
+		vg->set_label_store(mc::gen_label_store(
+			gfa_file, app_config.pack_vtx_labels()));
+		vg->get_label_store()->reserve(recs.segments.size());
+	}
+
+	for (auto &[v_id, seq] : recs.segments)
+		vg->add_vertex(v_id, with_labels ? seq : std::string_view());
+
+	for (const link_rec_t &l : recs.links)
+		vg->add_edge(l.v1_id, l.v1_end, l.v2_id, l.v2_end);
+
+	populate_tips(*vg, app_config);
+	vg->freeze();
+
+	return vg;
+}
 } // namespace
 
 inline lq::gfa_config gen_lq_conf(const core::config &app_config,
-				  std::string &gfa_fp)
+				  const std::string &gfa_fp)
 {
-	gfa_fp = app_config.get_input_gfa();
 	// pt::idx_t ref_count = 0;
 
 	// bool read_all_refs =
 	//	app_config.inc_refs() && app_config.inc_vtx_labels();
 
+	// labels are always served from the mapping, never from liteseq, which
+	// would otherwise keep a copy of every sequence for the graph's life
 	lq::gfa_config_cpp lq_conf(
-		gfa_fp.c_str(),		     // file path
-		app_config.inc_vtx_labels(), // include vertex labels
-		app_config.inc_refs()	     // include references
+		gfa_fp.c_str(),	      // file path
+		false,		      // include vertex labels
+		app_config.inc_refs() // include references
 	);
 
 	return lq_conf;
@@ -147,33 +648,39 @@ bd::VG *to_bd(const core::config &app_config)
 	//	indicators::option::PostfixText{"Preparing GFA..."});
 	// set_progress_bar_ind(&prep_bar);
 
-	/* initialize a liteseq gfa */
-	std::string gfa_fp;
-	lq::gfa_config conf = gen_lq_conf(app_config, gfa_fp);
-	lq::gfa_props *gfa = nullptr;
-	validate_gfa_for_liteseq(gfa_fp);
+	std::string gfa_fp = app_config.get_input_gfa();
 
-	std::thread get_gfa_async(
-		[&]()
-		{
-			gfa = lq::gfa_new(&conf);
-			// if (show_prog) {
-			//	prep_bar.set_option(
-			//		indicators::option::PostfixText{
-			//			"GFA prepared."});
-			//	prep_bar.mark_as_completed();
-			// }
-		});
+	if (mto::from_index::is_index(gfa_fp))
+		return mto::from_index::to_bd(gfa_fp, app_config);
 
-	// if (show_prog) {
-	//	while (!prep_bar.is_completed()) {
-	//		prep_bar.tick();
-	//		std::this_thread::sleep_for(
-	//			std::chrono::milliseconds(100));
-	//	}
-	// }
+	/* validate (and when possible build) from a single mapped read */
+	auto gfa_file = std::make_shared<const mc::MappedFile>(gfa_fp);
+	if (!gfa_file->is_open())
+		throw std::runtime_error(
+			invalid_gfa_msg(gfa_fp, "could not open file"));
+
+	if (!app_config.inc_refs())
+		return native_to_bd(gfa_fp, gfa_file, app_config);
+
+	/*
+	  the refs come from liteseq, ita and zien read the lq::ref walks it
+	  owns, so liteseq parses and validates the records here. The labels
+	  are taken from the mapping so that the graph does not hold a copy of
+	  them, only that needs a scan of its own and it reads the S records
+	  alone, the P and W lines it skips are the bulk of a pangenome GFA
+	*/
+	const bool with_labels = app_config.inc_vtx_labels();
+	gfa_recs_t segs;
+	segs.segments_only = true;
+	if (with_labels) {
+		scan_gfa_parallel(gfa_fp, gfa_file->view(),
+				  app_config.thread_count(), &segs);
+		sort_segments(&segs);
+	}
 
-	get_gfa_async.join();
+	/* initialize a liteseq gfa */
+	lq::gfa_config conf = gen_lq_conf(app_config, gfa_fp);
+	lq::gfa_props *gfa = lq::gfa_new(&conf);
 	validate_liteseq_result(gfa_fp, gfa);
 
 	pt::idx_t vtx_count = gfa->vtx_arr_size;
@@ -182,6 +689,11 @@ bd::VG *to_bd(const core::config &app_config)
 
 	/* initialize a povu bidirected graph */
 	auto vg = new bd::VG(gfa); // vg is bd::VG *
+	if (with_labels) {
+		vg->set_label_store(mc::gen_label_store(
+			gfa_file, app_config.pack_vtx_labels()));
+		vg->get_label_store()->reserve(segs.segments.size());
+	}
 
 	/* set up progress bars */
 	// ProgressBar vtx_bar{option::Stream{std::cerr}};
@@ -202,15 +714,14 @@ bd::VG *to_bd(const core::config &app_config)
 			continue;
 
 		std::size_t v_id = v->id;
-		if (app_config.inc_vtx_labels() && v->seq == nullptr)
+		std::string_view label =
+			with_labels ? find_seq(segs, v_id) : std::string_view();
+		if (with_labels && label.empty())
 			throw std::runtime_error(invalid_gfa_msg(
 				gfa_fp,
 				"S record for segment " + std::to_string(v_id) +
 					" has no sequence"));
 
-		std::string label = app_config.inc_vtx_labels()
-					    ? std::string(v->seq)
-					    : std::string();
 		vg->add_vertex(v_id, label);
 	}
 
@@ -245,36 +756,13 @@ bd::VG *to_bd(const core::config &app_config)
 	/* refs */
 	if (app_config.inc_refs()) {
 		vg->add_all_refs(gfa->refs, ref_count);
-
-		for (pt::idx_t ref_idx{}; ref_idx < ref_count; ref_idx++) {
-			lq::ref *ref = lq::get_ref(gfa, ref_idx);
-			pt::idx_t N = lq::get_step_count(ref);
-			for (pt::idx_t step_idx{}; step_idx < N; step_idx++) {
-				pt::id_t v_id = ref->walk->v_ids[step_idx];
-				vg->set_vtx_ref_idx(v_id, ref_idx, step_idx);
-			}
-		}
-
+		vg->gen_vertex_step_index(app_config.thread_count());
 		vg->gen_genotype_metadata();
 	}
 
 	/* populate tips */
-	for (std::size_t v_idx{}; v_idx < vg->vtx_count(); ++v_idx) {
-		const bd::Vertex &v = vg->get_vertex_by_idx(v_idx);
-
-		// TODO: [c] improve logic on handling isolated vertices
-		if (v.get_edges_l().empty() && v.get_edges_r().empty()) {
-			if (app_config.verbosity() > 2)
-				WARN("isolated vertex {}", v.id());
-			vg->add_tip(v.id(), pgt::v_end_e::l);
-		}
-		else if (v.get_edges_l().empty()) {
-			vg->add_tip(v.id(), pgt::v_end_e::l);
-		}
-		else if (v.get_edges_r().empty()) {
-			vg->add_tip(v.id(), pgt::v_end_e::r);
-		}
-	}
+	populate_tips(*vg, app_config);
+	vg->freeze();
 
 	return vg;
 }
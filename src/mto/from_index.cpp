@@ -0,0 +1,435 @@
+#include "mto/from_index.hpp"
+
+#include <cstdint>     // for uint32_t, uint64_t
+#include <cstring>     // for memcmp, memcpy
+#include <fstream>     // for ifstream
+#include <memory>      // for make_shared, make_unique
+#include <stdexcept>   // for runtime_error
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <type_traits> // for is_standard_layout_v, is_trivially_copyable_v
+#include <utility>     // for move
+#include <vector>      // for vector
+
+#include "mto/common.hpp" // for MappedFile, gen_label_store
+#include "mto/index.hpp"  // for header_t, MAGIC, VERSION
+
+#include "povu/common/constants.hpp" // for INVALID_IDX, MAX_IDX
+#include "povu/common/core.hpp"	     // for pt, idx_t, id_t
+#include "povu/graph/types.hpp"	     // for v_end_e
+#include "povu/refs/refs.hpp"	     // for Ref
+
+namespace mto::from_index
+{
+namespace mc = mto::common;
+namespace mi = mto::index;
+namespace pgt = povu::types::graph;
+namespace lq = liteseq;
+
+// the edges are read in place, laid out as the edges section
+static_assert(sizeof(bd::Edge) == 4 * sizeof(std::uint32_t) &&
+		      std::is_standard_layout_v<bd::Edge> &&
+		      std::is_trivially_copyable_v<bd::Edge>,
+	      "bd::Edge must match the edges of an index");
+
+namespace
+{
+std::string invalid_index_msg(const std::string &fp, const std::string &detail)
+{
+	return "Invalid graph index '" + fp + "': " + detail;
+}
+
+/**
+ * Views into the sections of a mapped index, the pointers are only valid
+ * while the mapping is alive
+ */
+struct sections_t {
+	mi::header_t h;
+	const std::uint32_t *v_ids;
+	const std::uint32_t *edges;
+	const std::uint64_t *adj_offsets;
+	const pt::idx_t *adj;
+	const pt::idx_t *flat_ids;
+	const std::uint32_t *tips;
+	const std::uint64_t *label_offsets;
+	const char *labels;
+	const char *src;
+	// only when HAS_REFS is set
+	const mi::ref_rec_t *refs;
+	const char *ref_names;
+	const mi::walk_v_id_t *walk_v_ids;
+	const mi::walk_strand_t *walk_strands;
+	const mi::walk_locus_t *walk_loci;
+	const std::uint64_t *step_offsets;
+	const pt::id_t *step_ref_ids;
+	const pt::idx_t *step_idxs;
+};
+
+sections_t map_sections(const std::string &fp, const mc::MappedFile &f)
+{
+	if (!f.is_open())
+		throw std::runtime_error(
+			invalid_index_msg(fp, "could not open file"));
+
+	sections_t s{};
+	if (f.size() < sizeof(mi::header_t))
+		throw std::runtime_error(
+			invalid_index_msg(fp, "file is too small"));
+
+	std::memcpy(&s.h, f.data(), sizeof(mi::header_t));
+	if (std::memcmp(s.h.magic, mi::MAGIC, sizeof(mi::MAGIC)) != 0)
+		throw std::runtime_error(
+			invalid_index_msg(fp, "not a povu graph index"));
+
+	if (s.h.version != mi::VERSION)
+		throw std::runtime_error(invalid_index_msg(
+			fp, "unsupported version " +
+				    std::to_string(s.h.version)));
+
+	// the graph keeps vertices, edges and steps at pt::idx_t
+	if (s.h.vtx_count > pc::MAX_IDX || s.h.edge_count > pc::MAX_IDX ||
+	    s.h.step_count > pc::MAX_IDX)
+		throw std::runtime_error(
+			invalid_index_msg(fp, "the graph is too large"));
+
+	const bool has_labels = s.h.flags & mi::HAS_LABELS;
+	std::uint64_t off = sizeof(mi::header_t);
+	// @p count items of @p width bytes, checked against the bytes left so
+	// that a corrupt count can neither wrap the size nor pass the end
+	auto take = [&](std::uint64_t count,
+			std::uint64_t width) -> const char *
+	{
+		const std::uint64_t left = f.size() - off;
+		if (width != 0 && count > left / width)
+			throw std::runtime_error(
+				invalid_index_msg(fp, "file is truncated"));
+
+		const std::uint64_t n = mi::align8(count * width);
+		if (n > left)
+			throw std::runtime_error(
+				invalid_index_msg(fp, "file is truncated"));
+
+		const char *p = f.data() + off;
+		off += n;
+		return p;
+	};
+
+	s.v_ids = reinterpret_cast<const std::uint32_t *>(
+		take(s.h.vtx_count, sizeof(std::uint32_t)));
+	s.edges = reinterpret_cast<const std::uint32_t *>(
+		take(s.h.edge_count, 4 * sizeof(std::uint32_t)));
+	s.adj_offsets = reinterpret_cast<const std::uint64_t *>(
+		take((s.h.vtx_count * 2) + 1, sizeof(std::uint64_t)));
+	s.adj = reinterpret_cast<const pt::idx_t *>(
+		take(s.h.adj_count, sizeof(pt::idx_t)));
+	s.flat_ids = reinterpret_cast<const pt::idx_t *>(
+		take(s.h.flat_count, sizeof(pt::idx_t)));
+	s.tips = reinterpret_cast<const std::uint32_t *>(
+		take(s.h.tip_count, 2 * sizeof(std::uint32_t)));
+	if (has_labels) {
+		s.label_offsets = reinterpret_cast<const std::uint64_t *>(
+			take(s.h.vtx_count + 1, sizeof(std::uint64_t)));
+		s.labels = take(s.h.label_bytes, 1);
+	}
+	s.src = take(s.h.src_len, 1);
+
+	if (!(s.h.flags & mi::HAS_REFS))
+		return s;
+
+	if (std::memcmp(s.h.walk_widths, mi::WALK_WIDTHS,
+			sizeof(mi::WALK_WIDTHS)) != 0)
+		throw std::runtime_error(invalid_index_msg(
+			fp, "the walks were written by an incompatible build"));
+
+	const std::uint64_t N = s.h.step_count;
+	s.refs = reinterpret_cast<const mi::ref_rec_t *>(
+		take(s.h.ref_count, sizeof(mi::ref_rec_t)));
+	s.ref_names = take(s.h.ref_name_bytes, 1);
+	s.walk_v_ids = reinterpret_cast<const mi::walk_v_id_t *>(
+		take(N, sizeof(mi::walk_v_id_t)));
+	s.walk_strands = reinterpret_cast<const mi::walk_strand_t *>(
+		take(N, sizeof(mi::walk_strand_t)));
+	s.walk_loci = reinterpret_cast<const mi::walk_locus_t *>(
+		take(N, sizeof(mi::walk_locus_t)));
+	s.step_offsets = reinterpret_cast<const std::uint64_t *>(
+		take(s.h.vtx_count + 1, sizeof(std::uint64_t)));
+	s.step_ref_ids = reinterpret_cast<const pt::id_t *>(
+		take(N, sizeof(pt::id_t)));
+	s.step_idxs = reinterpret_cast<const pt::idx_t *>(
+		take(N, sizeof(pt::idx_t)));
+
+	return s;
+}
+
+bool is_end(std::uint32_t e)
+{
+	return e == static_cast<std::uint32_t>(pgt::v_end_e::l) ||
+	       e == static_cast<std::uint32_t>(pgt::v_end_e::r);
+}
+
+/**
+ * The id map of an index as views into its mapping, a corrupt map would
+ * resolve ids to vertex indexes out of bounds
+ */
+bd::VertexIdMap map_ids(const std::string &fp, const sections_t &s)
+{
+	const std::uint64_t V = s.h.vtx_count;
+	const std::uint64_t F = s.h.flat_count;
+	const pt::id_t base = s.h.id_base;
+	const auto mode = static_cast<bd::id_map_e>(s.h.id_map);
+
+	auto corrupt = [&]()
+	{
+		return std::runtime_error(
+			invalid_index_msg(fp, "the id map is corrupt"));
+	};
+
+	switch (mode) {
+	case bd::id_map_e::dense:
+		for (std::uint64_t v_idx{}; v_idx < V; ++v_idx)
+			if (s.v_ids[v_idx] - base != v_idx)
+				throw corrupt();
+		break;
+	case bd::id_map_e::flat:
+		for (std::uint64_t off{}; off < F; ++off) {
+			const pt::idx_t v_idx = s.flat_ids[off];
+			if (v_idx != pc::INVALID_IDX &&
+			    (v_idx >= V || s.v_ids[v_idx] - base != off))
+				throw corrupt();
+		}
+		for (std::uint64_t v_idx{}; v_idx < V; ++v_idx) {
+			const pt::id_t off = s.v_ids[v_idx] - base;
+			if (off >= F || s.flat_ids[off] != v_idx)
+				throw corrupt();
+		}
+		break;
+	case bd::id_map_e::hashed:
+		break;
+	default:
+		throw corrupt();
+	}
+
+	return bd::VertexIdMap::from_parts(mode, base, {s.v_ids, V},
+					   {s.flat_ids, F});
+}
+
+/**
+ * Check the edges and the adjacency of an index, both are read in place
+ * and hold the vertex and edge indexes the graph is walked by
+ */
+void check_edges(const std::string &fp, const sections_t &s)
+{
+	const std::uint64_t V = s.h.vtx_count;
+	const std::uint64_t E = s.h.edge_count;
+
+	for (std::uint64_t e_idx{}; e_idx < E; ++e_idx) {
+		const std::uint32_t *e = s.edges + (e_idx * 4);
+		if (e[0] >= V || e[2] >= V)
+			throw std::runtime_error(invalid_index_msg(
+				fp, "edge " + std::to_string(e_idx) +
+					    " refers to a missing vertex"));
+
+		if (!is_end(e[1]) || !is_end(e[3]))
+			throw std::runtime_error(invalid_index_msg(
+				fp, "edge " + std::to_string(e_idx) +
+					    " has an invalid vertex end"));
+	}
+
+	const std::uint64_t *o = s.adj_offsets;
+	if (o[0] != 0 || o[V * 2] != s.h.adj_count)
+		throw std::runtime_error(
+			invalid_index_msg(fp, "the adjacency is truncated"));
+
+	// range r holds the edges of vertex r / 2 on its left when r is even
+	for (std::uint64_t r{}; r < V * 2; ++r) {
+		const std::uint32_t v_idx = r / 2;
+		const auto side = static_cast<std::uint32_t>(
+			r % 2 == 0 ? pgt::v_end_e::l : pgt::v_end_e::r);
+
+		if (o[r] > o[r + 1])
+			throw std::runtime_error(invalid_index_msg(
+				fp, "the edges of vertex " +
+					    std::to_string(v_idx) +
+					    " are out of bounds"));
+
+		for (std::uint64_t i = o[r]; i < o[r + 1]; ++i) {
+			const std::uint64_t e_idx = s.adj[i];
+			const std::uint32_t *e =
+				e_idx < E ? s.edges + (e_idx * 4) : nullptr;
+			if (e == nullptr || !((e[0] == v_idx && e[1] == side) ||
+					      (e[2] == v_idx && e[3] == side)))
+				throw std::runtime_error(invalid_index_msg(
+					fp, "vertex " + std::to_string(v_idx) +
+						    " lists an edge it is not "
+						    "on"));
+		}
+	}
+}
+
+/**
+ * Add the labels of an index to @p labels
+ *
+ * @return the label index of each vertex
+ */
+std::vector<pt::idx_t> add_labels(const std::string &fp, const sections_t &s,
+				  bd::LabelStore &labels)
+{
+	const std::uint64_t V = s.h.vtx_count;
+	if (s.label_offsets[0] != 0)
+		throw std::runtime_error(
+			invalid_index_msg(fp, "the label offsets are corrupt"));
+
+	std::vector<pt::idx_t> label_idxs(V);
+	labels.reserve(V);
+	for (std::uint64_t v_idx{}; v_idx < V; ++v_idx) {
+		const std::uint64_t b = s.label_offsets[v_idx];
+		const std::uint64_t e = s.label_offsets[v_idx + 1];
+		if (b > e || e > s.h.label_bytes)
+			throw std::runtime_error(invalid_index_msg(
+				fp, "the label of vertex " +
+					    std::to_string(v_idx) +
+					    " is out of bounds"));
+
+		label_idxs[v_idx] = labels.add({s.labels + b, e - b});
+	}
+
+	return label_idxs;
+}
+
+/**
+ * Add the refs and the step index of an index to vg as views into its
+ * mapping, the caller keeps the mapping alive
+ */
+void add_refs(const std::string &fp, const sections_t &s, bd::VG &vg)
+{
+	const std::uint64_t N = s.h.step_count;
+	auto in_names = [&](std::uint64_t off, std::uint64_t len)
+	{
+		return off <= s.h.ref_name_bytes &&
+		       len <= s.h.ref_name_bytes - off;
+	};
+
+	for (std::uint64_t ref_id{}; ref_id < s.h.ref_count; ++ref_id) {
+		const mi::ref_rec_t &rec = s.refs[ref_id];
+		if (rec.first_step > N || rec.step_count > N - rec.first_step ||
+		    !in_names(rec.tag_off, rec.tag_len) ||
+		    !in_names(rec.sample_off, rec.sample_len))
+			throw std::runtime_error(invalid_index_msg(
+				fp, "ref " + std::to_string(ref_id) +
+					    " is out of bounds"));
+
+		// liteseq's walks are not const, these are never written
+		lq::ref_walk w{};
+		w.v_ids = const_cast<mi::walk_v_id_t *>(s.walk_v_ids +
+							rec.first_step);
+		w.strands = const_cast<mi::walk_strand_t *>(s.walk_strands +
+							    rec.first_step);
+		w.loci = const_cast<mi::walk_locus_t *>(s.walk_loci +
+							rec.first_step);
+		w.step_count = rec.step_count;
+
+		vg.add_ref(pr::Ref::from_parts(
+			{s.ref_names + rec.tag_off, rec.tag_len},
+			{s.ref_names + rec.sample_off, rec.sample_len},
+			rec.hap_id, static_cast<lq::ref_id_type>(rec.id_type),
+			rec.length, w));
+	}
+
+	const std::uint64_t V = s.h.vtx_count;
+	if (s.step_offsets[0] != 0 || s.step_offsets[V] != N)
+		throw std::runtime_error(
+			invalid_index_msg(fp, "the step index is truncated"));
+
+	for (std::uint64_t v_idx{}; v_idx < V; ++v_idx)
+		if (s.step_offsets[v_idx] > s.step_offsets[v_idx + 1])
+			throw std::runtime_error(invalid_index_msg(
+				fp, "the steps of vertex " +
+					    std::to_string(v_idx) +
+					    " are out of bounds"));
+
+	for (std::uint64_t i{}; i < N; ++i)
+		if (s.step_ref_ids[i] >= s.h.ref_count ||
+		    s.step_idxs[i] >= s.refs[s.step_ref_ids[i]].step_count)
+			throw std::runtime_error(invalid_index_msg(
+				fp, "step " + std::to_string(i) +
+					    " refers to a missing ref step"));
+
+	vg.set_vertex_step_index({s.step_offsets, V + 1},
+				 {s.step_ref_ids, N}, {s.step_idxs, N});
+	vg.gen_genotype_metadata();
+}
+} // namespace
+
+bool is_index(const std::string &fp)
+{
+	std::ifstream in(fp, std::ios::binary);
+	char magic[sizeof(mi::MAGIC)] = {};
+	in.read(magic, sizeof(magic));
+
+	return in && std::memcmp(magic, mi::MAGIC, sizeof(mi::MAGIC)) == 0;
+}
+
+std::string source_gfa(const std::string &fp)
+{
+	mc::MappedFile f(fp);
+	sections_t s = map_sections(fp, f);
+	return {s.src, s.h.src_len};
+}
+
+bd::VG *to_bd(const std::string &fp, const core::config &app_config)
+{
+	auto f = std::make_shared<const mc::MappedFile>(fp);
+	sections_t s = map_sections(fp, *f);
+
+	const bool with_labels =
+		app_config.inc_vtx_labels() && (s.h.flags & mi::HAS_LABELS);
+
+	if (app_config.inc_vtx_labels() && !(s.h.flags & mi::HAS_LABELS))
+		throw std::runtime_error(invalid_index_msg(
+			fp, "labels were requested but the index has none"));
+
+	if (app_config.inc_refs() && !(s.h.flags & mi::HAS_REFS))
+		throw std::runtime_error(invalid_index_msg(
+			fp, "refs were requested but the index has none"));
+
+	const pt::idx_t V = s.h.vtx_count;
+	const pt::idx_t E = s.h.edge_count;
+
+	bd::VertexIdMap v_ids = map_ids(fp, s);
+	check_edges(fp, s);
+
+	// freed if the index turns out to be corrupt, set_frozen sizes it
+	auto vg = std::make_unique<bd::VG>(0, 0, 0);
+	std::vector<pt::idx_t> label_idxs;
+	if (with_labels) {
+		vg->set_label_store(
+			mc::gen_label_store(f, app_config.pack_vtx_labels()));
+		label_idxs = add_labels(fp, s, *vg->get_label_store());
+	}
+
+	vg->set_frozen(std::move(v_ids),
+		       {reinterpret_cast<const bd::Edge *>(s.edges), E},
+		       {s.adj_offsets, (std::size_t(V) * 2) + 1},
+		       {s.adj, s.h.adj_count},
+		       {label_idxs.data(), label_idxs.size()});
+	vg->set_backing(f);
+
+	for (std::uint64_t i{}; i < s.h.tip_count; ++i) {
+		const std::uint32_t v_end = s.tips[i * 2];
+		const std::uint32_t v_id = s.tips[(i * 2) + 1];
+		// unknown ids map to index 0
+		if (V == 0 || vg->v_idx_to_id(vg->v_id_to_idx(v_id)) != v_id ||
+		    !is_end(v_end))
+			throw std::runtime_error(invalid_index_msg(
+				fp, "tip " + std::to_string(i) +
+					    " refers to a missing vertex"));
+
+		vg->add_tip(v_id, static_cast<pgt::v_end_e>(v_end));
+	}
+
+	if (app_config.inc_refs())
+		add_refs(fp, s, *vg);
+
+	return vg.release();
+}
+} // namespace mto::from_index
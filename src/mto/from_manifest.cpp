@@ -0,0 +1,109 @@
+#include "mto/from_manifest.hpp"
+
+#include <charconv>	// for from_chars
+#include <cstdint>	// for uint64_t
+#include <fstream>	// for ifstream
+#include <stdexcept>	// for runtime_error
+#include <string_view>	// for string_view
+#include <system_error>	// for errc
+#include <utility>	// for move
+#include <vector>	// for vector
+
+namespace mto::from_manifest
+{
+namespace mm = mto::manifest;
+
+namespace
+{
+bool to_u64(std::string_view s, std::uint64_t &n)
+{
+	auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), n);
+	return ec == std::errc() && end == s.data() + s.size();
+}
+
+std::vector<std::string_view> split_tabs(std::string_view line)
+{
+	std::vector<std::string_view> cols;
+	for (std::size_t b{};;) {
+		std::size_t e = line.find('\t', b);
+		cols.push_back(line.substr(b, e - b));
+		if (e == std::string_view::npos)
+			return cols;
+
+		b = e + 1;
+	}
+}
+} // namespace
+
+mm::manifest_t read_manifest(const std::string &fp)
+{
+	std::ifstream in(fp);
+	if (!in.is_open())
+		throw std::runtime_error("Failed to open file " + fp);
+
+	mm::manifest_t manifest;
+	std::string line;
+	for (std::size_t line_no{1}; std::getline(in, line); line_no++) {
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		auto fail = [&]()
+		{
+			throw std::runtime_error("Invalid manifest line " +
+						 std::to_string(line_no) +
+						 " in " + fp);
+		};
+
+		std::vector<std::string_view> cols = split_tabs(line);
+		std::uint64_t component_id{};
+		if (!to_u64(cols[0], component_id))
+			fail();
+
+		// a tree that no ref passes through
+		std::vector<mm::ref_range_t> &ranges = manifest[component_id];
+		if (cols.size() == 1)
+			continue;
+
+		mm::ref_range_t r{std::string(cols[1]), 0, 0};
+		if (cols.size() != 4 || r.ref.empty() ||
+		    !to_u64(cols[2], r.start_locus) ||
+		    !to_u64(cols[3], r.end_locus))
+			fail();
+
+		ranges.push_back(std::move(r));
+	}
+
+	return manifest;
+}
+
+std::set<std::uint64_t> find_skips(const mm::manifest_t &manifest,
+				   const std::set<std::string> &ref_tags,
+				   const std::optional<mm::region_t> &region)
+{
+	auto in_region = [&](const std::vector<mm::ref_range_t> &ranges)
+	{
+		for (const mm::ref_range_t &r : ranges)
+			if (r.ref == region->ref)
+				return r.end_locus > region->start &&
+				       r.start_locus < region->end;
+
+		return false;
+	};
+
+	auto has_tags = [&](const std::vector<mm::ref_range_t> &ranges)
+	{
+		std::size_t found{};
+		for (const mm::ref_range_t &r : ranges)
+			found += ref_tags.count(r.ref);
+
+		return found == ref_tags.size();
+	};
+
+	std::set<std::uint64_t> skips;
+	for (const auto &[component_id, ranges] : manifest)
+		if (!has_tags(ranges) || (region && !in_region(ranges)))
+			skips.insert(component_id);
+
+	return skips;
+}
+} // namespace mto::from_manifest
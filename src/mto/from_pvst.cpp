@@ -1,20 +1,26 @@
-#include <algorithm> // for find
+#include <algorithm>	// for find
 #include <array>
-#include <cctype>  // for isspace
-#include <cstdlib> // for exit, size_t, strtol
-#include <fstream> // for basic_ifstream, basic_ostream
-#include <map>	   // for map
-#include <memory>  // for make_unique
-#include <sstream> // for basic_stringstream
-#include <string>  // for basic_string, char_traits, string
+#include <cctype>	// for isspace
+#include <charconv>	// for from_chars
+#include <cstdint>	// for uint8_t, uint64_t, int64_t
+#include <cstdlib>	// for exit, size_t
+#include <cstring>	// for memcmp, memcpy
+#include <fstream>	// for basic_ifstream, basic_ostream
+#include <map>		// for map
+#include <memory>	// for make_unique
+#include <sstream>	// for basic_stringstream
+#include <stdexcept>	// for runtime_error
+#include <string>	// for basic_string, char_traits, string
 #include <string_view>
-#include <utility> // for get, pair
-#include <vector>  // for vector
+#include <system_error>	// for errc
+#include <utility>	// for get, pair, move
+#include <vector>	// for vector
 
 #include "fmt/core.h" // for format
 
-#include "mto/common.hpp" // for FILE_ERROR
+#include "mto/common.hpp"   // for FILE_ERROR, MappedFile
 #include "mto/from_pvst.hpp"
+#include "mto/pvst_bin.hpp" // for header_t, MAGIC, VERSION
 
 #include "povu/common/compat.hpp"    // for format, pv_cmp
 #include "povu/common/constants.hpp" // for INVALID_IDX, COL_SEP, EXPECTED_...
@@ -30,6 +36,8 @@ namespace pgt = povu::types::graph;
 namespace pvst = povu::pvst;
 namespace pc = povu::constants;
 namespace pu = povu::utils;
+namespace mc = mto::common;
+namespace mpb = mto::pvst_bin;
 
 // constexpr std::vector<std::string_view> PVST_SUPPORTED_VERSIONS{"0.0.3"};
 
@@ -100,14 +108,13 @@ std::vector<pt::idx_t> split_numbers(std::string_view s)
 			--last;
 
 		if (last > first) {
-			// parse token[first..last)
-			// use strtol on a null-terminated buffer
-			std::string buf(token.substr(first, last - first));
-			char const *ptr = buf.c_str();
-			char *end = nullptr;
-			long val = std::strtol(ptr, &end, 10);
-			if (end != ptr)
-				result.push_back(static_cast<int>(val));
+			// parse token[first..last) in place
+			pt::idx_t val{};
+			const char *b = token.data();
+			auto [_, ec] =
+				std::from_chars(b + first, b + last, val);
+			if (ec == std::errc())
+				result.push_back(val);
 
 			// else: token wasn’t a valid number—skip it
 		}
@@ -122,36 +129,11 @@ std::vector<pt::idx_t> split_numbers(std::string_view s)
 	return result;
 }
 
-// TODO: [c] CLEANUP move to utils
-/**
- * @brief split s based on > and < signs and using s.substr
- *        s is in the form of >1<2 or >1>2 or <1<2 or <1>2
- */
-std::pair<pgt::id_or_t, pgt::id_or_t> str_to_id_or_t(const std::string &s)
-{
-	// find the first > or <
-	auto first = s.find_first_of("><");
-	auto last = s.find_last_of("><");
-
-	// substring based on first and last occurences and store them as size_t
-	pgt::id_or_t srt, end;
-
-	srt.v_id = std::stoull(s.substr(first + 1, last - first - 1));
-	srt.orientation =
-		s[first] == '>' ? pgt::or_e::forward : pgt::or_e::reverse;
-
-	end.v_id = std::stoull(s.substr(last + 1, s.size() - last - 1));
-	end.orientation =
-		s[last] == '>' ? pgt::or_e::forward : pgt::or_e::reverse;
-
-	return {srt, end};
-}
-
 pvst::route_params_t
 tokens_to_route_params(const std::vector<std::string> &tokens)
 {
 	const std::string &pvst_label = tokens[2];
-	auto [l, r] = str_to_id_or_t(pvst_label);
+	auto [l, r] = mc::str_to_id_or_t(pvst_label);
 
 	const char route_char = tokens[4][0];
 	pvst::route_e route =
@@ -159,8 +141,142 @@ tokens_to_route_params(const std::vector<std::string> &tokens)
 	return pvst::route_params_t{l, r, route};
 }
 
+namespace
+{
+std::string invalid_pvst_msg(const std::string &fp, const std::string &detail)
+{
+	return "Invalid binary PVST '" + fp + "': " + detail;
+}
+
+bool is_binary(std::string_view bytes)
+{
+	return bytes.size() >= sizeof(mpb::MAGIC) &&
+	       std::memcmp(bytes.data(), mpb::MAGIC, sizeof(mpb::MAGIC)) == 0;
+}
+} // namespace
+
+pvst::Tree from_bin(std::string_view bytes, const std::string &fp)
+{
+	auto fail = [&](const std::string &detail)
+	{
+		throw std::runtime_error(invalid_pvst_msg(fp, detail));
+	};
+
+	mpb::header_t h{};
+	if (bytes.size() < sizeof(mpb::header_t))
+		fail("file is too small");
+
+	std::memcpy(&h, bytes.data(), sizeof(mpb::header_t));
+	if (!is_binary(bytes))
+		fail("not a binary PVST");
+
+	if (h.version != mpb::VERSION)
+		fail("unsupported version " + std::to_string(h.version));
+
+	// every record takes at least two bytes, which also bounds the
+	// reservations below for a corrupt header
+	if (h.body_bytes > bytes.size() - sizeof(mpb::header_t) ||
+	    h.vtx_count > h.body_bytes / 2 || h.child_count > h.body_bytes)
+		fail("file is truncated");
+
+	const char *p = bytes.data() + sizeof(mpb::header_t);
+	const char *end = p + h.body_bytes;
+
+	auto next = [&]() -> std::uint64_t
+	{
+		std::uint64_t x;
+		if (!mpb::get_varint(p, end, x))
+			fail("file is truncated");
+		return x;
+	};
+
+	pvst::Tree pvst;
+	pvst.reserve(h.vtx_count);
+
+	std::vector<pt::idx_t> ch_offsets;
+	ch_offsets.reserve(h.vtx_count + 1);
+	ch_offsets.push_back(0);
+	std::vector<pt::idx_t> ch;
+	ch.reserve(h.child_count);
+
+	for (pt::idx_t v_idx{}; v_idx < h.vtx_count; v_idx++) {
+		if (p == end)
+			fail("file is truncated");
+
+		const auto tag = static_cast<std::uint8_t>(*p++);
+		const auto fam = static_cast<pvst::vf_e>(tag & mpb::FAM_MASK);
+
+		pvst::route_params_t rp{};
+		const bool has_route = tag & mpb::HAS_ROUTE;
+		if (has_route) {
+			rp.start = {static_cast<pt::id_t>(next()),
+				    tag & mpb::START_REV ? pgt::or_e::reverse
+							 : pgt::or_e::forward};
+			rp.end = {static_cast<pt::id_t>(next()),
+				  tag & mpb::END_REV ? pgt::or_e::reverse
+						     : pgt::or_e::forward};
+			rp.route = tag & mpb::ROUTE_E2S ? pvst::route_e::e2s
+							: pvst::route_e::s2e;
+		}
+
+		if (!has_route && fam != pvst::vf_e::dummy)
+			fail("vertex " + std::to_string(v_idx) +
+			     " has no route");
+
+		switch (fam) {
+		case pvst::vf_e::dummy:
+			pvst.add_vertex(pvst::Dummy{});
+			break;
+		case pvst::vf_e::flubble:
+		case pvst::vf_e::tiny:
+		case pvst::vf_e::parallel:
+			pvst.add_vertex(pvst::Flubble::parse(fam, rp));
+			break;
+		case pvst::vf_e::concealed:
+			pvst.add_vertex(pvst::Concealed::parse(rp));
+			break;
+		case pvst::vf_e::smothered:
+			pvst.add_vertex(pvst::Smothered::parse(rp));
+			break;
+		case pvst::vf_e::midi:
+			pvst.add_vertex(pvst::MidiBubble::parse(rp));
+			break;
+		default:
+			fail("unknown vertex type " +
+			     std::to_string(tag & mpb::FAM_MASK));
+		}
+
+		std::int64_t prev = v_idx;
+		for (std::uint64_t n = next(); n > 0; n--) {
+			prev += mpb::unzigzag(next());
+			if (prev < 0 || static_cast<std::uint64_t>(prev) >=
+						h.vtx_count)
+				fail("child index out of range");
+			ch.push_back(static_cast<pt::idx_t>(prev));
+		}
+		ch_offsets.push_back(ch.size());
+	}
+
+	if (p != end)
+		fail("trailing bytes after the last vertex");
+
+	if (h.root_idx >= h.vtx_count)
+		fail("root index out of range");
+
+	pvst.set_root_idx(h.root_idx);
+	pvst.freeze(std::move(ch_offsets), std::move(ch));
+
+	return pvst;
+}
+
 pvst::Tree read_pvst(const std::string &fp)
 {
+	{ // binary PVSTs are read in place from the mapping
+		mc::MappedFile f(fp);
+		if (is_binary(f.view()))
+			return from_bin(f.view(), fp);
+	}
+
 	// bool dbg = "frst_dir/9.pvst" == fp ? true : false;
 
 	// std::cerr << "Reading PVST file: " << fp << "\n";
@@ -298,6 +414,8 @@ pvst::Tree read_pvst(const std::string &fp)
 		}
 	}
 
+	pvst.freeze();
+
 	return pvst;
 }
 
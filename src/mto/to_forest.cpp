@@ -0,0 +1,119 @@
+#include "mto/to_forest.hpp"
+
+#include <algorithm> // for sort
+#include <cerrno>    // for errno, EINTR
+#include <cstring>   // for memcpy
+#include <fcntl.h>   // for open, O_WRONLY, O_CREAT, O_TRUNC
+#include <stdexcept> // for runtime_error, logic_error
+#include <unistd.h>  // for pwrite, close
+
+#include "mto/forest.hpp"  // for header_t, footer_t, MAGIC, VERSION
+#include "mto/to_pvst.hpp" // for to_bin
+
+namespace mto::to_forest
+{
+namespace mf = mto::forest;
+
+namespace
+{
+void write_at(int fd, const char *data, std::uint64_t n, std::uint64_t off,
+	      const std::string &fp)
+{
+	while (n > 0) {
+		ssize_t w = ::pwrite(fd, data, n, static_cast<off_t>(off));
+		if (w < 0 && errno == EINTR)
+			continue;
+
+		if (w < 0)
+			throw std::runtime_error("Failed to write to " + fp);
+
+		data += w;
+		n -= w;
+		off += w;
+	}
+}
+} // namespace
+
+// --------------
+// constructor(s)
+// --------------
+
+Writer::Writer(const std::filesystem::path &fp) : fp_{fp.string()}
+{
+	this->fd_ = ::open(this->fp_.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+			   0644);
+	if (this->fd_ < 0)
+		throw std::runtime_error("Failed to open file " + this->fp_);
+
+	mf::header_t h{};
+	std::memcpy(h.magic, mf::MAGIC, sizeof(h.magic));
+	h.version = mf::VERSION;
+	write_at(this->fd_, reinterpret_cast<const char *>(&h), sizeof(h), 0,
+		 this->fp_);
+	this->end_ = sizeof(h);
+}
+
+Writer::~Writer()
+{
+	// without the footer an archive that was not finished is rejected
+	if (this->fd_ >= 0)
+		::close(this->fd_);
+}
+
+// ---------
+// setter(s)
+// ---------
+
+void Writer::add(std::uint64_t component_id, const pvst::Tree &bt)
+{
+	std::string bytes = mto::to_pvst::to_bin(bt);
+
+	std::uint64_t off;
+	{
+		std::lock_guard<std::mutex> lock(this->mtx_);
+		if (this->finished_)
+			throw std::logic_error("the archive is finished");
+
+		off = this->end_;
+		this->end_ += bytes.size();
+		this->entries_.push_back({component_id, off, bytes.size()});
+	}
+
+	write_at(this->fd_, bytes.data(), bytes.size(), off, this->fp_);
+}
+
+void Writer::finish()
+{
+	std::lock_guard<std::mutex> lock(this->mtx_);
+	if (this->finished_)
+		return;
+
+	std::sort(this->entries_.begin(), this->entries_.end(),
+		  [](const mf::entry_t &a, const mf::entry_t &b)
+		  { return a.component_id < b.component_id; });
+
+	static const char PAD[8] = {};
+	const std::uint64_t index_off = mf::align8(this->end_);
+	write_at(this->fd_, PAD, index_off - this->end_, this->end_,
+		 this->fp_);
+
+	const std::uint64_t index_bytes =
+		this->entries_.size() * sizeof(mf::entry_t);
+	write_at(this->fd_,
+		 reinterpret_cast<const char *>(this->entries_.data()),
+		 index_bytes, index_off, this->fp_);
+
+	mf::footer_t f{};
+	f.index_offset = index_off;
+	f.entry_count = this->entries_.size();
+	std::memcpy(f.magic, mf::MAGIC, sizeof(f.magic));
+	write_at(this->fd_, reinterpret_cast<const char *>(&f), sizeof(f),
+		 index_off + index_bytes, this->fp_);
+
+	int fd = this->fd_;
+	this->fd_ = -1;
+	this->finished_ = true;
+	if (::close(fd) != 0)
+		throw std::runtime_error("Failed to write to " + this->fp_);
+}
+} // namespace mto::to_forest
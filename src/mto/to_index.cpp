@@ -0,0 +1,234 @@
+#include "mto/to_index.hpp"
+
+#include <cstdint>    // for uint32_t, uint64_t
+#include <cstring>    // for memcpy
+#include <filesystem> // for path
+#include <fstream>    // for ofstream
+#include <stdexcept>  // for runtime_error
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include <liteseq/refs.h> // for ref_walk
+
+#include "mto/index.hpp" // for header_t, ref_rec_t, MAGIC, VERSION
+
+#include "povu/common/compat.hpp" // for span
+#include "povu/common/core.hpp"	  // for pt, idx_t
+#include "povu/graph/types.hpp"	  // for v_end_e, side_n_id_t
+#include "povu/refs/refs.hpp"	  // for Ref
+
+namespace mto::to_index
+{
+namespace mi = mto::index;
+namespace pgt = povu::types::graph;
+namespace lq = liteseq;
+
+namespace
+{
+// pad a section of n bytes up to the next section boundary
+void pad(std::ofstream &os, std::uint64_t n)
+{
+	static const char PAD[8] = {};
+	os.write(PAD, mi::align8(n) - n);
+}
+
+// write n bytes and pad up to the next section boundary
+void write_bytes(std::ofstream &os, const char *data, std::uint64_t n)
+{
+	os.write(data, n);
+	pad(os, n);
+}
+
+template <typename T> void write_arr(std::ofstream &os, pv_cmp::span<T> v)
+{
+	write_bytes(os, reinterpret_cast<const char *>(v.data()),
+		    v.size() * sizeof(T));
+}
+
+template <typename T>
+void write_arr(std::ofstream &os, const std::vector<T> &v)
+{
+	write_arr(os, pv_cmp::span<const T>{v.data(), v.size()});
+}
+
+// one walk array of every ref, one after another, as a single section
+template <typename T, typename F>
+void write_walks(std::ofstream &os, const bd::VG &g, F field)
+{
+	std::uint64_t n{};
+	for (pt::id_t ref_id{}; ref_id < g.get_hap_count(); ++ref_id) {
+		const lq::ref_walk *w = g.get_ref_walk(ref_id);
+		const std::uint64_t bytes = std::uint64_t{w->step_count} *
+					    sizeof(T);
+		os.write(reinterpret_cast<const char *>(field(w)), bytes);
+		n += bytes;
+	}
+	pad(os, n);
+}
+
+void write_refs(std::ofstream &os, const bd::VG &g)
+{
+	const pt::id_t R = g.get_hap_count();
+
+	std::vector<mi::ref_rec_t> recs(R);
+	std::string names;
+	std::uint64_t first_step{};
+	for (pt::id_t ref_id{}; ref_id < R; ++ref_id) {
+		const pr::Ref &r = g.get_ref_by_id(ref_id);
+		mi::ref_rec_t &rec = recs[ref_id];
+		rec.first_step = first_step;
+		rec.step_count = g.get_ref_walk(ref_id)->step_count;
+		rec.tag_off = names.size();
+		rec.tag_len = r.tag().size();
+		names += r.tag();
+		rec.sample_off = names.size();
+		rec.sample_len = r.get_sample_name().size();
+		names += r.get_sample_name();
+		rec.hap_id = r.get_hap_id();
+		rec.id_type = static_cast<std::uint32_t>(r.get_id_type());
+		rec.length = r.get_length();
+		first_step += rec.step_count;
+	}
+
+	write_arr(os, recs);
+	write_bytes(os, names.data(), names.size());
+	write_walks<mi::walk_v_id_t>(os, g, [](auto *w) { return w->v_ids; });
+	write_walks<mi::walk_strand_t>(os, g,
+				       [](auto *w) { return w->strands; });
+	write_walks<mi::walk_locus_t>(os, g, [](auto *w) { return w->loci; });
+	write_arr(os, g.get_step_offsets());
+	write_arr(os, g.get_step_ref_ids());
+	write_arr(os, g.get_step_idxs());
+}
+
+// the bytes of the ref names section, see write_refs
+std::uint64_t ref_name_bytes(const bd::VG &g)
+{
+	std::uint64_t n{};
+	for (pt::id_t ref_id{}; ref_id < g.get_hap_count(); ++ref_id) {
+		const pr::Ref &r = g.get_ref_by_id(ref_id);
+		n += r.tag().size() + r.get_sample_name().size();
+	}
+
+	return n;
+}
+} // namespace
+
+void write_index(const bd::VG &g, const std::string &src_gfa,
+		 const std::filesystem::path &fp)
+{
+	const pt::idx_t V = g.vtx_count();
+	const pt::idx_t E = g.edge_count();
+
+	std::vector<std::uint64_t> label_offsets(V + 1, 0);
+	for (pt::idx_t v_idx{}; v_idx < V; ++v_idx) {
+		label_offsets[v_idx + 1] =
+			label_offsets[v_idx] +
+			g.get_vertex_by_idx(v_idx).get_length();
+	}
+
+	std::vector<std::uint32_t> edges;
+	edges.reserve(static_cast<std::size_t>(E) * 4);
+	for (pt::idx_t e_idx{}; e_idx < E; ++e_idx) {
+		const bd::Edge &e = g.get_edge(e_idx);
+		edges.push_back(e.get_v1_idx());
+		edges.push_back(static_cast<std::uint32_t>(e.get_v1_end()));
+		edges.push_back(e.get_v2_idx());
+		edges.push_back(static_cast<std::uint32_t>(e.get_v2_end()));
+	}
+
+	// the CSR of freeze, rebuilt from the vertices so that g need not be
+	// frozen
+	std::vector<std::uint64_t> adj_offsets;
+	std::vector<std::uint32_t> adj;
+	adj_offsets.reserve((static_cast<std::size_t>(V) * 2) + 1);
+	adj_offsets.push_back(0);
+	for (pt::idx_t v_idx{}; v_idx < V; ++v_idx) {
+		const bd::Vertex &v = g.get_vertex_by_idx(v_idx);
+		for (auto side : {v.get_edges_l(), v.get_edges_r()}) {
+			adj.insert(adj.end(), side.begin(), side.end());
+			adj_offsets.push_back(adj.size());
+		}
+	}
+
+	const bd::VertexIdMap &ids = g.get_id_map();
+
+	std::vector<std::uint32_t> tips;
+	tips.reserve(g.tips().size() * 2);
+	for (const pgt::side_n_id_t &t : g.tips()) {
+		tips.push_back(static_cast<std::uint32_t>(t.v_end));
+		tips.push_back(t.v_idx);
+	}
+
+	const std::uint64_t label_bytes = label_offsets.back();
+	// the step index is only built when the refs are loaded
+	const bool has_refs = !g.get_step_offsets().empty();
+
+	mi::header_t h{};
+	std::memcpy(h.magic, mi::MAGIC, sizeof(h.magic));
+	h.version = mi::VERSION;
+	h.flags = label_bytes > 0 ? mi::HAS_LABELS : 0;
+	if (has_refs)
+		h.flags |= mi::HAS_REFS;
+	h.vtx_count = V;
+	h.edge_count = E;
+	h.adj_count = adj.size();
+	h.flat_count = ids.flat().size();
+	h.id_map = static_cast<std::uint32_t>(ids.mode());
+	h.id_base = ids.base();
+	h.tip_count = g.tips().size();
+	h.label_bytes = label_bytes;
+	h.src_len = src_gfa.size();
+	if (has_refs) {
+		h.ref_count = g.get_hap_count();
+		h.ref_name_bytes = ref_name_bytes(g);
+		h.step_count = g.get_step_ref_ids().size();
+		std::memcpy(h.walk_widths, mi::WALK_WIDTHS,
+			    sizeof(h.walk_widths));
+	}
+
+	/*
+	  the labels and the walks may be views into the mapping of an index at
+	  fp itself, write next to it and replace it only once done
+	*/
+	std::filesystem::path tmp_fp = fp;
+	tmp_fp += ".tmp";
+
+	std::ofstream os(tmp_fp, std::ios::binary);
+	if (!os.is_open())
+		throw std::runtime_error("Could not open file " +
+					 tmp_fp.string() + " for writing");
+
+	os.write(reinterpret_cast<const char *>(&h), sizeof(h));
+	write_arr(os, ids.ids());
+	write_arr(os, edges);
+	write_arr(os, adj_offsets);
+	write_arr(os, adj);
+	write_arr(os, ids.flat());
+	write_arr(os, tips);
+
+	if (h.flags & mi::HAS_LABELS) {
+		write_arr(os, label_offsets);
+
+		std::string labels;
+		labels.reserve(label_bytes);
+		for (pt::idx_t v_idx{}; v_idx < V; ++v_idx)
+			g.get_vertex_by_idx(v_idx).append_label(labels);
+		write_bytes(os, labels.data(), labels.size());
+	}
+
+	write_bytes(os, src_gfa.data(), src_gfa.size());
+
+	if (has_refs)
+		write_refs(os, g);
+
+	os.close();
+	if (!os) {
+		std::filesystem::remove(tmp_fp);
+		throw std::runtime_error("Failed to write graph index " +
+					 fp.string());
+	}
+
+	std::filesystem::rename(tmp_fp, fp);
+}
+} // namespace mto::to_index
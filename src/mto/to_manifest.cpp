@@ -0,0 +1,106 @@
+#include "mto/to_manifest.hpp"
+
+#include <algorithm> // for sort, min, max
+#include <fstream>   // for ofstream
+#include <limits>    // for numeric_limits
+#include <stdexcept> // for runtime_error
+#include <utility>   // for move
+
+#include <liteseq/refs.h> // for ref_walk
+
+namespace mto::to_manifest
+{
+namespace lq = liteseq;
+namespace mm = mto::manifest;
+
+std::vector<mm::ref_range_t> ref_ranges(const bd::VG &g,
+					pv_cmp::span<const pt::idx_t> v_idxs)
+{
+	constexpr std::uint64_t NONE =
+		std::numeric_limits<std::uint64_t>::max();
+
+	// start and end locus by ref id, NONE when the ref was not met
+	std::vector<std::pair<std::uint64_t, std::uint64_t>> by_ref(
+		g.get_hap_count(), {NONE, 0});
+
+	for (pt::idx_t v_idx : v_idxs) {
+		pv_cmp::span<const pt::id_t> refs =
+			g.get_vertex_step_refs(v_idx);
+		pv_cmp::span<const pt::idx_t> steps = g.get_vertex_steps(v_idx);
+
+		for (std::size_t i{}; i < refs.size(); i++) {
+			const lq::ref_walk *w = g.get_ref_walk(refs[i]);
+			const pt::idx_t step = steps[i];
+
+			// a step ends where the next one starts
+			std::uint64_t start = w->loci[step];
+			std::uint64_t end =
+				step + 1 < w->step_count
+					? w->loci[step + 1]
+					: g.get_ref_by_id(refs[i]).get_length();
+
+			auto &[lo, hi] = by_ref[refs[i]];
+			lo = std::min(lo, start);
+			hi = std::max(hi, end);
+		}
+	}
+
+	std::vector<mm::ref_range_t> ranges;
+	for (pt::id_t ref_id{}; ref_id < by_ref.size(); ref_id++) {
+		auto [lo, hi] = by_ref[ref_id];
+		if (lo != NONE)
+			ranges.push_back({g.get_tag(ref_id), lo, hi});
+	}
+
+	std::sort(ranges.begin(), ranges.end(),
+		  [](const mm::ref_range_t &a, const mm::ref_range_t &b)
+		  { return a.ref < b.ref; });
+
+	return ranges;
+}
+
+// --------------
+// constructor(s)
+// --------------
+
+Writer::Writer(const std::filesystem::path &fp) : fp_{fp.string()}
+{}
+
+// ---------
+// setter(s)
+// ---------
+
+void Writer::add(std::uint64_t component_id,
+		 std::vector<mm::ref_range_t> ranges)
+{
+	std::lock_guard<std::mutex> lock(this->mtx_);
+	this->trees_.emplace_back(component_id, std::move(ranges));
+}
+
+void Writer::finish()
+{
+	std::lock_guard<std::mutex> lock(this->mtx_);
+
+	std::sort(this->trees_.begin(), this->trees_.end(),
+		  [](const auto &a, const auto &b)
+		  { return a.first < b.first; });
+
+	std::ofstream os(this->fp_);
+	if (!os.is_open())
+		throw std::runtime_error("Failed to open file " + this->fp_);
+
+	os << mm::HEADER << "\n";
+	for (const auto &[component_id, ranges] : this->trees_) {
+		if (ranges.empty())
+			os << component_id << "\n";
+
+		for (const mm::ref_range_t &r : ranges)
+			os << component_id << "\t" << r.ref << "\t"
+			   << r.start_locus << "\t" << r.end_locus << "\n";
+	}
+
+	os.close();
+	if (os.fail())
+		throw std::runtime_error("Failed to write to " + this->fp_);
+}
+} // namespace mto::to_manifest
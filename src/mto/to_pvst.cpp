@@ -1,10 +1,14 @@
+#include <cstdint>  // for uint8_t, uint64_t
 #include <cstdlib>  // for exit, EXIT_FAILURE, size_t
+#include <cstring>  // for memcpy
 #include <fstream>  // for basic_ofstream, operator<<, bas...
 #include <optional> // for optional
 #include <string>   // for char_traits, basic_string, string
+#include <tuple>    // for tie
 
 #include "fmt/core.h" // for format
 
+#include "mto/pvst_bin.hpp" // for header_t, MAGIC, VERSION
 #include "mto/to_pvst.hpp"
 
 #include "povu/common/compat.hpp"    // for format, pv_cmp
@@ -18,7 +22,9 @@ namespace mto::to_pvst
 using povu::types::graph::id_n_cls;
 using povu::types::graph::id_or_t;
 namespace pc = povu::constants;
+namespace pgt = povu::types::graph;
 namespace pu = povu::utils;
+namespace mpb = mto::pvst_bin;
 
 inline void write_header_line(std::ofstream &bub_file) noexcept
 {
@@ -27,20 +33,10 @@ inline void write_header_line(std::ofstream &bub_file) noexcept
 		 << pc::COL_SEP << pc::NO_VALUE << "\n";
 }
 
-void write_pvst(const pvst::Tree &bt, const std::string &base_name,
-		const core::config &app_config)
+namespace
+{
+void write_text(const pvst::Tree &bt, std::ofstream &bub_file)
 {
-	// TODO: combine and pass as single arg
-	std::string bub_file_name = pv_cmp::format(
-		"{}/{}.pvst", std::string{app_config.get_output_dir()},
-		base_name); // file path and name
-	std::ofstream bub_file(bub_file_name);
-
-	if (!bub_file.is_open()) {
-		PL_ERR("Could not open file {}", bub_file_name);
-		std::exit(EXIT_FAILURE);
-	}
-
 	// writer header line
 	// ------------------
 	write_header_line(bub_file);
@@ -104,6 +100,95 @@ void write_pvst(const pvst::Tree &bt, const std::string &base_name,
 
 		bub_file << "\n";
 	}
+}
+
+// one record of the binary format, see pvst_bin.hpp
+void put_record(const pvst::Tree &bt, pt::idx_t v_idx, std::string &out)
+{
+	const pvst::VertexBase &v = bt.get_vertex(v_idx);
+
+	pvst::vt_e fam = v.get_fam();
+	if (fam == pvst::vt_e::sne_exp) {
+		PL_ERR("Unknown vertex type in write_bub: {}", v.as_str());
+		std::exit(EXIT_FAILURE);
+	}
+
+	auto tag = static_cast<std::uint8_t>(fam);
+	std::optional<pvst::route_params_t> rp = v.get_route_params();
+	if (rp) {
+		// the bounds go in the order of the label as in the text
+		// format, for some subflubbles that is not the route order
+		std::tie(rp->start, rp->end) = *v.get_label_bounds();
+
+		tag |= mpb::HAS_ROUTE;
+		if (rp->start.orientation == pgt::or_e::reverse)
+			tag |= mpb::START_REV;
+		if (rp->end.orientation == pgt::or_e::reverse)
+			tag |= mpb::END_REV;
+		if (rp->route == pvst::route_e::e2s)
+			tag |= mpb::ROUTE_E2S;
+	}
+	out.push_back(static_cast<char>(tag));
+
+	if (rp) {
+		mpb::put_varint(out, rp->start.v_id);
+		mpb::put_varint(out, rp->end.v_id);
+	}
+
+	pv_cmp::span<const pt::idx_t> ch = bt.get_children(v_idx);
+	mpb::put_varint(out, ch.size());
+
+	std::int64_t prev = v_idx;
+	for (pt::idx_t c_idx : ch) {
+		mpb::put_varint(out, mpb::zigzag(c_idx - prev));
+		prev = c_idx;
+	}
+}
+
+} // namespace
+
+std::string to_bin(const pvst::Tree &bt)
+{
+	// the header goes in front once the size of the body is known
+	std::string out(sizeof(mpb::header_t), '\0');
+	std::uint64_t child_count{};
+	for (pt::idx_t v_idx{}; v_idx < bt.vtx_count(); ++v_idx) {
+		put_record(bt, v_idx, out);
+		child_count += bt.get_children(v_idx).size();
+	}
+
+	mpb::header_t h{};
+	std::memcpy(h.magic, mpb::MAGIC, sizeof(h.magic));
+	h.version = mpb::VERSION;
+	h.vtx_count = bt.vtx_count();
+	h.root_idx = bt.root_idx();
+	h.child_count = child_count;
+	h.body_bytes = out.size() - sizeof(mpb::header_t);
+	std::memcpy(out.data(), &h, sizeof(h));
+
+	return out;
+}
+
+void write_pvst(const pvst::Tree &bt, const std::string &base_name,
+		const core::config &app_config)
+{
+	// TODO: combine and pass as single arg
+	std::string bub_file_name = pv_cmp::format(
+		"{}/{}.pvst", std::string{app_config.get_output_dir()},
+		base_name); // file path and name
+	std::ofstream bub_file(bub_file_name, std::ios::binary);
+
+	if (!bub_file.is_open()) {
+		PL_ERR("Could not open file {}", bub_file_name);
+		std::exit(EXIT_FAILURE);
+	}
+
+	if (app_config.binary_pvst()) {
+		std::string bytes = to_bin(bt);
+		bub_file.write(bytes.data(), bytes.size());
+	}
+	else
+		write_text(bt, bub_file);
 
 	bub_file.close();
 }
@@ -198,7 +198,7 @@ void Writer::index_pvst_nodes()
 		const pvst::Tree &tree = pvsts_[component_idx];
 		for (std::size_t node_idx{}; node_idx < tree.vtx_count();
 		     ++node_idx) {
-			pvst_node_ids_[tree.get_vertex_const_ptr(node_idx)] =
+			pvst_node_ids_[&tree.get_vertex(node_idx)] =
 				node_id(component_idx, node_idx);
 		}
 	}
@@ -306,7 +306,7 @@ void Writer::write_accepted_gfa(const core::config &app_config)
 		if (ref_id > 0)
 			out_ << ',';
 		const pr::Ref &ref = graph_.get_ref_by_id(ref_id);
-		const liteseq::ref_walk *walk = graph_.get_ref_vec(ref_id)->walk;
+		const liteseq::ref_walk *walk = graph_.get_ref_walk(ref_id);
 		out_ << '{';
 		write_key(out_, "order");
 		out_ << ref_id << ',';
@@ -452,7 +452,7 @@ void Writer::write_pvst_nodes()
 			out_ << ',';
 			write_key(out_, "children");
 			out_ << '[';
-			const std::vector<pt::idx_t> &children =
+			pv_cmp::span<const pt::idx_t> children =
 				tree.get_children(node_idx);
 			for (std::size_t child_idx{}; child_idx < children.size();
 			     ++child_idx) {
@@ -9,7 +9,7 @@
 #include <stdio.h>   // for perror
 #include <stdlib.h>  // for exit
 #include <string>    // for basic_string, string
-#include <utility>   // for pair, get
+#include <utility>   // for pair, get, move
 #include <vector>    // for vector
 
 #include "fmt/core.h"		  // for format
@@ -24,20 +24,6 @@ namespace povu::concealed
   Types
   -----------------
 */
-// slubbles in flubble or flubble slubbles
-struct fl_sls {
-	pt::idx_t fl_v_idx;
-	std::vector<pvst::Concealed> ii_adj;
-	std::vector<pvst::Concealed> ji_adj;
-	pt::idx_t m;
-	pt::idx_t n;
-
-	pt::idx_t size() const
-	{
-		return ii_adj.size() + ji_adj.size();
-	}
-};
-
 struct mn_t {
 	pt::idx_t m;
 	pt::idx_t n;
@@ -1049,16 +1035,19 @@ void add_conc_ai(const pst::Tree &st, pvst::Tree &vst, const ptu::tree_meta &tm,
 
 	const std::string fn_name{pv_cmp::format("[{}::{}]", MODULE, __func__)};
 
+	// adding a vertex invalidates v
+	pt::idx_t ai = v.get_ai();
+
 	for (auto &sl : ai_adj) {
 		pt::idx_t sl_v_idx = vst.add_vertex(sl);
 		pt::idx_t sl_st_idx = sl.get_sl_st_idx();
 		vst.add_edge(fl_v_idx, sl_v_idx);
 
-		pt::idx_t ai = v.get_ai();
-
 		if (!is_leaf) {
-			// TODO: why not const vector ref?
-			std::vector<pt::idx_t> ch = vst.get_children(fl_v_idx);
+			// a copy, nesting changes the children of fl_v_idx
+			pv_cmp::span<const pt::idx_t> ch_s =
+				vst.get_children(fl_v_idx);
+			std::vector<pt::idx_t> ch(ch_s.begin(), ch_s.end());
 			if (sl.get_sl_type() == pvst::cl_e::ai_trunk) {
 				nest_trunk_ai(st, vst, tm, sl_st_idx, fl_v_idx,
 					      sl_v_idx, ch);
@@ -1142,17 +1131,19 @@ void add_conc_zi(const pst::Tree &st, const fl_sls &slubbles, pvst::Tree &vst,
 {
 	const std::string fn_name{pv_cmp::format("[{}::{}]", MODULE, __func__)};
 
+	// adding a vertex invalidates v
+	pt::idx_t zi = v.get_zi();
+
 	for (auto &sl : zi_adj) {
 		pt::idx_t sl_v_idx = vst.add_vertex(sl);
 		pt::idx_t sl_st_idx = sl.get_sl_st_idx();
 		vst.add_edge(fl_v_idx, sl_v_idx);
 
-		// pt::idx_t ai = v.get_ai();
-		pt::idx_t zi = v.get_zi();
-
 		if (!is_leaf) {
-			// TODO: why not const vector ref?
-			std::vector<pt::idx_t> ch = vst.get_children(fl_v_idx);
+			// a copy, nesting changes the children of fl_v_idx
+			pv_cmp::span<const pt::idx_t> ch_s =
+				vst.get_children(fl_v_idx);
+			std::vector<pt::idx_t> ch(ch_s.begin(), ch_s.end());
 
 			if (sl.get_sl_type() == pvst::cl_e::zi_trunk) {
 				nest_trunk_zi(st, vst, slubbles, fl_v_idx,
@@ -1185,16 +1176,47 @@ void add_concealed(const pst::Tree &st, pvst::Tree &vst,
 
 	const auto &[fl_v_idx, ai_adj, zi_adj, _, __] = slubbles;
 
-	const pvst::Flubble &v =
-		static_cast<const pvst::Flubble &>(vst.get_vertex(fl_v_idx));
+	// looked up each time, adding vertices invalidates references to them
+	auto fl_v = [&]() -> const pvst::Flubble &
+	{
+		return static_cast<const pvst::Flubble &>(
+			vst.get_vertex(fl_v_idx));
+	};
 
 	bool is_leaf = st.get_children(fl_v_idx).empty();
 
-	add_conc_ai(st, vst, tm, fl_v_idx, v, ai_adj, is_leaf);
-	add_conc_zi(st, slubbles, vst, fl_v_idx, v, zi_adj, is_leaf);
+	add_conc_ai(st, vst, tm, fl_v_idx, fl_v(), ai_adj, is_leaf);
+	add_conc_zi(st, slubbles, vst, fl_v_idx, fl_v(), zi_adj, is_leaf);
 }
 } // namespace update_pvst
 
+fl_sls find_in_flubble(const pst::Tree &st, const ptu::tree_meta &tm,
+		       pt::idx_t ft_v_idx, pvst::Flubble &ft_v)
+{
+	pt::idx_t ai = ft_v.get_ai();
+	pt::idx_t zi = ft_v.get_zi();
+
+	auto [m, n] = get_mn(st, tm, ai, zi);
+
+	ft_v.set_m(m);
+	ft_v.set_n(n);
+
+	// pass these as arguments to the slubble functions
+	fl_sls slubbles;
+	slubbles.fl_v_idx = ft_v_idx;
+	slubbles.m = m;
+	slubbles.n = n;
+
+	if (!can_contain(st, tm, ai, zi, m, n)) {
+		return slubbles;
+	}
+
+	ai::with_ai(st, tm, slubbles.ii_adj, m, n, ai, zi, ft_v_idx);
+	zi::with_ji(st, tm, slubbles.ji_adj, m, n, ai, zi, ft_v_idx);
+
+	return slubbles;
+}
+
 void find_concealed(const pst::Tree &st, pvst::Tree &ft,
 		    const ptu::tree_meta &tm)
 {
@@ -1211,29 +1233,9 @@ void find_concealed(const pst::Tree &st, pvst::Tree &ft,
 
 		pvst::Flubble &ft_v = static_cast<pvst::Flubble &>(pvst_v);
 
-		pt::idx_t ai = ft_v.get_ai();
-		pt::idx_t zi = ft_v.get_zi();
-
-		auto [m, n] = get_mn(st, tm, ai, zi);
-
-		ft_v.set_m(m);
-		ft_v.set_n(n);
-
-		if (!can_contain(st, tm, ai, zi, m, n)) {
-			continue;
-		}
-
-		// pass these as arguments to the slubble functions
-		fl_sls slubbles;
-		slubbles.fl_v_idx = ft_v_idx;
-		slubbles.m = m;
-		slubbles.n = n;
-		ai::with_ai(st, tm, slubbles.ii_adj, m, n, ai, zi, ft_v_idx);
-		zi::with_ji(st, tm, slubbles.ji_adj, m, n, ai, zi, ft_v_idx);
-
+		fl_sls slubbles = find_in_flubble(st, tm, ft_v_idx, ft_v);
 		if (slubbles.size() > 0) {
-
-			all_slubbles.push_back(slubbles);
+			all_slubbles.push_back(std::move(slubbles));
 		}
 	}
 
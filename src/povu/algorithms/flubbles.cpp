@@ -1,33 +1,32 @@
 #include "povu/algorithms/flubbles.hpp"
 
-#include <algorithm>	 // for min, sort
+#include <algorithm>	 // for min, max, sort
+#include <array>	 // for array
 #include <assert.h>	 // for assert
+#include <cstdint>	 // for uint64_t, uint8_t
 #include <filesystem>	 // for path, remove
 #include <fstream>	 // for ofstream
 #include <iostream>	 // for basic_ostream, operator<<
 #include <iterator>	 // for pair
-#include <list>		 // for list, _List_iterator, operator!=
-#include <map>		 // for map, operator==, _Rb_tree_ite...
+#include <limits>	 // for numeric_limits
 #include <memory>	 // for make_unique
 #include <mutex>	 // for mutex, lock_guard
 #include <optional>	 // for optional
-#include <set>		 // for set
-#include <stack>	 // for stack
 #include <stdexcept>	 // for runtime_error
 #include <string>	 // for char_traits, basic_string
 #include <string_view>	 // for string_view
-#include <unordered_map> // for unordered_map, operator!=
-#include <unordered_set> // for unordered_set
+#include <sys/types.h>	 // for u_int8_t
 #include <utility>	 // for pair, get, move, make_pair
 
 #include "fmt/core.h"		       // for format
-#include "povu/common/compat.hpp"      // for pv_cmp, format, contains
+#include "povu/common/compat.hpp"      // for pv_cmp, format, span
 #include "povu/common/stage_cost.hpp"
-#include "povu/graph/bracket_list.hpp" // for Bracket
+#include "povu/graph/bracket_list.hpp" // for BracketPool, Bracket
 
 namespace povu::flubbles
 {
 namespace fs = std::filesystem;
+namespace pbl = povu::bracket_list;
 
 namespace
 {
@@ -133,8 +132,8 @@ void append_debug_sidecar_frame(const core::config &app_config,
 	for (pt::idx_t idx{}; idx < ecs.s.size(); ++idx) {
 		if (idx > 0)
 			out << ',';
-		const auto [orientation, vertex_id, tree_edge_idx, class_id] =
-			ecs.s[idx];
+		const auto [orientation, vertex_id, tree_edge_idx, class_id,
+			    folded] = ecs.s[idx];
 		const pst::Edge &edge = st.get_tree_edge(tree_edge_idx);
 		const auto expected = expected_next_seen(ecs, idx);
 		const pt::idx_t actual = ecs.next_seen[idx];
@@ -267,24 +266,15 @@ compute_ai_zi(const pst::Tree &st, pt::idx_t a_e_idx, pt::idx_t z_e_idx)
 	std::string fn_name = pv_cmp::format(
 		"[povu::algorithms::flubble_tree::{}]", __func__);
 
-	std::vector<pt::idx_t> vtxs{};
-	auto get_vtx_pair = [&](pt::idx_t e_idx) -> void
-	{
-		const pst::Edge &e = st.get_tree_edge(e_idx);
-		vtxs.push_back(e.get_child_v_idx());
-		vtxs.push_back(e.get_parent_v_idx());
-	};
-
-	get_vtx_pair(a_e_idx);
-	get_vtx_pair(z_e_idx);
+	const pst::Edge &a_e = st.get_tree_edge(a_e_idx);
+	const pst::Edge &z_e = st.get_tree_edge(z_e_idx);
+	std::array<pt::idx_t, 4> vtxs{a_e.get_child_v_idx(),
+				      a_e.get_parent_v_idx(),
+				      z_e.get_child_v_idx(),
+				      z_e.get_parent_v_idx()};
 
 	// sort the vertices by their index in the spanning tree
-	std::sort(vtxs.begin(), vtxs.end(),
-		  [&](pt::idx_t a, pt::idx_t b) { return a < b; });
-
-#ifdef DEBUG // vtx should contain exactly 4 elements
-	assert(vtxs.size() == 4);
-#endif
+	std::sort(vtxs.begin(), vtxs.end());
 
 	return std::make_pair(vtxs[1], vtxs[2]);
 }
@@ -300,15 +290,16 @@ void add_flubbles(const pst::Tree &st, const eq_class_stack_t &ecs,
 	std::string fn_name = pv_cmp::format(
 		"[povu::algorithms::flubble_tree::{}]", __func__);
 
-	const auto &[stack_, next_seen] = ecs;
+	const auto &[stack_, next_seen, cls_count] = ecs;
 
 	struct ci {
 		pt::idx_t cl;  // class
 		pt::idx_t idx; // index in stack_
 	};
 
-	std::stack<ci> s;
-	std::unordered_set<pt::idx_t> in_s; // classes in s
+	std::vector<ci> s;
+	s.reserve(stack_.size());
+	std::vector<u_int8_t> in_s(cls_count, 0); // classes in s
 
 	pt::idx_t prt_v{vst.root_idx()}; // parent vertex
 
@@ -316,21 +307,22 @@ void add_flubbles(const pst::Tree &st, const eq_class_stack_t &ecs,
 
 	for (pt::idx_t i{}; i < stack_.size(); ++i) {
 
-		auto [or_curr, id_curr, st_idx_curr, cl_curr] = stack_[i];
+		auto [or_curr, id_curr, st_idx_curr, cl_curr, folded] =
+			stack_[i];
 
 		if (id_curr == pc::INVALID_IDX) {
 			continue;
 		}
 
 		// find the parent vertex, applies for non-siblings
-		if (pv_cmp::contains(in_s, cl_curr)) {
+		if (in_s[cl_curr]) {
 
 			// pop until (and including) the one whose cl equals
 			// cl_curr
 			while (!s.empty()) {
-				auto [cl, _] = s.top();
-				s.pop();
-				in_s.erase(cl);
+				auto [cl, _] = s.back();
+				s.pop_back();
+				in_s[cl] = 0;
 
 				if (cl == cl_curr) {
 					break;
@@ -342,8 +334,12 @@ void add_flubbles(const pst::Tree &st, const eq_class_stack_t &ecs,
 			}
 		}
 
+		// the entries dropped with a run would each repeat this class
+		for (pt::idx_t f{}; f < folded && prt_v != vst.root_idx(); ++f)
+			prt_v = vst.get_parent_idx(prt_v);
+
 		if ((i + 1) < next_seen[i]) {
-			auto [or_nxt, id_nxt, st_idx_nxt, _] =
+			auto [or_nxt, id_nxt, st_idx_nxt, _, __] =
 				stack_[next_seen[i]];
 
 			if (id_nxt == pc::INVALID_IDX) {
@@ -360,8 +356,8 @@ void add_flubbles(const pst::Tree &st, const eq_class_stack_t &ecs,
 			prt_v = pvst_v_idx;
 		}
 
-		s.push({cl_curr, i});
-		in_s.insert(cl_curr);
+		s.push_back({cl_curr, i});
+		in_s[cl_curr] = 1;
 	}
 	stage.set_output_items(vst.vtx_count());
 }
@@ -382,23 +378,23 @@ void compute_eq_class_metadata(eq_class_stack_t &ecs)
 	const std::vector<oic_t> &stack_ = ecs.s;
 	std::vector<pt::idx_t> &next_seen = ecs.next_seen;
 
-	for (pt::idx_t i{}; i < stack_.size(); ++i) {
-		next_seen.push_back(pc::INVALID_CLS);
-	}
+	next_seen.assign(stack_.size(), pc::INVALID_CLS);
+
+	// class ids are dense, numbered from zero as they are created
+	ecs.cls_count = 0;
+	for (const oic_t &x : stack_)
+		ecs.cls_count = std::max(ecs.cls_count, x.cls + 1);
 
 	// an eq class and the index of the next time it is encountered in
 	// stack_
-	std::unordered_map<pt::idx_t, pt::idx_t> next_seen_map;
-	next_seen_map.reserve(stack_.size());
+	std::vector<pt::idx_t> next_seen_by_cls(ecs.cls_count, pc::INVALID_IDX);
 
 	for (std::size_t i{stack_.size()}; i-- > 0;) {
-		auto [or_curr, id_curr, _, cl_curr] = stack_[i];
-		pt::idx_t next_idx = pv_cmp::contains(next_seen_map, cl_curr)
-					     ? next_seen_map[cl_curr]
-					     : i;
+		pt::idx_t cl_curr = stack_[i].cls;
+		pt::idx_t next_idx = next_seen_by_cls[cl_curr];
 
-		next_seen[i] = next_idx;
-		next_seen_map[cl_curr] = i;
+		next_seen[i] = next_idx == pc::INVALID_IDX ? i : next_idx;
+		next_seen_by_cls[cl_curr] = i;
 	}
 
 	std::uint64_t boundary_count{};
@@ -418,41 +414,84 @@ void compute_eq_class_stack(const pst::Tree &st, std::vector<oic_t> &stack)
 	std::string fn_name = pv_cmp::format(
 		"[povu::algorithms::flubble_tree::{}]", __func__);
 
-	ptu::BranchDesc desc = ptu::br_desc(st);
-
 	auto is_branching = [&](pt::idx_t v_idx) -> bool
 	{
-		return (st.get_children(v_idx).size() > 1);
+		return st.get_child_count(v_idx) > 1;
 	};
 
 	pt::idx_t root_idx = st.get_root_idx();
 
-	// TODO: use desc to get these
+	/*
+	  the stack is built from the leaves up as lists linked by index over
+	  one buffer, a list being the buffer idxs of its head and tail.
+	  The list of a branch (a stackette) is parked under the parent edge of
+	  the branch until the branching vertex is reached, then the lists of
+	  its branches are joined in constant time each
+	*/
+	struct list_t {
+		pt::idx_t head{pc::INVALID_IDX};
+		pt::idx_t tail{pc::INVALID_IDX};
+	};
+
+	const pt::idx_t E = st.tree_edge_count();
+	std::vector<oic_t> buf;
+	std::vector<pt::idx_t> next; // next[i] follows buf[i] in its list
+	buf.reserve(E);
+	next.reserve(E);
+
 	// edge idx => stackette
-	typedef std::map<pt::idx_t, std::list<oic_t>> edge_stack_t;
-	// v idx to mini stack
-	std::map<pt::idx_t, edge_stack_t> cache; // edge_map
+	std::vector<list_t> stackettes(E);
 
-	std::list<oic_t> mini_stack; // TODO: rename
+	list_t mini_stack; // TODO: rename
 
-	auto merge_stacks = [&](std::list<oic_t> &from, std::list<oic_t> &into)
+	auto push_front = [&](const oic_t &x, list_t &l)
+	{
+		buf.push_back(x);
+		next.push_back(l.head);
+		l.head = static_cast<pt::idx_t>(buf.size() - 1);
+		if (l.tail == pc::INVALID_IDX)
+			l.tail = l.head;
+	};
+
+	auto merge_stacks = [&](list_t &from, list_t &into)
 	{
 		// put from infront of or on top of into
-		into.splice(into.begin(), from);
+		if (from.head == pc::INVALID_IDX)
+			return;
+
+		if (into.head == pc::INVALID_IDX)
+			into.tail = from.tail;
+		else
+			next[from.tail] = into.head;
+
+		into.head = from.head;
+		from = list_t{};
 	};
 
 	for (pt::idx_t v_idx{st.vtx_count()}; v_idx-- > 0;) {
 
 		if (v_idx == root_idx || is_branching(v_idx)) {
+			// merge the black branch first then the others from the
+			// highest child down, the child edges are in
+			// increasing order of the child
+			pv_cmp::span<const pt::idx_t> c_edges =
+				st.get_child_edge_idxs(v_idx);
+
+			pt::idx_t black_e_idx{pc::INVALID_IDX};
+			for (pt::idx_t e_idx : c_edges) {
+				if (st.get_tree_edge(e_idx).get_color() ==
+				    pgt::color_e::black)
+					black_e_idx = e_idx;
+			}
 
-			// merge from cache into stack_map
-			edge_stack_t &stackettes = cache[v_idx];
-			const std::vector<pt::idx_t> &c_edges =
-				desc[v_idx].sorted_br;
+			if (black_e_idx != pc::INVALID_IDX)
+				merge_stacks(stackettes[black_e_idx],
+					     mini_stack);
 
-			for (auto e_idx : c_edges) {
-				std::list<oic_t> &stackette = stackettes[e_idx];
-				merge_stacks(stackette, mini_stack);
+			for (std::size_t i{c_edges.size()}; i-- > 0;) {
+				if (c_edges[i] != black_e_idx)
+					merge_stacks(stackettes[c_edges[i]],
+						     mini_stack);
 			}
 		}
 
@@ -468,44 +507,205 @@ void compute_eq_class_stack(const pst::Tree &st, std::vector<oic_t> &stack)
 				st.get_vertex(v_idx).type() == pgt::v_type_e::r
 					? pgt::or_e::forward
 					: pgt::or_e::reverse;
-			mini_stack.push_front({o, st.get_vertex(v_idx).g_v_id(),
-					       pe, e.get_class()});
+			push_front({o, st.get_vertex(v_idx).g_v_id(), pe,
+				    e.get_class(), st.get_folded(v_idx)},
+				   mini_stack);
 		}
 
-		// if the parent is braching
+		// if the parent is braching park the stackette until the
+		// parent is reached
 		if (is_branching(st.get_parent_v_idx(v_idx))) {
+			stackettes[pe] = mini_stack;
+			mini_stack = list_t{};
+		}
+	}
+
+	// convert the mini_stack to stack
+	stack.reserve(buf.size());
+	for (pt::idx_t i{mini_stack.head}; i != pc::INVALID_IDX; i = next[i])
+		stack.push_back(buf[i]);
+
+	stage.set_output_items(stack.size());
+	return;
+}
+
+namespace
+{
+// a block with fewer vertices in its subtree stays in the region above it
+constexpr pt::idx_t MIN_BLOCK_VTXS = 1 << 12;
+
+// a class that is not set
+constexpr std::uint64_t NO_CLS = std::numeric_limits<std::uint64_t>::max();
+
+/*
+ * the state of the cycle equivalence pass
+ * ---------------------------------------
+ *
+ * The bracket of a backedge of the tree is at the idx of the backedge, that of
+ * the capping backedge of vertex v at be_count + v and that of its
+ * simplifying backedge at be_count + n + v.
+ *
+ * The pass leaves the edges of the tree alone so that vertices whose bracket
+ * lists share no brackets can be handled at once, a vertex only writes to its
+ * own slots and to those of the brackets in its list. A class is kept as the
+ * vertex it was created at and the number of classes created there before it
+ * until every vertex is handled, then the capping and simplifying backedges
+ * are added to the tree and the classes are numbered in the order a pass from
+ * the last vertex to the root creates them, see set_classes.
+ */
+struct ceq_t {
+	pst::Tree &t;
+	const pt::idx_t n;	  // vertex count
+	const pt::idx_t be_count; // backedges of the tree before the pass
+
+	pbl::BracketPool bl;
+
+	std::vector<std::uint64_t> be_cls; // by bracket idx
+	// of the tree edge to the parent of a vertex
+	std::vector<std::uint64_t> e_cls;
+	std::vector<pt::idx_t> cls_count; // classes created at a vertex
+
+	// the target of the capping backedge of a vertex or INVALID_IDX
+	std::vector<pt::idx_t> cap_tgt;
+	// the sources of the capping backedges that end at a vertex, linked
+	// through cap_next
+	std::vector<pt::idx_t> cap_head;
+	std::vector<pt::idx_t> cap_next;
+
+	std::vector<std::uint8_t> simplified; // has a simplifying backedge
+	// the top bracket was a simplifying one, for the hairpins
+	std::vector<std::uint8_t> top_simplifying;
+
+	explicit ceq_t(pst::Tree &tree)
+	    : t(tree), n(tree.vtx_count()), be_count(tree.back_edge_count()),
+	      bl(n, be_count + (2 * n)), be_cls(be_count + (2 * n), NO_CLS),
+	      e_cls(n, NO_CLS), cls_count(n, 0), cap_tgt(n, pc::INVALID_IDX),
+	      cap_head(n, pc::INVALID_IDX), cap_next(n, pc::INVALID_IDX),
+	      simplified(n, 0), top_simplifying(n, 0)
+	{}
+
+	pt::idx_t cap_idx(pt::idx_t v) const
+	{
+		return this->be_count + v;
+	}
 
-			pt::idx_t e_idx =
-				st.get_vertex(v_idx).get_parent_e_idx();
-			pt::idx_t p_v_idx = st.get_parent_v_idx(v_idx);
+	pt::idx_t simp_idx(pt::idx_t v) const
+	{
+		return this->be_count + this->n + v;
+	}
 
-			auto [it, _] = cache.try_emplace(
-				p_v_idx); // default-constructs value if not
-					  // present
-			edge_stack_t &es = it->second;
+	void link_cap(pt::idx_t s)
+	{
+		this->cap_next[s] = this->cap_head[this->cap_tgt[s]];
+		this->cap_head[this->cap_tgt[s]] = s;
+	}
+};
 
-			es[e_idx] = std::move(mini_stack);
-			// cache[p_v_idx] = es;
-			mini_stack =
-				std::list<oic_t>(); // clear the mini_stack for
-						    // the next iteration
+/*
+ * the regions of the pass
+ * -----------------------
+ *
+ * The tree edge from p to c starts a block of the graph of the tree when no
+ * backedge from the subtree of c ends above p, p is then a cut vertex or the
+ * root. The only brackets that leave the subtree of c are those that end at p
+ * and those that end at the root, so the subtree of c can be handled on its
+ * own thread once the blocks below it are done, and the lists it leaves are
+ * only joined by the parent of c.
+ *
+ * A region holds the subtree of its head less the regions below it, region 0
+ * is that of the root.
+ */
+struct regions_t {
+	std::vector<pt::idx_t> heads;
+	// the vertices of region r are order[offsets[r], offsets[r + 1]), from
+	// the last to the head
+	std::vector<pt::idx_t> offsets;
+	std::vector<pt::idx_t> order;
+	// regions that are handled at once, the lowest first, the root's region
+	// comes after all of them
+	std::vector<std::vector<pt::idx_t>> levels;
+};
+
+regions_t find_regions(const pst::Tree &t)
+{
+	const pt::idx_t n = t.vtx_count();
+	const pt::idx_t root_idx = t.get_root_idx();
+
+	// the size of the subtree of a vertex and the highest vertex a backedge
+	// from it ends at, a child comes after its parent
+	std::vector<pt::idx_t> sub_size(n, 1);
+	std::vector<pt::idx_t> low(n);
+	for (pt::idx_t v{n}; v-- > 0;) {
+		low[v] = v;
+		for (pt::idx_t be_idx : t.get_obe_idxs(v))
+			low[v] = std::min(low[v], t.get_be(be_idx).get_tgt());
+
+		for (pt::idx_t c : t.get_children(v)) {
+			sub_size[v] += sub_size[c];
+			low[v] = std::min(low[v], low[c]);
 		}
 	}
 
-	// convert the mini_stack to stack
-	for (auto it = mini_stack.begin(); it != mini_stack.end(); ++it) {
-		stack.emplace_back(*it);
+	regions_t rg;
+	std::vector<pt::idx_t> region(n, 0); // of each vertex
+	rg.heads.push_back(root_idx);
+	for (pt::idx_t v{}; v < n; ++v) {
+		if (v == root_idx)
+			continue;
+
+		pt::idx_t p = t.get_parent_v_idx(v);
+		if (low[v] >= p && sub_size[v] >= MIN_BLOCK_VTXS) {
+			region[v] = static_cast<pt::idx_t>(rg.heads.size());
+			rg.heads.push_back(v);
+		}
+		else {
+			region[v] = region[p];
+		}
 	}
-	stage.set_output_items(stack.size());
-	return;
+
+	const pt::idx_t region_count = static_cast<pt::idx_t>(rg.heads.size());
+
+	// a region waits for the highest region below it
+	std::vector<pt::idx_t> height(region_count, 0);
+	for (pt::idx_t r{region_count}; r-- > 1;) {
+		pt::idx_t up = region[t.get_parent_v_idx(rg.heads[r])];
+		height[up] = std::max(height[up], height[r] + 1);
+	}
+
+	for (pt::idx_t r{1}; r < region_count; ++r) {
+		if (rg.levels.size() <= height[r])
+			rg.levels.resize(height[r] + 1);
+		rg.levels[height[r]].push_back(r);
+	}
+
+	rg.offsets.assign(region_count + 1, 0);
+	for (pt::idx_t v{}; v < n; ++v)
+		rg.offsets[region[v] + 1]++;
+	for (pt::idx_t r{}; r < region_count; ++r)
+		rg.offsets[r + 1] += rg.offsets[r];
+
+	std::vector<pt::idx_t> fill(rg.offsets.begin(), rg.offsets.end() - 1);
+	rg.order.resize(n);
+	for (pt::idx_t v{n}; v-- > 0;)
+		rg.order[fill[region[v]]++] = v;
+
+	return rg;
 }
 
-void handle_vertex(pst::Tree &t, std::size_t v, std::vector<boundary> &hairpins,
-		   boundary &curr_bry, bool &in_hairpin,
-		   std::set<std::size_t> &articulated_vertices)
+/**
+ * @param head the head of the region of v, the source of a capping backedge
+ * that ends above it is added to @p escaped for the caller to link
+ */
+void handle_vertex(ceq_t &c, pt::idx_t v, pt::idx_t head,
+		   std::vector<pt::idx_t> &escaped)
 {
-	std::string fn_name =
-		pv_cmp::format("[povu::algorithms::{}]", __func__);
+	pst::Tree &t = c.t;
+
+	pt::idx_t seq{}; // classes created at v so far
+	auto new_class = [&]() -> std::uint64_t
+	{
+		return (static_cast<std::uint64_t>(v) << 32) | seq++;
+	};
 
 	/*
 	 * compute v.hi
@@ -513,9 +713,9 @@ void handle_vertex(pst::Tree &t, std::size_t v, std::vector<boundary> &hairpins,
 	 */
 
 	pt::idx_t hi_0{pc::INVALID_IDX};
-	std::set<pt::idx_t> obe = t.get_obe_tgt_v_idxs(v);
-	for (auto be : obe) {
-		hi_0 = std::min(hi_0, t.get_vertex(be).dfs_num());
+	for (pt::idx_t be_idx : t.get_obe_idxs(v)) {
+		pt::idx_t tgt = t.get_be(be_idx).get_tgt();
+		hi_0 = std::min(hi_0, t.get_vertex(tgt).dfs_num());
 	}
 
 	// given a node v find its child with the lowest hi value
@@ -524,17 +724,7 @@ void handle_vertex(pst::Tree &t, std::size_t v, std::vector<boundary> &hairpins,
 	// children are empty for dummy stop node
 
 	pt::idx_t hi_1{pc::INVALID_IDX};
-	std::set<std::size_t> children = t.get_children(v);
-
-	bool is_leaf = children.empty();
-	// insert current boundary into the boundary list
-	// if we are in a hairpin and
-	// if we are in a leaf or got to the root
-	if (in_hairpin && ((is_leaf && !t.is_root(v)) || t.is_root(v))) {
-		hairpins.push_back(std::move(curr_bry));
-		curr_bry = NULL_BOUNDARY;
-		in_hairpin = false;
-	}
+	pv_cmp::span<const pt::idx_t> children = t.get_children(v);
 
 	// a vector of pairs of hi values and children
 	std::vector<std::pair<std::size_t, std::size_t>> hi_and_child{};
@@ -565,94 +755,70 @@ void handle_vertex(pst::Tree &t, std::size_t v, std::vector<boundary> &hairpins,
 	// works because hi_and_child is sorted
 	std::size_t hi_2{pc::INVALID_IDX};
 	for (std::size_t child : children) {
-		if (child != hi_child && t.get_vertex(child).hi() < v &&
-		    articulated_vertices.find(child) ==
-			    articulated_vertices.end()) {
+		if (child != hi_child && t.get_vertex(child).hi() < v) {
 			hi_2 = t.get_vertex(child).hi();
 			break;
 		}
 	}
 
-	// std::cout << "\tcompute bracket list";
 	/*
 	 * compute bracket list
 	 * --------------------
 	 */
 
-	// the bracketlist was created in tree constructor
-	// if (children.size() > 1) {
-	// std::cerr << "many ~> " << children.size() << std::endl;
-	// }
-	for (auto c : children) {
-		t.concat_bracket_lists(v, c);
+	for (auto ch : children) {
+		c.bl.concat(v, ch);
 	}
 
-	// for each capping backedge TODO: add
-
 	// pop incoming backedges
 	// remove backedges we have reached the end of
-	std::set<std::size_t> ibe_idxs = t.get_ibe_idxs(v);
-	for (std::size_t b : ibe_idxs) {
-		t.del_bracket(v, b);
-
-		// TODO: set backedge class ?? was id not enough?
-		// do this in the del_bracket_method?
-		pst::BackEdge &be = t.get_backedge(b);
-		if (be.type() != pst::be_type_e::capping_back_edge &&
-		    !be.is_class_defined()) {
-			be.set_class(t.new_class());
+	for (pt::idx_t b : t.get_ibe_idxs(v)) {
+		c.bl.del(v, b);
+		if (c.be_cls[b] == NO_CLS)
+			c.be_cls[b] = new_class();
+	}
+
+	// a capping backedge gets no class when it ends
+	for (pt::idx_t s{c.cap_head[v]}; s != pc::INVALID_IDX; s = c.cap_next[s])
+		c.bl.del(v, c.cap_idx(s));
+
+	// the simplifying backedges end at the root, the last vertex's first
+	if (t.is_root(v)) {
+		for (pt::idx_t s{c.n}; s-- > v + 1;) {
+			if (!c.simplified[s])
+				continue;
+
+			c.bl.del(v, c.simp_idx(s));
+			if (c.be_cls[c.simp_idx(s)] == NO_CLS)
+				c.be_cls[c.simp_idx(s)] = new_class();
 		}
 	}
 
 	// push outgoing backedges
-	std::set<std::size_t> obe_i = t.get_obe_idxs(v);
-	for (std::size_t be_idx : obe_i) {
-		t.push(v, be_idx);
+	for (pt::idx_t be_idx : t.get_obe_idxs(v)) {
+		c.bl.push(v, be_idx, be_idx);
 	}
 
 	if (hi_2 < hi_0) {
 		// add a capping backedge
-		std::size_t dest_v = hi_2;
-		std::size_t be_idx =
-			t.add_be(v, dest_v, pst::be_type_e::capping_back_edge);
-		t.push(v, be_idx);
-	}
-
-	if (t.get_bracket_list(v).empty()) {
-		std::size_t dest_v = t.get_root_idx();
-		if (t.get_vertex(v).type() != pgt::v_type_e::dummy) {
-			// std::cerr << "add art be " << t.get_vertex(v).name()
-			// << " " << dest_v << std::endl;
-			if (curr_bry.b1 != pc::INVALID_IDX) {
-				std::cerr
-					<< fn_name
-					<< "WARN: curr boundary already set\n";
-			}
-			curr_bry.b1 = t.get_vertex(v).g_v_id();
-			// std::cerr << "Found hairpin boundary start " <<
-			// t.get_vertex(v).g_v_id() << std::endl;
-		}
+		c.cap_tgt[v] = static_cast<pt::idx_t>(hi_2);
+		c.bl.push(v, c.cap_idx(v), c.cap_idx(v));
+
+		if (hi_2 >= head)
+			c.link_cap(v);
+		else
+			escaped.push_back(v);
+	}
 
+	if (c.bl.size(v) == 0) {
 		// add a simplifying back edge
-		std::size_t be_idx = t.add_be(
-			v, dest_v, pst::be_type_e::simplifying_back_edge);
-		t.push(v, be_idx);
+		c.simplified[v] = 1;
+		c.bl.push(v, c.simp_idx(v), c.simp_idx(v));
 		t.get_vertex_mut(v).set_hi(t.get_root_idx());
-
-		in_hairpin = true;
 	}
-	else if (in_hairpin) {
-
-		pst::Bracket &b = t.top(v);
-
-		std::size_t b_id = b.back_edge_id();
-		pst::BackEdge &be = t.get_backedge_ref_given_id(b_id);
-
-		// extend the end boudary of the current hairpin
-		if (be.type() == pst::be_type_e::simplifying_back_edge) {
-			// boundary = v;
-			curr_bry.b2 = t.get_vertex(v).g_v_id();
-		}
+	else {
+		c.top_simplifying[v] =
+			c.bl.top(v).back_edge_id() >= c.simp_idx(0);
 	}
 
 	/*
@@ -665,28 +831,126 @@ void handle_vertex(pst::Tree &t, std::size_t v, std::vector<boundary> &hairpins,
 
 		/*default behavior*/
 
-		pst::Bracket &b = t.top(v);
+		pbl::Bracket &b = c.bl.top(v);
 
-		if (t.list_size(v) != b.recent_size()) {
-			b.set_recent_size(t.list_size(v));
-			b.set_recent_class(t.new_class());
+		if (c.bl.size(v) != b.recent_size()) {
+			b.set_recent_size(c.bl.size(v));
+			b.set_recent_class(new_class());
 		}
 
 		// when retreating out of a node the tree edge is labelled with
 		// the class of the topmost bracket in the bracket stack
-		pst::Edge &e = t.get_incoming_edge(v);
-		e.set_class(b.recent_class());
+		c.e_cls[v] = b.recent_class();
 
 		/*check for e, b equivalance*/
-		if (b.recent_size() == 1) {
-			std::size_t b_id = b.back_edge_id();
-			pst::BackEdge &be = t.get_backedge_ref_given_id(b_id);
-			be.set_class(e.get_class());
+		if (b.recent_size() == 1)
+			c.be_cls[b.back_edge_id()] = c.e_cls[v];
+	}
+
+	c.cls_count[v] = seq;
+}
+
+/**
+ * add the capping and simplifying backedges to the tree and set the classes
+ * of its edges, numbered in the order they were created
+ */
+void set_classes(ceq_t &c)
+{
+	pst::Tree &t = c.t;
+
+	// the first class created at each vertex
+	std::vector<pt::idx_t> &first = c.cls_count;
+	pt::idx_t next{};
+	for (pt::idx_t v{c.n}; v-- > 0;) {
+		pt::idx_t count = first[v];
+		first[v] = next;
+		next += count;
+	}
+
+	auto number = [&](std::uint64_t cls) -> pt::idx_t
+	{
+		return first[cls >> 32] + static_cast<pt::idx_t>(cls);
+	};
+
+	auto set_be_class = [&](pt::idx_t b, pt::idx_t be_idx)
+	{
+		if (c.be_cls[b] != NO_CLS)
+			t.get_backedge(be_idx).set_class(number(c.be_cls[b]));
+	};
+
+	for (pt::idx_t b{}; b < c.be_count; ++b)
+		set_be_class(b, b);
+
+	for (pt::idx_t v{c.n}; v-- > 0;) {
+		if (!t.is_root(v))
+			t.get_incoming_edge(v).set_class(number(c.e_cls[v]));
+
+		if (c.cap_tgt[v] != pc::INVALID_IDX)
+			set_be_class(c.cap_idx(v),
+				     t.add_be(v, c.cap_tgt[v],
+					      pst::be_type_e::capping_back_edge));
+
+		if (c.simplified[v])
+			set_be_class(
+				c.simp_idx(v),
+				t.add_be(v, t.get_root_idx(),
+					 pst::be_type_e::simplifying_back_edge));
+	}
+}
+
+// the hairpin boundaries, in the order the vertices were handled
+void find_hairpins(const ceq_t &c, std::vector<boundary> &hairpins)
+{
+	std::string fn_name =
+		pv_cmp::format("[povu::algorithms::{}]", __func__);
+
+	const pst::Tree &t = c.t;
+
+	bool in_hairpin{false};
+	boundary curr_bry{NULL_BOUNDARY}; // current_boundary
+
+	for (pt::idx_t v{c.n}; v-- > 0;) {
+		const pst::Vertex &vtx = t.get_vertex(v);
+
+		// insert current boundary into the boundary list
+		// if we are in a hairpin and
+		// if we are in a leaf or got to the root
+		if (in_hairpin && (vtx.is_leaf() || vtx.is_root())) {
+			hairpins.push_back(curr_bry);
+			curr_bry = NULL_BOUNDARY;
+			in_hairpin = false;
+		}
+
+		if (c.simplified[v]) {
+			if (vtx.type() != pgt::v_type_e::dummy) {
+				if (curr_bry.b1 != pc::INVALID_IDX) {
+					std::cerr << fn_name
+						  << "WARN: curr boundary "
+						     "already set\n";
+				}
+				curr_bry.b1 = vtx.g_v_id();
+			}
+
+			in_hairpin = true;
+		}
+		else if (in_hairpin && c.top_simplifying[v]) {
+			// extend the end boudary of the current hairpin
+			curr_bry.b2 = vtx.g_v_id();
 		}
 	}
 }
+} // namespace
 
-void simple_cycle_equiv(pst::Tree &t, const core::config &app_config)
+/**
+ * find the cycle equivalence classes of @p t, on @p pool when it is large
+ *
+ * The regions of one level run in parallel, but a block waits for the blocks
+ * nested in it, so a chain of blocks along one path of the tree runs in
+ * order. A component that is one long chain stays serial, and that is the
+ * common case since the tips join the spine to the dummy root.
+ */
+void simple_cycle_equiv(pst::Tree &t, const core::config &app_config,
+			pth::thread_pool *pool)
 {
 	stage_cost::Scope stage{
 		stage_cost::Stage::cycle_class_assignment,
@@ -696,34 +960,74 @@ void simple_cycle_equiv(pst::Tree &t, const core::config &app_config)
 	std::string fn_name =
 		pv_cmp::format("[povu::algorithms::{}]", __func__);
 
-	std::set<std::size_t> articulated_vertices;
+	const pt::idx_t n = t.vtx_count();
 
-	std::vector<boundary> boundaries;
-	boundaries.reserve(EXPECTED_HAIRPIN_COUNT);
-	bool in_hairpin{false};
-	boundary curr_bry{NULL_BOUNDARY}; // current_boundary
+	{
+		ceq_t c{t};
 
-	for (pt::idx_t v{t.vtx_count() - 1}; v < pc::MAX_IDX; --v) {
-		handle_vertex(t, v, boundaries, curr_bry, in_hairpin,
-			      articulated_vertices);
-	}
+		if (pool == nullptr || n < 2 * MIN_BLOCK_VTXS) {
+			std::vector<pt::idx_t> escaped; // stays empty
+			for (pt::idx_t v{n}; v-- > 0;)
+				handle_vertex(c, v, t.get_root_idx(), escaped);
+		}
+		else {
+			regions_t rg = find_regions(t);
+			std::vector<std::vector<pt::idx_t>> escaped(
+				rg.heads.size());
+
+			auto handle_region = [&](pt::idx_t r)
+			{
+				for (pt::idx_t i{rg.offsets[r]};
+				     i < rg.offsets[r + 1]; ++i)
+					handle_vertex(c, rg.order[i],
+						      rg.heads[r], escaped[r]);
+			};
+
+			for (const std::vector<pt::idx_t> &level : rg.levels) {
+				pth::for_chunks(
+					pool, level.size(),
+					[&](pt::idx_t first, pt::idx_t last)
+					{
+						for (pt::idx_t i{first};
+						     i < last; ++i)
+							handle_region(level[i]);
+					});
+
+				// they end in the regions of a later level
+				for (pt::idx_t r : level)
+					for (pt::idx_t s : escaped[r])
+						c.link_cap(s);
+			}
+
+			handle_region(0);
+		}
 
-	// print boundaries
-	if (app_config.inc_hairpins()) {
-		for (auto b : boundaries) {
-			std::cerr << "Boundary: " << b.b1 << " " << b.b2
-				  << std::endl;
+		set_classes(c);
+
+		std::vector<boundary> boundaries;
+		boundaries.reserve(EXPECTED_HAIRPIN_COUNT);
+		find_hairpins(c, boundaries);
+
+		// print boundaries
+		if (app_config.inc_hairpins()) {
+			for (auto b : boundaries) {
+				std::cerr << "Boundary: " << b.b1 << " "
+					  << b.b2 << std::endl;
+			}
 		}
 	}
+
 	stage.set_output_items(t.tree_edge_count() + t.back_edge_count());
 }
 
-pvst::Tree find_flubbles(pst::Tree &st, const core::config &app_config)
+pvst::Tree find_flubbles(pst::Tree &st, const core::config &app_config,
+			 pth::thread_pool *pool)
 {
 	std::string fn_name =
 		pv_cmp::format("[povu::algorithms::{}]", __func__);
 
-	simple_cycle_equiv(st, app_config);
+	simple_cycle_equiv(st, app_config, pool);
+	st.freeze();
 
 	eq_class_stack_t ecs{st.tree_edge_count()};
 	{
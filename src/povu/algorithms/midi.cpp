@@ -5,7 +5,7 @@
 #include <memory>    // for make_unique
 #include <stdexcept> // for runtime_error
 #include <string>    // for basic_string, string
-#include <utility>   // for get, pair
+#include <utility>   // for get, pair, move
 #include <vector>    // for vector
 
 #include "fmt/core.h"		  // for format
@@ -26,7 +26,9 @@ void add_midi(const ptu::tree_meta &tm,
 	const std::vector<pt::idx_t> &depth = tm.depth;
 
 	for (auto &[ft_v_idx, bubs] : midis) {
-		std::vector<pt::idx_t> ch = pvst.get_children(ft_v_idx);
+		// a copy, nesting changes the children of ft_v_idx
+		pv_cmp::span<const pt::idx_t> ch_s = pvst.get_children(ft_v_idx);
+		std::vector<pt::idx_t> ch(ch_s.begin(), ch_s.end());
 
 		for (const pvst::MidiBubble &b : bubs) {
 			auto [md_upper, md_lower] =
@@ -222,45 +224,50 @@ std::vector<pvst::MidiBubble> handle_fl(const pst::Tree &st,
 	return res;
 }
 
-void find_midi(const pst::Tree &st, pvst::Tree &pvst, const ptu::tree_meta &tm)
+std::vector<pvst::MidiBubble> find_in_flubble(const pst::Tree &st,
+					      const pvst::Tree &pvst,
+					      pt::idx_t ft_v_idx)
 {
 	const std::string fn_name{pv_cmp::format("[{}::{}]", MODULE, __func__)};
 
-	std::map<pt::idx_t, std::vector<pvst::MidiBubble>> x;
-	for (pt::idx_t ft_v_idx{}; ft_v_idx < pvst.vtx_count(); ft_v_idx++) {
-		const pvst::VertexBase &pvst_v = pvst.get_vertex(ft_v_idx);
+	const pvst::VertexBase &pvst_v = pvst.get_vertex(ft_v_idx);
 
-		if (pvst_v.get_fam() != pvst::vt_e::flubble) {
-			continue;
-		}
+	if (pvst_v.get_fam() != pvst::vt_e::flubble) {
+		return {};
+	}
 
-		std::vector<pt::idx_t> c_bubs; // the concealed bubbles
-		for (auto c_v_idx_pvst : pvst.get_children(ft_v_idx)) {
-			const pvst::VertexBase &c_v =
-				pvst.get_vertex(c_v_idx_pvst);
-			if (c_v.get_fam() == pvst::vt_e::concealed) {
-				c_bubs.push_back(c_v_idx_pvst);
-			}
+	std::vector<pt::idx_t> c_bubs; // the concealed bubbles
+	for (auto c_v_idx_pvst : pvst.get_children(ft_v_idx)) {
+		const pvst::VertexBase &c_v = pvst.get_vertex(c_v_idx_pvst);
+		if (c_v.get_fam() == pvst::vt_e::concealed) {
+			c_bubs.push_back(c_v_idx_pvst);
 		}
+	}
 
-		if (c_bubs.size() < 2) {
-			continue;
-		}
+	if (c_bubs.size() < 2) {
+		return {};
+	}
 
-		const pvst::Flubble &fl_v =
-			static_cast<const pvst::Flubble &>(pvst_v);
+	const pvst::Flubble &fl_v = static_cast<const pvst::Flubble &>(pvst_v);
 
-		try {
-			std::vector<pvst::MidiBubble> res =
-				handle_fl(st, pvst, fl_v, c_bubs);
-			if (!res.empty()) {
-				x[ft_v_idx] = res;
-			}
-		}
-		catch (const std::exception &e) {
-			WARN("{} Failed to handle flubble {}: {}", fn_name,
-			     ft_v_idx, e.what());
-			continue;
+	try {
+		return handle_fl(st, pvst, fl_v, c_bubs);
+	}
+	catch (const std::exception &e) {
+		WARN("{} Failed to handle flubble {}: {}", fn_name, ft_v_idx,
+		     e.what());
+		return {};
+	}
+}
+
+void find_midi(const pst::Tree &st, pvst::Tree &pvst, const ptu::tree_meta &tm)
+{
+	std::map<pt::idx_t, std::vector<pvst::MidiBubble>> x;
+	for (pt::idx_t ft_v_idx{}; ft_v_idx < pvst.vtx_count(); ft_v_idx++) {
+		std::vector<pvst::MidiBubble> res =
+			find_in_flubble(st, pvst, ft_v_idx);
+		if (!res.empty()) {
+			x[ft_v_idx] = std::move(res);
 		}
 	}
 
@@ -260,6 +260,12 @@ bool in_branch(const pst::Tree &st, const ptu::tree_meta &tm,
 	return false;
 }
 
+bool is_parallel(const pst::Tree &st, const ptu::tree_meta &tm,
+		 const pvst::Flubble &ft_v)
+{
+	return in_branch(st, tm, ft_v) || in_trunk(st, ft_v);
+}
+
 void find_parallel(const pst::Tree &st, pvst::Tree &ft,
 		   const ptu::tree_meta &tm)
 {
@@ -278,7 +284,7 @@ void find_parallel(const pst::Tree &st, pvst::Tree &ft,
 
 		pvst::Flubble &ft_v = static_cast<pvst::Flubble &>(pvst_v);
 
-		if (in_branch(st, tm, ft_v) || in_trunk(st, ft_v)) {
+		if (is_parallel(st, tm, ft_v)) {
 			ft_v.set_type(pvst::vt_e::parallel);
 			// std::cerr << fn_name << ": Found parallel flubble at
 			// " << ft_v.as_str() << "\n";
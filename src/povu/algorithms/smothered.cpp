@@ -7,7 +7,7 @@
 #include <set>		 // for set
 #include <string>	 // for char_traits, basic_string, string
 #include <unordered_set> // for unordered_set
-#include <utility>	 // for get, pair
+#include <utility>	 // for get, pair, move
 #include <vector>	 // for vector
 
 #include "fmt/core.h"		  // for format
@@ -17,23 +17,6 @@
 namespace povu::smothered
 {
 
-struct fl_sls {
-	pt::idx_t cn_v_idx;
-	std::vector<pvst::Smothered> g_adj;
-	std::vector<pvst::Smothered> s_adj;
-
-	pt::idx_t size() const
-	{
-		return g_adj.size() + s_adj.size();
-	}
-
-	// Constructor for fl_sls
-	fl_sls(pt::idx_t cn_v_idx_)
-	    : cn_v_idx(cn_v_idx_), g_adj(std::vector<pvst::Smothered>{}),
-	      s_adj(std::vector<pvst::Smothered>{})
-	{}
-};
-
 pvst::bounds_t compute_bounds(const pst::Tree &st, pt::idx_t cn_st_idx,
 			      pt::idx_t sm_st_idx)
 {
@@ -146,7 +129,7 @@ void branch(const pst::Tree &st, const pvst::Tree &pvst,
 	pt::idx_t ai_st_idx = fl_v.get_ai();
 	// pt::idx_t ai_st_idx = ft_v.get_ai();
 	pt::idx_t sl_st_idx = ft_v.get_sl_st_idx();
-	std::set<pt::idx_t> tgts = st.get_obe_tgt_v_idxs(sl_st_idx);
+	pv_cmp::span<const pt::idx_t> tgts = st.get_obe_tgt_v_idxs(sl_st_idx);
 
 	if (tgts.size() != 1) {
 		return;
@@ -286,7 +269,7 @@ void branch(const pst::Tree &st, const pvst::Tree &pvst,
 	pt::idx_t zi_st_idx = fl_v.get_zi();
 	pt::idx_t sl_st_idx = ft_v.get_sl_st_idx();
 
-	std::set<pt::idx_t> srcs = st.get_ibe_src_v_idxs(sl_st_idx);
+	pv_cmp::span<const pt::idx_t> srcs = st.get_ibe_src_v_idxs(sl_st_idx);
 
 	if (srcs.empty()) {
 		return; // no srcs
@@ -340,7 +323,11 @@ void nest(const pst::Tree &st, pvst::Tree &pvst, pt::idx_t cn_pvst_v_idx,
 	const pvst::Smothered &smo_v = static_cast<const pvst::Smothered &>(
 		pvst.get_vertex(smo_pvst_v_idx));
 
-	for (pt::idx_t c_v_idx : pvst.get_children(cn_pvst_v_idx)) {
+	// a copy, nesting changes the children of cn_pvst_v_idx
+	pv_cmp::span<const pt::idx_t> ch_s = pvst.get_children(cn_pvst_v_idx);
+	std::vector<pt::idx_t> ch(ch_s.begin(), ch_s.end());
+
+	for (pt::idx_t c_v_idx : ch) {
 
 		const pvst::VertexBase &pvst_v = pvst.get_vertex(c_v_idx);
 
@@ -382,48 +369,53 @@ void add_smothered(const pst::Tree &st, pvst::Tree &pvst,
 	return;
 }
 
-void find_smothered(const pst::Tree &st, pvst::Tree &ft,
-		    const ptu::tree_meta &tm)
+fl_sls find_in_concealed(const pst::Tree &st, const pvst::Tree &pvst,
+			 const ptu::tree_meta &tm, pt::idx_t ft_v_idx)
 {
 	const std::string fn_name{pv_cmp::format("[{}::{}]", MODULE, __func__)};
 
-	pvst::Tree &pvst = ft;
+	fl_sls smo{ft_v_idx};
 
-	std::vector<fl_sls> all_smo;
+	const pvst::VertexBase &pvst_v = pvst.get_vertex(ft_v_idx);
 
-	for (pt::idx_t ft_v_idx{}; ft_v_idx < ft.vtx_count(); ft_v_idx++) {
-		const pvst::VertexBase &pvst_v = ft.get_vertex(ft_v_idx);
+	if (pvst_v.get_fam() != pvst::vf_e::concealed) {
+		return smo;
+	}
 
-		if (pvst_v.get_fam() != pvst::vf_e::concealed) {
-			continue;
-		}
+	const pvst::Concealed &cn_v =
+		static_cast<const pvst::Concealed &>(pvst_v);
+
+	switch (cn_v.get_sl_type()) {
+	case pvst::cl_e::ai_trunk:
+		g::trunk(st, pvst, cn_v, ft_v_idx, tm, smo.g_adj);
+		break;
+	case pvst::cl_e::ai_branch:
+		g::branch(st, pvst, cn_v, ft_v_idx, tm, smo.g_adj);
+		break;
+	case pvst::cl_e::zi_trunk:
+		s::trunk(st, pvst, cn_v, ft_v_idx, tm, smo.s_adj);
+		break;
+	case pvst::cl_e::zi_branch:
+		s::branch(st, pvst, cn_v, ft_v_idx, smo.s_adj);
+		break;
+	default:
+		std::cerr << fn_name << " unknown slubble type: " << ft_v_idx
+			  << "\n";
+		break;
+	}
 
-		const pvst::Concealed &cn_v =
-			static_cast<const pvst::Concealed &>(pvst_v);
-
-		fl_sls smo{ft_v_idx};
-		switch (cn_v.get_sl_type()) {
-		case pvst::cl_e::ai_trunk:
-			g::trunk(st, pvst, cn_v, ft_v_idx, tm, smo.g_adj);
-			break;
-		case pvst::cl_e::ai_branch:
-			g::branch(st, pvst, cn_v, ft_v_idx, tm, smo.g_adj);
-			break;
-		case pvst::cl_e::zi_trunk:
-			s::trunk(st, pvst, cn_v, ft_v_idx, tm, smo.s_adj);
-			break;
-		case pvst::cl_e::zi_branch:
-			s::branch(st, pvst, cn_v, ft_v_idx, smo.s_adj);
-			break;
-		default:
-			std::cerr << fn_name
-				  << " unknown slubble type: " << ft_v_idx
-				  << "\n";
-			continue; // skip this vertex
-		}
+	return smo;
+}
 
+void find_smothered(const pst::Tree &st, pvst::Tree &ft,
+		    const ptu::tree_meta &tm)
+{
+	std::vector<fl_sls> all_smo;
+
+	for (pt::idx_t ft_v_idx{}; ft_v_idx < ft.vtx_count(); ft_v_idx++) {
+		fl_sls smo = find_in_concealed(st, ft, tm, ft_v_idx);
 		if (smo.size() > 0) {
-			all_smo.push_back(smo);
+			all_smo.push_back(std::move(smo));
 		}
 	}
 
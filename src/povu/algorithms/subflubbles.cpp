@@ -0,0 +1,154 @@
+#include "povu/algorithms/subflubbles.hpp"
+
+#include <map>	    // for map
+#include <string>  // for basic_string, string
+#include <utility> // for move
+#include <vector>  // for vector
+
+#include "fmt/core.h"			 // for format
+#include "povu/algorithms/concealed.hpp" // for find_in_flubble, fl_sls
+#include "povu/algorithms/midi.hpp"	 // for find_in_flubble, add_midi
+#include "povu/algorithms/parallel.hpp"	 // for is_parallel
+#include "povu/algorithms/smothered.hpp" // for find_in_concealed
+#include "povu/algorithms/tiny.hpp"	 // for is_tiny
+#include "povu/common/compat.hpp"	 // for format, pv_cmp
+#include "povu/common/thread.hpp"	 // for thread_pool, for_chunks
+
+namespace povu::subflubbles
+{
+namespace pcl = povu::concealed;
+namespace pmd = povu::midi;
+namespace psm = povu::smothered;
+namespace pth = povu::thread;
+
+namespace
+{
+// a PVST with fewer flubbles is not split across threads
+constexpr pt::idx_t MIN_PAR_FLUBBLES = 1 << 12;
+} // namespace
+
+void find_subflubbles(const pst::Tree &st, pvst::Tree &ft,
+		      const ptu::tree_meta &tm, pth::thread_pool *pool)
+{
+	const std::string fn_name{pv_cmp::format("[{}::{}]", MODULE, __func__)};
+
+	const pt::idx_t fl_count = ft.vtx_count();
+
+	if (fl_count < MIN_PAR_FLUBBLES) {
+		pool = nullptr;
+	}
+
+	// tiny, parallel and concealed in one pass over the flubbles, each
+	// flubble only writes to its own vertex and slot
+	std::vector<pcl::fl_sls> all_slubbles(fl_count);
+	auto in_flubbles = [&](pt::idx_t first, pt::idx_t last)
+	{
+		for (pt::idx_t ft_v_idx{first}; ft_v_idx < last; ft_v_idx++) {
+			pvst::VertexBase &pvst_v = ft.get_vertex_mut(ft_v_idx);
+
+			if (pvst_v.get_fam() != pvst::vt_e::flubble) {
+				continue;
+			}
+
+			pvst::Flubble &ft_v =
+				static_cast<pvst::Flubble &>(pvst_v);
+
+			// a tiny flubble is not checked for parallel edges
+			if (ft.is_leaf(ft_v_idx)) {
+				if (povu::tiny::is_tiny(st, tm, ft_v)) {
+					ft_v.set_type(pvst::vt_e::tiny);
+				}
+				else if (povu::parallel::is_parallel(st, tm,
+								     ft_v)) {
+					ft_v.set_type(pvst::vt_e::parallel);
+				}
+			}
+
+			// tiny and parallel flubbles hold no concealed bubbles
+			if (ft_v.get_fam() != pvst::vt_e::flubble) {
+				continue;
+			}
+
+			all_slubbles[ft_v_idx] =
+				pcl::find_in_flubble(st, tm, ft_v_idx, ft_v);
+		}
+	};
+	pth::for_chunks(pool, fl_count, in_flubbles);
+
+	// the concealed vertices are added at the end of the PVST
+	const pt::idx_t cn_first = ft.vtx_count();
+	for (const pcl::fl_sls &sl : all_slubbles) {
+		if (sl.size() > 0) {
+			pcl::update_pvst::add_concealed(st, ft, tm, sl);
+		}
+	}
+	const pt::idx_t cn_last = ft.vtx_count();
+	std::vector<pcl::fl_sls>().swap(all_slubbles);
+
+	/*
+	  midi bubbles, only a flubble with two concealed children can hold one.
+	  Those are counted once all the concealed vertices are in, nesting can
+	  move a concealed vertex from the flubble it was found in to a child
+	  flubble
+	*/
+	auto concealed_count = [&](pt::idx_t ft_v_idx)
+	{
+		pt::idx_t count{};
+		for (pt::idx_t c_v_idx : ft.get_children(ft_v_idx)) {
+			if (ft.get_vertex(c_v_idx).get_fam() ==
+			    pvst::vt_e::concealed) {
+				count++;
+			}
+		}
+		return count;
+	};
+
+	std::vector<pt::idx_t> midi_candidates;
+	for (pt::idx_t ft_v_idx{}; ft_v_idx < cn_first; ft_v_idx++) {
+		if (ft.get_vertex(ft_v_idx).get_fam() == pvst::vt_e::flubble &&
+		    concealed_count(ft_v_idx) > 1) {
+			midi_candidates.push_back(ft_v_idx);
+		}
+	}
+
+	std::vector<std::vector<pvst::MidiBubble>> midi_res(
+		midi_candidates.size());
+	auto in_candidates = [&](pt::idx_t first, pt::idx_t last)
+	{
+		for (pt::idx_t i{first}; i < last; i++) {
+			pt::idx_t ft_v_idx = midi_candidates[i];
+			midi_res[i] = pmd::find_in_flubble(st, ft, ft_v_idx);
+		}
+	};
+	pth::for_chunks(pool, midi_candidates.size(), in_candidates);
+
+	std::map<pt::idx_t, std::vector<pvst::MidiBubble>> midis;
+	for (pt::idx_t i{}; i < midi_candidates.size(); i++) {
+		if (!midi_res[i].empty()) {
+			midis[midi_candidates[i]] = std::move(midi_res[i]);
+		}
+	}
+	pmd::add_midi(tm, midis, ft);
+
+	// smothered bubbles in the concealed vertices added above
+	std::vector<psm::fl_sls> all_smo;
+	all_smo.reserve(cn_last - cn_first);
+	for (pt::idx_t ft_v_idx{cn_first}; ft_v_idx < cn_last; ft_v_idx++) {
+		all_smo.emplace_back(ft_v_idx);
+	}
+
+	auto in_concealed = [&](pt::idx_t first, pt::idx_t last)
+	{
+		for (pt::idx_t i{first}; i < last; i++) {
+			all_smo[i] = psm::find_in_concealed(st, ft, tm,
+							    cn_first + i);
+		}
+	};
+	pth::for_chunks(pool, all_smo.size(), in_concealed);
+
+	auto no_smo = [](const psm::fl_sls &smo) { return smo.size() == 0; };
+	pv_cmp::erase_if(all_smo, no_smo);
+	psm::add_smothered(st, ft, all_smo);
+}
+
+} // namespace povu::subflubbles
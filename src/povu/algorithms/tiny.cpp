@@ -97,6 +97,19 @@ bool trunk(const pst::Tree &st, pt::idx_t ai, pt::idx_t zi)
 	return false;
 }
 
+bool is_tiny(const pst::Tree &st, const ptu::tree_meta &tm,
+	     const pvst::Flubble &ft_v)
+{
+	pt::idx_t ai = ft_v.get_ai();
+	pt::idx_t zi = ft_v.get_zi();
+
+	if (!(zi - ai == 1 || zi - ai == 3)) {
+		return false;
+	}
+
+	return trunk(st, ai, zi) || branches(st, tm, ai, zi);
+}
+
 void find_tiny(const pst::Tree &st, pvst::Tree &ft, const ptu::tree_meta &tm)
 {
 	const std::string fn_name{pv_cmp::format("[{}::{}]", MODULE, __func__)};
@@ -115,14 +128,7 @@ void find_tiny(const pst::Tree &st, pvst::Tree &ft, const ptu::tree_meta &tm)
 
 		pvst::Flubble &ft_v = static_cast<pvst::Flubble &>(pvst_v);
 
-		pt::idx_t ai = ft_v.get_ai();
-		pt::idx_t zi = ft_v.get_zi();
-
-		if (!(zi - ai == 1 || zi - ai == 3)) {
-			continue;
-		}
-
-		if (trunk(st, ai, zi) || branches(st, tm, ai, zi)) {
+		if (is_tiny(st, tm, ft_v)) {
 			ft_v.set_type(pvst::vt_e::tiny);
 		}
 	}
@@ -0,0 +1,57 @@
+#include "povu/common/arena.hpp"
+
+#include <algorithm> // for max
+#include <utility>   // for move
+
+namespace povu::arena
+{
+
+// --------------
+// constructor(s)
+// --------------
+
+Arena::Arena(std::size_t initial_size)
+    : next_block_size_{std::max(initial_size, MIN_BLOCK_SIZE)}
+{}
+
+// ---------
+// getter(s)
+// ---------
+
+std::size_t Arena::used() const
+{
+	return this->used_;
+}
+
+std::size_t Arena::block_count() const
+{
+	return this->blocks_.size();
+}
+
+// ---------
+// setter(s)
+// ---------
+
+void *Arena::grow(std::size_t n, std::size_t align)
+{
+	// room for the allocation wherever the block starts
+	std::size_t size = std::max(this->next_block_size_, n + align);
+
+	std::unique_ptr<std::byte[]> block{new std::byte[size]};
+	this->cur_ = block.get();
+	this->left_ = size;
+	this->blocks_.push_back(std::move(block));
+	this->next_block_size_ = size * 2;
+
+	return this->allocate(n, align);
+}
+
+void Arena::release()
+{
+	this->blocks_.clear();
+	this->cur_ = nullptr;
+	this->left_ = 0;
+	this->used_ = 0;
+}
+
+} // namespace povu::arena
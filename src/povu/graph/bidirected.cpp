@@ -1,10 +1,14 @@
 #include "povu/graph/bidirected.hpp"
 
-#include <algorithm>	 // for lower_bound
-#include <stack>	 // for stack
+#include <algorithm>	 // for equal_range, sort, stable_sort, max, min
+#include <atomic>	 // for atomic
+#include <cstdint>	 // for uint64_t
+#include <memory>	 // for make_shared, shared_ptr
+#include <numeric>	 // for iota
+#include <stdexcept>	 // for logic_error
 #include <string>	 // for basic_string, char_traits, string
 #include <string_view>	 // for string_view
-#include <unordered_set> // for unordered_set, operator!=
+#include <utility>	 // for move, swap
 #include <vector>
 
 #include "fmt/core.h"		     // for format
@@ -13,6 +17,7 @@
 #include "povu/common/constants.hpp" // for UNDEFINED_ID
 #include "povu/common/core.hpp"
 #include "povu/common/stage_cost.hpp"
+#include "povu/common/thread.hpp" // for thread_pool, task_group
 #include "povu/graph/types.hpp" // for v_end_e, side_n_id_t, complement
 
 namespace povu::bidirected
@@ -85,8 +90,10 @@ pgt::side_n_idx_t Edge::get_other_vtx(pt::idx_t v_idx, pgt::v_end_e ve) const
 // constructor(s)
 // --------------
 
-Vertex::Vertex(pt::id_t v_id, const std::string &label)
-    : v_id_{v_id}, label_(label)
+Vertex::Vertex(pt::id_t v_id, const LabelStore *labels, pt::idx_t label_idx,
+	       pa::Arena *arena)
+    : v_id_{v_id}, labels_{labels}, label_idx_{label_idx}, e_l{arena},
+      e_r{arena}
 {}
 
 // ---------
@@ -98,43 +105,222 @@ pt::id_t Vertex::id() const
 	return v_id_;
 }
 
-const std::string &Vertex::get_label() const
+pt::idx_t Vertex::get_label_idx() const
 {
-	return this->label_;
+	return this->label_idx_;
+}
+
+std::string Vertex::get_label() const
+{
+	std::string label;
+	this->append_label(label);
+	return label;
 }
 
 pt::u32 Vertex::get_length() const
 {
-	return this->label_.length();
+	if (this->labels_ == nullptr)
+		return 0;
+
+	return this->labels_->length(this->label_idx_);
 }
 
 std::string Vertex::get_rc_label() const
 {
-	return pu::reverse_complement(this->label_);
+	std::string rc_label;
+	this->append_rc_label(rc_label);
+	return rc_label;
+}
+
+void Vertex::append_label(std::string &out) const
+{
+	if (this->labels_ != nullptr)
+		this->labels_->append(this->label_idx_, out);
+}
+
+void Vertex::append_rc_label(std::string &out) const
+{
+	if (this->labels_ != nullptr)
+		this->labels_->append_rc(this->label_idx_, out);
 }
 
-const std::set<pt::idx_t> &Vertex::get_edges_l() const
+pv_cmp::span<const pt::idx_t> Vertex::get_edges_l() const
 {
-	return e_l;
+	return this->e_l.empty() ? this->csr_l_
+				 : pv_cmp::span<const pt::idx_t>{
+					   this->e_l.data(), this->e_l.size()};
 }
 
-const std::set<pt::idx_t> &Vertex::get_edges_r() const
+pv_cmp::span<const pt::idx_t> Vertex::get_edges_r() const
 {
-	return e_r;
+	return this->e_r.empty() ? this->csr_r_
+				 : pv_cmp::span<const pt::idx_t>{
+					   this->e_r.data(), this->e_r.size()};
 }
 
 // ---------
 // setter(s)
 // ---------
 
+// edges are added in increasing index order so appending keeps the vectors
+// sorted, the check only skips the second end of a self loop on one side
 void Vertex::add_edge_l(pt::idx_t e_idx)
 {
-	e_l.insert(e_idx);
+	if (e_l.empty() || e_l.back() != e_idx)
+		e_l.push_back(e_idx);
 }
 
 void Vertex::add_edge_r(pt::idx_t e_idx)
 {
-	e_r.insert(e_idx);
+	if (e_r.empty() || e_r.back() != e_idx)
+		e_r.push_back(e_idx);
+}
+
+void Vertex::freeze(pv_cmp::span<const pt::idx_t> l,
+		    pv_cmp::span<const pt::idx_t> r)
+{
+	this->csr_l_ = l;
+	this->csr_r_ = r;
+	pa::vector<pt::idx_t>().swap(this->e_l);
+	pa::vector<pt::idx_t>().swap(this->e_r);
+}
+
+// ============================================================
+//      Vertex Id Map
+// ============================================================
+
+std::string_view to_str(id_map_e m)
+{
+	switch (m) {
+	case id_map_e::dense:
+		return "dense";
+	case id_map_e::flat:
+		return "flat";
+	case id_map_e::hashed:
+		return "hashed";
+	default:
+		return "?";
+	}
+}
+
+VertexIdMap VertexIdMap::from_parts(id_map_e mode, pt::id_t base,
+				       pv_cmp::span<const pt::id_t> idx_to_id,
+				       pv_cmp::span<const pt::idx_t> flat)
+{
+	VertexIdMap m;
+	m.mode_ = mode;
+	m.base_ = base;
+	m.idx_to_id_ = idx_to_id;
+	if (mode == id_map_e::flat)
+		m.flat_ = flat;
+
+	if (mode == id_map_e::hashed) {
+		m.hashed_.reserve(idx_to_id.size());
+		for (pt::idx_t v_idx{}; v_idx < idx_to_id.size(); ++v_idx)
+			m.hashed_[idx_to_id[v_idx]] = v_idx;
+	}
+
+	return m;
+}
+
+bool VertexIdMap::fits_flat(std::uint64_t span) const
+{
+	std::uint64_t n = this->idx_to_id_.size() + 1;
+	return span <= n * FLAT_MAX_SPREAD + FLAT_SLACK;
+}
+
+void VertexIdMap::to_flat()
+{
+	// while dense the range is exactly the inserted ids in order
+	this->flat_buf_.resize(this->idx_to_id_.size());
+	for (pt::idx_t v_idx{}; v_idx < this->flat_buf_.size(); ++v_idx)
+		this->flat_buf_[v_idx] = v_idx;
+
+	this->mode_ = id_map_e::flat;
+	this->view_bufs();
+}
+
+void VertexIdMap::to_hashed()
+{
+	this->hashed_.reserve(this->idx_to_id_buf_.capacity());
+	for (pt::idx_t v_idx{}; v_idx < this->idx_to_id_.size(); ++v_idx)
+		this->hashed_[this->idx_to_id_[v_idx]] = v_idx;
+
+	std::vector<pt::idx_t>().swap(this->flat_buf_);
+	this->mode_ = id_map_e::hashed;
+	this->view_bufs();
+}
+
+void VertexIdMap::view_bufs()
+{
+	this->idx_to_id_ = {this->idx_to_id_buf_.data(),
+			    this->idx_to_id_buf_.size()};
+	this->flat_ = {this->flat_buf_.data(), this->flat_buf_.size()};
+}
+
+void VertexIdMap::reserve(pt::idx_t vtx_count)
+{
+	this->idx_to_id_buf_.reserve(vtx_count);
+	this->view_bufs();
+}
+
+void VertexIdMap::push_back(pt::id_t v_id)
+{
+	pt::idx_t v_idx = this->size();
+
+	if (this->mode_ == id_map_e::dense) {
+		if (v_idx == 0)
+			this->base_ = v_id;
+
+		if (v_id - this->base_ == v_idx) {
+			this->idx_to_id_buf_.push_back(v_id);
+			this->view_bufs();
+			return;
+		}
+
+		this->to_flat();
+	}
+
+	if (this->mode_ == id_map_e::flat) {
+		std::uint64_t end = this->base_ + this->flat_.size();
+
+		if (v_id < this->base_) {
+			// grow the front geometrically so descending ids stay
+			// linear, ids are unsigned so the base stops at 0
+			pt::id_t grow = std::max<std::uint64_t>(
+				this->base_ - v_id, this->flat_.size());
+			pt::id_t new_base =
+				this->base_ - std::min(grow, this->base_);
+
+			if (!this->fits_flat(end - new_base)) {
+				this->to_hashed();
+			}
+			else {
+				this->flat_buf_.insert(
+					this->flat_buf_.begin(),
+					this->base_ - new_base,
+					pc::INVALID_IDX);
+				this->base_ = new_base;
+			}
+		}
+		else if (v_id >= end) {
+			std::uint64_t span = std::uint64_t{v_id} - this->base_;
+			if (!this->fits_flat(span + 1))
+				this->to_hashed();
+			else
+				this->flat_buf_.resize(v_id - this->base_ + 1,
+						       pc::INVALID_IDX);
+		}
+	}
+
+	this->idx_to_id_buf_.push_back(v_id);
+
+	if (this->mode_ == id_map_e::flat)
+		this->flat_buf_[v_id - this->base_] = v_idx;
+	else
+		this->hashed_[v_id] = v_idx;
+
+	this->view_bufs();
 }
 
 // ============================================================
@@ -148,26 +334,24 @@ void Vertex::add_edge_r(pt::idx_t e_idx)
 VariationGraph::VariationGraph(pt::idx_t vtx_count, pt::idx_t edge_count,
 			       pt::idx_t ref_count)
 {
+	(void)ref_count; // the step index is sized when it is built
 	this->gfa = nullptr;
+	this->labels_ = std::make_shared<LabelStore>();
 	this->vertices.reserve(vtx_count);
-	this->edges.reserve(edge_count);
-	this->vertex_to_step_matrix_.resize(vtx_count);
-	for (auto &vec : this->vertex_to_step_matrix_)
-		vec.resize(ref_count);
+	this->v_ids_.reserve(vtx_count);
+	this->edges_buf_.reserve(edge_count);
 }
 
 VariationGraph::VariationGraph(lq::gfa_props *gfa_props)
 {
 	pt::idx_t vtx_count = gfa_props->vtx_arr_size;
 	pt::idx_t edge_count = gfa_props->l_line_count;
-	pt::idx_t ref_count = gfa_props->ref_count;
 
 	this->gfa = gfa_props;
+	this->labels_ = std::make_shared<LabelStore>();
 	this->vertices.reserve(vtx_count);
-	this->edges.reserve(edge_count);
-	this->vertex_to_step_matrix_.resize(vtx_count);
-	for (auto &vec : this->vertex_to_step_matrix_)
-		vec.resize(ref_count);
+	this->v_ids_.reserve(vtx_count);
+	this->edges_buf_.reserve(edge_count);
 }
 
 // ---------
@@ -176,12 +360,17 @@ VariationGraph::VariationGraph(lq::gfa_props *gfa_props)
 
 pt::id_t VG::v_idx_to_id(pt::idx_t v_idx) const
 {
-	return this->v_id_to_idx_.get_key(v_idx);
+	return this->v_ids_.get_id(v_idx);
 }
 
 pt::idx_t VG::v_id_to_idx(pt::id_t v_id) const
 {
-	return this->v_id_to_idx_.get_value(v_id);
+	return this->v_ids_.get_idx(v_id);
+}
+
+id_map_e VG::id_map_mode() const
+{
+	return this->v_ids_.mode();
 }
 
 pt::idx_t VG::vtx_count() const
@@ -189,9 +378,14 @@ pt::idx_t VG::vtx_count() const
 	return this->vertices.size();
 }
 
+bool VG::is_frozen() const
+{
+	return this->frozen_;
+}
+
 pt::idx_t VG::edge_count() const
 {
-	return this->edges.size();
+	return this->edges_.size();
 }
 
 const std::set<pgt::side_n_id_t> &VG::tips() const
@@ -199,14 +393,24 @@ const std::set<pgt::side_n_id_t> &VG::tips() const
 	return this->tips_;
 }
 
+const std::shared_ptr<LabelStore> &VG::get_label_store() const
+{
+	return this->labels_;
+}
+
+pt::idx_t VG::get_folded(pt::idx_t v_idx) const
+{
+	return this->folded_.empty() ? 0 : this->folded_[v_idx];
+}
+
 const Edge &VG::get_edge(pt::idx_t e_idx) const
 {
-	return edges[e_idx];
+	return this->edges_[e_idx];
 }
 
-Edge &VG::get_edge_mut(pt::idx_t e_idx)
+const VertexIdMap &VG::get_id_map() const
 {
-	return edges[e_idx];
+	return this->v_ids_;
 }
 
 const Vertex &VG::get_vertex_by_idx(pt::idx_t v_idx) const
@@ -216,12 +420,12 @@ const Vertex &VG::get_vertex_by_idx(pt::idx_t v_idx) const
 
 const Vertex &VG::get_vertex_by_id(pt::id_t v_id) const
 {
-	return vertices[this->v_id_to_idx_.get_value(v_id)];
+	return vertices[this->v_ids_.get_idx(v_id)];
 }
 
 Vertex &VG::get_vertex_mut_by_id(pt::id_t v_id)
 {
-	return vertices[this->v_id_to_idx_.get_value(v_id)];
+	return vertices[this->v_ids_.get_idx(v_id)];
 }
 
 std::string VG::get_sample_name(pt::id_t ref_id) const
@@ -259,22 +463,59 @@ pt::idx_t VG::get_hap_count() const
 	return this->refs_.ref_count();
 }
 
-const lq::ref *VG::get_ref_vec(pt::id_t ref_id) const
+const lq::ref_walk *VG::get_ref_walk(pt::id_t ref_id) const
+{
+	return this->refs_.get_lq_ref(ref_id).get_walk();
+}
+
+pv_cmp::span<const pt::idx_t> VG::get_vertex_ref_idxs(pt::idx_t v_idx,
+						       pt::id_t ref_id) const
+{
+	if (v_idx + 1 >= this->step_offsets_.size())
+		return {};
+
+	auto refs_begin = this->step_ref_ids_.begin();
+	auto [lo, hi] = std::equal_range(
+		refs_begin + this->step_offsets_[v_idx],
+		refs_begin + this->step_offsets_[v_idx + 1], ref_id);
+
+	return {this->step_idxs_.data() + (lo - refs_begin),
+		static_cast<std::size_t>(hi - lo)};
+}
+
+pv_cmp::span<const pt::id_t> VG::get_vertex_step_refs(pt::idx_t v_idx) const
 {
-	return this->refs_.get_lq_ref_ptr(ref_id);
+	if (v_idx + 1 >= this->step_offsets_.size())
+		return {};
+
+	const std::uint64_t b = this->step_offsets_[v_idx];
+	return {this->step_ref_ids_.data() + b,
+		static_cast<std::size_t>(this->step_offsets_[v_idx + 1] - b)};
+}
+
+pv_cmp::span<const pt::idx_t> VG::get_vertex_steps(pt::idx_t v_idx) const
+{
+	if (v_idx + 1 >= this->step_offsets_.size())
+		return {};
+
+	const std::uint64_t b = this->step_offsets_[v_idx];
+	return {this->step_idxs_.data() + b,
+		static_cast<std::size_t>(this->step_offsets_[v_idx + 1] - b)};
 }
 
-const std::vector<pt::idx_t> &VG::get_vertex_ref_idxs(pt::idx_t v_idx,
-						      pt::id_t ref_id) const
+pv_cmp::span<const std::uint64_t> VG::get_step_offsets() const
 {
-	return this->vertex_to_step_matrix_.at(v_idx).at(ref_id);
+	return this->step_offsets_;
 }
 
-const std::vector<std::vector<pt::idx_t>> &
-VG::get_vertex_refs(pt::idx_t v_id) const
+pv_cmp::span<const pt::id_t> VG::get_step_ref_ids() const
 {
-	pt::idx_t v_idx = this->v_id_to_idx_.get_value(v_id);
-	return this->vertex_to_step_matrix_.at(v_idx);
+	return this->step_ref_ids_;
+}
+
+pv_cmp::span<const pt::idx_t> VG::get_step_idxs() const
+{
+	return this->step_idxs_;
 }
 
 pt::u32 VG::get_ploidy(const std::string &sample_name) const
@@ -311,20 +552,48 @@ void VG::add_tip(pt::id_t v_id, pgt::v_end_e end)
 	this->tips_.insert(pgt::side_n_id_t{end, v_id});
 }
 
-pt::idx_t VG::add_vertex(pt::id_t v_id, const std::string &label)
+void VG::set_label_store(std::shared_ptr<LabelStore> labels)
 {
-	vertices.emplace_back(v_id, label);
-	this->v_id_to_idx_.insert(v_id, vertices.size() - 1);
+	if (!this->vertices.empty())
+		throw std::logic_error("cannot replace the label store of a "
+				       "graph with vertices");
+
+	this->labels_ = std::move(labels);
+}
+
+void VG::set_arena(pa::Arena *arena)
+{
+	if (!this->vertices.empty())
+		throw std::logic_error("cannot set the arena of a graph with "
+				       "vertices");
+
+	this->arena_ = arena;
+}
+
+pt::idx_t VG::add_vertex(pt::id_t v_id, std::string_view label)
+{
+	return this->add_labelled_vertex(v_id, this->labels_->add(label));
+}
+
+pt::idx_t VG::add_labelled_vertex(pt::id_t v_id, pt::idx_t label_idx)
+{
+	vertices.emplace_back(v_id, this->labels_.get(), label_idx,
+			      this->arena_);
+	this->v_ids_.push_back(v_id);
 	return vertices.size() - 1;
 }
 
 pt::idx_t VG::add_edge(pt::id_t v1_id, pgt::v_end_e v1_end, pt::id_t v2_id,
 		       pgt::v_end_e v2_end)
 {
-	pt::idx_t v1_idx = this->v_id_to_idx_.get_value(v1_id);
-	pt::idx_t v2_idx = this->v_id_to_idx_.get_value(v2_id);
-	edges.push_back(Edge{v1_idx, v1_end, v2_idx, v2_end});
-	pt::idx_t e_idx = edges.size() - 1;
+	if (this->frozen_)
+		throw std::logic_error("cannot add an edge to a frozen graph");
+
+	pt::idx_t v1_idx = this->v_ids_.get_idx(v1_id);
+	pt::idx_t v2_idx = this->v_ids_.get_idx(v2_id);
+	this->edges_buf_.push_back(Edge{v1_idx, v1_end, v2_idx, v2_end});
+	this->edges_ = {this->edges_buf_.data(), this->edges_buf_.size()};
+	pt::idx_t e_idx = this->edges_.size() - 1;
 
 	if (v1_end == pgt::v_end_e::l)
 		this->vertices[v1_idx].add_edge_l(e_idx);
@@ -344,14 +613,191 @@ void VG::add_all_refs(lq::ref **refs, pt::idx_t ref_count)
 	this->refs_.add_all_refs(refs, ref_count);
 }
 
-void VG::set_vtx_ref_idx(pt::id_t v_id, pt::id_t ref_id, pt::idx_t step_idx)
+void VG::add_ref(pr::Ref r)
+{
+	this->refs_.add_ref(std::move(r));
+}
+
+void VG::set_backing(std::shared_ptr<const void> backing)
+{
+	this->backing_ = std::move(backing);
+}
+
+void VG::set_vertex_step_index(pv_cmp::span<const std::uint64_t> offsets,
+			       pv_cmp::span<const pt::id_t> ref_ids,
+			       pv_cmp::span<const pt::idx_t> step_idxs)
+{
+	this->step_offsets_buf_.clear();
+	this->step_ref_ids_buf_.clear();
+	this->step_idxs_buf_.clear();
+	this->step_offsets_ = offsets;
+	this->step_ref_ids_ = ref_ids;
+	this->step_idxs_ = step_idxs;
+}
+
+/**
+ * Counting sort of every (ref, step) pair by vertex.
+ *
+ * 1. count the steps on each vertex, in parallel across refs
+ * 2. prefix sum the counts into the CSR offsets
+ * 3. scatter the pairs into their vertex's range, in parallel across refs
+ * 4. sort each vertex's range, in parallel across vertices, because the
+ *    scatter order depends on scheduling
+ */
+void VG::gen_vertex_step_index(std::size_t thread_count)
+{
+	const pt::idx_t V = this->vtx_count();
+	const pt::idx_t R = this->refs_.ref_count();
+
+	// per vertex step count, then reused as the scatter cursor
+	std::vector<std::atomic<std::uint64_t>> cursor(V);
+	for (auto &c : cursor)
+		c.store(0, std::memory_order_relaxed);
+
+	// pack (ref id, step idx) so that a plain sort orders by ref then step
+	std::vector<std::uint64_t> keys;
+
+	auto count_steps = [&](pt::id_t ref_id)
+	{
+		const lq::ref_walk *w = this->get_ref_walk(ref_id);
+		pt::idx_t N = w->step_count;
+		for (pt::idx_t step_idx{}; step_idx < N; step_idx++) {
+			pt::idx_t v_idx = this->v_id_to_idx(w->v_ids[step_idx]);
+			cursor[v_idx].fetch_add(1, std::memory_order_relaxed);
+		}
+	};
+
+	auto scatter_steps = [&](pt::id_t ref_id)
+	{
+		const lq::ref_walk *w = this->get_ref_walk(ref_id);
+		pt::idx_t N = w->step_count;
+		for (pt::idx_t step_idx{}; step_idx < N; step_idx++) {
+			pt::idx_t v_idx = this->v_id_to_idx(w->v_ids[step_idx]);
+			std::uint64_t pos = cursor[v_idx].fetch_add(
+				1, std::memory_order_relaxed);
+			keys[pos] = (std::uint64_t{ref_id} << 32) | step_idx;
+		}
+	};
+
+	std::vector<std::uint64_t> &offsets = this->step_offsets_buf_;
+	std::vector<pt::id_t> &ref_ids = this->step_ref_ids_buf_;
+	std::vector<pt::idx_t> &step_idxs = this->step_idxs_buf_;
+
+	auto sort_vertices = [&](std::size_t first, std::size_t last)
+	{
+		for (std::size_t v_idx{first}; v_idx < last; ++v_idx) {
+			std::uint64_t b = offsets[v_idx];
+			std::uint64_t e = offsets[v_idx + 1];
+			std::sort(keys.begin() + b, keys.begin() + e);
+			for (std::uint64_t i{b}; i < e; ++i) {
+				ref_ids[i] = keys[i] >> 32;
+				step_idxs[i] = keys[i] & 0xFFFFFFFF;
+			}
+		}
+	};
+
+	povu::thread::thread_pool pool(thread_count);
+
+	/* count */
+	{
+		povu::thread::task_group tg(pool);
+		for (pt::id_t ref_id{}; ref_id < R; ++ref_id)
+			tg.run([&, ref_id]() { count_steps(ref_id); });
+		tg.wait();
+	}
+
+	/* offsets */
+	offsets.assign(V + 1, 0);
+	for (pt::idx_t v_idx{}; v_idx < V; ++v_idx) {
+		std::uint64_t c = cursor[v_idx].load(std::memory_order_relaxed);
+		cursor[v_idx].store(offsets[v_idx], std::memory_order_relaxed);
+		offsets[v_idx + 1] = offsets[v_idx] + c;
+	}
+
+	/* scatter */
+	keys.resize(offsets[V]);
+	{
+		povu::thread::task_group tg(pool);
+		for (pt::id_t ref_id{}; ref_id < R; ++ref_id)
+			tg.run([&, ref_id]() { scatter_steps(ref_id); });
+		tg.wait();
+	}
+
+	/* sort each vertex's steps and split the keys */
+	ref_ids.resize(keys.size());
+	step_idxs.resize(keys.size());
+	{
+		povu::thread::task_group tg(pool);
+		std::size_t chunk = (V + pool.size() - 1) / pool.size();
+		for (std::size_t b{}; b < V; b += chunk) {
+			std::size_t e = std::min<std::size_t>(V, b + chunk);
+			tg.run([&, b, e]() { sort_vertices(b, e); });
+		}
+		tg.wait();
+	}
+
+	this->step_offsets_ = {offsets.data(), offsets.size()};
+	this->step_ref_ids_ = {ref_ids.data(), ref_ids.size()};
+	this->step_idxs_ = {step_idxs.data(), step_idxs.size()};
+}
+
+void VG::freeze()
 {
-	pt::idx_t v_idx = this->v_id_to_idx_.get_value(v_id);
-	std::vector<pt::idx_t> &s = this->vertex_to_step_matrix_[v_idx][ref_id];
-	// insert in sorted order of step idx
-	auto it = std::lower_bound(s.begin(), s.end(), step_idx);
-	if (it == s.end() || *it != step_idx) // avoid duplicates
-		s.insert(it, step_idx);
+	if (this->frozen_)
+		return;
+
+	std::size_t adj_size{};
+	for (const Vertex &v : this->vertices)
+		adj_size += v.get_edges_l().size() + v.get_edges_r().size();
+
+	this->adj_.clear();
+	this->adj_.reserve(adj_size); // views below rely on no reallocation
+
+	for (Vertex &v : this->vertices) {
+		pv_cmp::span<const pt::idx_t> l = v.get_edges_l();
+		pv_cmp::span<const pt::idx_t> r = v.get_edges_r();
+
+		const pt::idx_t *l_begin = this->adj_.data();
+		l_begin += this->adj_.size();
+		this->adj_.insert(this->adj_.end(), l.begin(), l.end());
+		const pt::idx_t *r_begin = l_begin + l.size();
+		this->adj_.insert(this->adj_.end(), r.begin(), r.end());
+
+		v.freeze({l_begin, l.size()}, {r_begin, r.size()});
+	}
+
+	this->frozen_ = true;
+}
+
+void VG::set_frozen(VertexIdMap v_ids, pv_cmp::span<const Edge> edges,
+		    pv_cmp::span<const std::uint64_t> adj_offsets,
+		    pv_cmp::span<const pt::idx_t> adj,
+		    pv_cmp::span<const pt::idx_t> label_idxs)
+{
+	if (!this->vertices.empty())
+		throw std::logic_error("cannot set the vertices of a graph "
+				       "with vertices");
+
+	const pt::idx_t V = v_ids.size();
+	this->v_ids_ = std::move(v_ids);
+	std::vector<Edge>().swap(this->edges_buf_);
+	this->edges_ = edges;
+
+	this->vertices.reserve(V);
+	for (pt::idx_t v_idx{}; v_idx < V; ++v_idx) {
+		const pt::idx_t label_idx = label_idxs.empty()
+						    ? pc::INVALID_IDX
+						    : label_idxs[v_idx];
+		Vertex &v = this->vertices.emplace_back(
+			this->v_ids_.get_id(v_idx), this->labels_.get(),
+			label_idx, this->arena_);
+
+		const std::uint64_t *o = adj_offsets.data() + (2 * v_idx);
+		v.freeze({adj.data() + o[0], o[1] - o[0]},
+			 {adj.data() + o[1], o[2] - o[1]});
+	}
+
+	this->frozen_ = true;
 }
 
 void VG::gen_genotype_metadata()
@@ -362,7 +808,10 @@ void VG::gen_genotype_metadata()
 void VG::shrink_to_fit()
 {
 	this->vertices.shrink_to_fit();
-	this->edges.shrink_to_fit();
+	this->edges_buf_.shrink_to_fit();
+	if (!this->edges_buf_.empty())
+		this->edges_ = {this->edges_buf_.data(),
+				this->edges_buf_.size()};
 }
 
 void VG::summary(bool print_tips) const
@@ -371,6 +820,8 @@ void VG::summary(bool print_tips) const
 	std::cout << "\t" << "vertex count: " << this->vtx_count() << std::endl;
 	std::cout << "\t" << "edge count: " << this->edge_count() << std::endl;
 	std::cout << "\t" << "Tip count " << this->tips().size() << std::endl;
+	std::cout << "\t" << "id map: " << to_str(this->id_map_mode())
+		  << std::endl;
 	if (print_tips) {
 		std::cerr << "\t" << "Tips: ";
 		std::cout << "\t";
@@ -411,7 +862,7 @@ graph G {
 	}
 
 	/* edges */
-	for (const Edge &e : this->edges) {
+	for (const Edge &e : this->edges_) {
 		pt::idx_t v1_idx = e.get_v1_idx();
 		std::string v1_e = v_end_to_dot(e.get_v1_end());
 		pt::idx_t v2_idx = e.get_v2_idx();
@@ -454,7 +905,7 @@ void VG::print_gfa(std::ostream &os) const
 	}
 
 	/* edges */
-	for (const Edge &e : this->edges) {
+	for (const Edge &e : this->edges_) {
 		pt::idx_t v1_idx = e.get_v1_idx();
 		std::string v1_e = v_end_to_gfa(e.get_v1_end());
 		pt::idx_t v2_idx = e.get_v2_idx();
@@ -473,131 +924,479 @@ void VG::print_gfa(std::ostream &os) const
 	// os << "}" << std::endl;
 }
 
+namespace
+{
+/**
+ * Label every vertex with a dense component id.
+ *
+ * A concurrent union-find over the edge array. A root is only ever linked
+ * under a smaller root so parents never point up in index order, which keeps
+ * the lock-free path halving safe, and every root ends up being the smallest
+ * vertex index of its component. Ids therefore follow the order of those
+ * smallest vertices.
+ *
+ * @param [out] comp_count the number of components
+ * @return the component id of each vertex
+ */
+std::vector<pt::idx_t> find_components(const VG &g, std::size_t thread_count,
+				       pt::idx_t *comp_count)
+{
+	// below this many edges per task threads are not worth it
+	constexpr pt::idx_t MIN_EDGES_PER_TASK = 1 << 16;
+
+	const pt::idx_t V = g.vtx_count();
+	const pt::idx_t E = g.edge_count();
+
+	std::vector<std::atomic<pt::idx_t>> parent(V);
+	for (pt::idx_t v_idx{}; v_idx < V; ++v_idx)
+		parent[v_idx].store(v_idx, std::memory_order_relaxed);
+
+	auto find = [&](pt::idx_t v_idx) -> pt::idx_t
+	{
+		for (;;) {
+			pt::idx_t p = parent[v_idx].load();
+			if (p == v_idx)
+				return v_idx;
+
+			pt::idx_t gp = parent[p].load();
+			if (gp != p) // halve the path, losing the race is fine
+				parent[v_idx].compare_exchange_weak(p, gp);
+			v_idx = gp;
+		}
+	};
+
+	auto unite = [&](pt::idx_t a, pt::idx_t b)
+	{
+		for (;;) {
+			a = find(a);
+			b = find(b);
+			if (a == b)
+				return;
+
+			if (a < b)
+				std::swap(a, b);
+
+			// only succeeds if a is still a root
+			pt::idx_t expected = a;
+			if (parent[a].compare_exchange_strong(expected, b))
+				return;
+		}
+	};
+
+	auto unite_edges = [&](pt::idx_t first, pt::idx_t last)
+	{
+		for (pt::idx_t e_idx{first}; e_idx < last; ++e_idx) {
+			const Edge &e = g.get_edge(e_idx);
+			unite(e.get_v1_idx(), e.get_v2_idx());
+		}
+	};
+
+	std::size_t task_count = std::max<std::size_t>(
+		1, std::min<std::size_t>(thread_count, E / MIN_EDGES_PER_TASK));
+
+	if (task_count == 1) {
+		unite_edges(0, E);
+	}
+	else {
+		povu::thread::thread_pool pool(task_count);
+		povu::thread::task_group tg(pool);
+		pt::idx_t step = (E + task_count - 1) / task_count;
+		for (pt::idx_t first{}; first < E; first += step) {
+			pt::idx_t last = std::min(E, first + step);
+			tg.run([&, first, last]()
+			       { unite_edges(first, last); });
+		}
+		tg.wait();
+	}
+
+	// a root precedes every other vertex of its component
+	std::vector<pt::idx_t> comp_ids(V);
+	pt::idx_t C{};
+	for (pt::idx_t v_idx{}; v_idx < V; ++v_idx) {
+		pt::idx_t root = find(v_idx);
+		comp_ids[v_idx] = root == v_idx ? C++ : comp_ids[root];
+	}
+
+	*comp_count = C;
+	return comp_ids;
+}
+} // namespace
+
 // does not handle refs, should it?
-std::vector<VG *> VG::componetize(const povu::bidirected::VG &g)
+std::vector<VG *> VG::componetize(const povu::bidirected::VG &g,
+				  std::size_t thread_count)
 {
-	stage_cost::Scope stage{
-		stage_cost::Stage::component_decomposition,
-		static_cast<std::uint64_t>(g.vtx_count()) + g.edge_count()};
+	ComponentGenerator gen(g, thread_count);
+	const pt::idx_t C = gen.size();
 
-	std::unordered_set<pt::idx_t> visited;
-	visited.reserve(g.vtx_count());
+	std::vector<VG *> components(C, nullptr);
 
-	// avoids creating multiple edges between the same vertices
-	std::unordered_set<pt::idx_t> added_edges;
-	added_edges.reserve(g.edge_count());
+	if (thread_count <= 1 || C <= 1) {
+		for (pt::idx_t c{}; c < C; ++c)
+			components[c] = gen.extract(c);
 
-	std::stack<pt::idx_t> s;
-	pt::idx_t start_vtx{0};
-	s.push(start_vtx);
-	visited.insert(start_vtx);
+		return components;
+	}
 
-	std::vector<VG *> components;
-	VG *curr_vg{nullptr};
+	// one task per run of components holding about V / thread_count
+	// vertices so that many tiny components do not mean many tiny tasks
+	povu::thread::thread_pool pool(thread_count);
+	povu::thread::task_group tg(pool);
+	pt::idx_t run_vtxs =
+		std::max<pt::idx_t>(1, g.vtx_count() / thread_count);
+	for (pt::idx_t first{}; first < C;) {
+		pt::idx_t last = first + 1;
+		for (pt::idx_t n = gen.vtx_count(first);
+		     last < C && n < run_vtxs; ++last)
+			n += gen.vtx_count(last);
+
+		tg.run(
+			[&, first, last]()
+			{
+				for (pt::idx_t c{first}; c < last; ++c)
+					components[c] = gen.extract(c);
+			});
+		first = last;
+	}
+	tg.wait();
 
-	std::set<pt::idx_t> comp_vtxs; // current component vertices
-	comp_vtxs.insert(start_vtx);
+	return components;
+}
 
-	/* ---------- Helper Functions ---------- */
+VG *VG::compact_chains(const VG &g, pa::Arena *arena)
+{
+	const pt::idx_t V = g.vtx_count();
+	const pt::idx_t E = g.edge_count();
 
-	auto process_edge = [&](pt::idx_t v_idx, pt::idx_t e_idx) -> void
+	// a chain vertex has one edge on each side and is not a self loop
+	auto is_chain_vtx = [&](pt::idx_t v_idx) -> bool
 	{
-		const Edge &e = g.get_edge(e_idx);
-		auto [_, adj_v_idx] = e.get_other_vtx(v_idx);
-
-		// also handles self loops
-		if (pv_cmp::contains(visited, adj_v_idx))
-			return;
+		const Vertex &v = g.get_vertex_by_idx(v_idx);
+		if (v.get_edges_l().size() != 1 || v.get_edges_r().size() != 1)
+			return false;
 
-		s.push(adj_v_idx);
-		visited.insert(adj_v_idx);
-		comp_vtxs.insert(adj_v_idx);
-		return;
+		const Edge &l = g.get_edge(v.get_edges_l()[0]);
+		const Edge &r = g.get_edge(v.get_edges_r()[0]);
+		return l.get_v1_idx() != l.get_v2_idx() &&
+		       r.get_v1_idx() != r.get_v2_idx();
 	};
 
-	auto add_edges = [&](const Vertex &v, pgt::v_end_e ve, pt::idx_t v_idx,
-			     pt::idx_t e_idx) -> void
+	// the edge on the side of chain vertex v_idx that is not ve
+	auto other_edge = [&](pt::idx_t v_idx, pgt::v_end_e ve) -> pt::idx_t
 	{
-		// don't duplicate edges
-		if (pv_cmp::contains(added_edges, e_idx))
-			return;
+		const Vertex &v = g.get_vertex_by_idx(v_idx);
+		return ve == pgt::v_end_e::l ? v.get_edges_r()[0]
+					     : v.get_edges_l()[0];
+	};
+
+	std::vector<char> chain_vtx(V, 0);
+	for (pt::idx_t v_idx{}; v_idx < V; ++v_idx)
+		chain_vtx[v_idx] = is_chain_vtx(v_idx);
+
+	/*
+	 * A run of chain vertices w_1 .. w_m (m > 2) between two other vertices
+	 * keeps only w_1 and w_m joined by one edge. The ends are kept because
+	 * the subflubble finders tell a branch of one vertex from a longer one,
+	 * and because merging a short run could turn a bubble into parallel
+	 * edges. Only edges between chain vertices are replaced so the order
+	 * of the edges on every branching side stays as it was.
+	 *
+	 * Each vertex of a run is a step in the walk that nests the flubbles,
+	 * w_1 keeps the number of vertices dropped after it so that the walk
+	 * takes the same steps as in g.
+	 */
+	std::vector<char> removed(V, 0);
+	std::vector<pt::idx_t> folded(V, 0);
+	bool any_folded{false};
+	std::vector<char> visited(V, 0);
+	std::vector<char> dropped_edges(E, 0);
+	// the ends of the edge w_1 .. w_m that takes the place of edge e
+	std::vector<pgt::side_n_idx_t> shortcut_src(E, {pgt::v_end_e::l,
+							pc::INVALID_IDX});
+	std::vector<pgt::side_n_idx_t> shortcut(E, {pgt::v_end_e::l,
+						    pc::INVALID_IDX});
+
+	std::vector<pt::idx_t> run;
+	std::vector<pt::idx_t> run_edges;
+	for (pt::idx_t s_idx{}; s_idx < V; ++s_idx) {
+		if (!chain_vtx[s_idx] || visited[s_idx])
+			continue;
+
+		/* walk left from s to the first end of the run */
+		pt::idx_t v_idx = s_idx;
+		pgt::v_end_e out = pgt::v_end_e::l; // side we leave v by
+		bool is_cycle{false};
+		for (;;) {
+			const Vertex &v = g.get_vertex_by_idx(v_idx);
+			pt::idx_t e_idx = out == pgt::v_end_e::l
+						  ? v.get_edges_l()[0]
+						  : v.get_edges_r()[0];
+			auto [adj_s, adj_idx] =
+				g.get_edge(e_idx).get_other_vtx(v_idx, out);
+			if (!chain_vtx[adj_idx])
+				break;
+			if (adj_idx == s_idx) {
+				is_cycle = true;
+				break;
+			}
+			v_idx = adj_idx;
+			out = pgt::complement(adj_s);
+		}
+
+		/* from that end walk the run the other way */
+		pgt::v_end_e in = out; // side the run is entered by
+		run.clear();
+		run_edges.clear();
+		pt::idx_t first_e = out == pgt::v_end_e::l
+					    ? g.get_vertex_by_idx(v_idx)
+						      .get_edges_l()[0]
+					    : g.get_vertex_by_idx(v_idx)
+						      .get_edges_r()[0];
+		run_edges.push_back(first_e);
+		for (;;) {
+			visited[v_idx] = 1;
+			run.push_back(v_idx);
+			pt::idx_t e_idx = other_edge(v_idx, in);
+			run_edges.push_back(e_idx);
+			auto [adj_s, adj_idx] = g.get_edge(e_idx).get_other_vtx(
+				v_idx, pgt::complement(in));
+			if (!chain_vtx[adj_idx] || visited[adj_idx])
+				break;
+			v_idx = adj_idx;
+			in = adj_s;
+		}
+
+		const std::size_t m = run.size();
+		if (is_cycle || m < 3)
+			continue;
+
+		// run_edges is A .. w_1, w_1 .. w_2, ..., w_m .. B
+		for (std::size_t i{1}; i + 1 < m; ++i)
+			removed[run[i]] = 1;
+		folded[run.front()] = m - 2;
+		any_folded = true;
+		for (std::size_t i{1}; i < m; ++i)
+			dropped_edges[run_edges[i]] = 1;
+
+		// the side of w_idx holding edge e_idx
+		auto side_of = [&](pt::idx_t w_idx,
+				   pt::idx_t e_idx) -> pgt::v_end_e
+		{
+			return g.get_vertex_by_idx(w_idx).get_edges_l()[0] ==
+					       e_idx
+				       ? pgt::v_end_e::l
+				       : pgt::v_end_e::r;
+		};
+
+		pt::idx_t w_1 = run.front();
+		pt::idx_t w_m = run.back();
+		shortcut_src[run_edges[1]] = {side_of(w_1, run_edges[1]), w_1};
+		shortcut[run_edges[1]] = {side_of(w_m, run_edges[m - 1]), w_m};
+	}
+
+	pt::idx_t kept_vtxs{};
+	pt::idx_t kept_edges{};
+	for (pt::idx_t v_idx{}; v_idx < V; ++v_idx)
+		kept_vtxs += !removed[v_idx];
+	for (pt::idx_t e_idx{}; e_idx < E; ++e_idx)
+		kept_edges += !dropped_edges[e_idx] ||
+			      shortcut[e_idx].v_idx != pc::INVALID_IDX;
+
+	VG *cg = new VG(kept_vtxs, kept_edges, 0);
+	cg->set_label_store(g.get_label_store());
+	cg->set_arena(arena);
+
+	for (pt::idx_t v_idx{}; v_idx < V; ++v_idx) {
+		if (removed[v_idx])
+			continue;
+
+		const Vertex &v = g.get_vertex_by_idx(v_idx);
+		cg->add_labelled_vertex(v.id(), v.get_label_idx());
+		if (any_folded)
+			cg->folded_.push_back(folded[v_idx]);
+	}
+
+	for (pt::idx_t e_idx{}; e_idx < E; ++e_idx) {
+		if (shortcut[e_idx].v_idx != pc::INVALID_IDX) {
+			auto [s1, v1_idx] = shortcut_src[e_idx];
+			auto [s2, v2_idx] = shortcut[e_idx];
+			cg->add_edge(g.v_idx_to_id(v1_idx), s1,
+				     g.v_idx_to_id(v2_idx), s2);
+			continue;
+		}
+
+		if (dropped_edges[e_idx])
+			continue;
 
-		added_edges.insert(e_idx);
 		const Edge &e = g.get_edge(e_idx);
+		cg->add_edge(g.v_idx_to_id(e.get_v1_idx()), e.get_v1_end(),
+			     g.v_idx_to_id(e.get_v2_idx()), e.get_v2_end());
+	}
+
+	// chain vertices have an edge on both sides, they are never tips
+	for (auto [side, v_id] : g.tips())
+		cg->add_tip(v_id, side);
 
-		// handles self loops
-		auto [adj_s, adj_v_idx] = e.get_other_vtx(v_idx, ve);
+	cg->freeze();
+	return cg;
+}
 
-		curr_vg->add_edge(v.id(), ve, g.v_idx_to_id(adj_v_idx), adj_s);
+// ============================================================
+//      Component Generator
+// ============================================================
+
+ComponentGenerator::ComponentGenerator(const VG &g, std::size_t thread_count)
+    : g_{g}
+{
+	stage_cost::Scope stage{
+		stage_cost::Stage::component_decomposition,
+		static_cast<std::uint64_t>(g.vtx_count()) + g.edge_count()};
+
+	const pt::idx_t V = g.vtx_count();
+	const pt::idx_t E = g.edge_count();
+
+	pt::idx_t C{};
+	std::vector<pt::idx_t> comp_ids = find_components(g, thread_count, &C);
+	this->comp_count_ = C;
+
+	/* bucket vertices and tips by component, in vertex index order */
+
+	auto prefix_sum = [](std::vector<pt::idx_t> &offsets)
+	{
+		for (std::size_t i{1}; i < offsets.size(); ++i)
+			offsets[i] += offsets[i - 1];
 	};
 
-	/* ---------- Main Component Search Loop ---------- */
+	this->vtx_offsets_.assign(C + 1, 0);
+	for (pt::idx_t v_idx{}; v_idx < V; ++v_idx)
+		this->vtx_offsets_[comp_ids[v_idx] + 1]++;
+	prefix_sum(this->vtx_offsets_);
 
-	while (!s.empty()) {
-		pt::idx_t v_idx = s.top();
-		s.pop();
-		const Vertex &v = g.get_vertex_by_idx(v_idx);
+	this->comp_vtxs_.resize(V);
+	{
+		std::vector<pt::idx_t> cursor(this->vtx_offsets_.begin(),
+					      this->vtx_offsets_.end() - 1);
+		for (pt::idx_t v_idx{}; v_idx < V; ++v_idx)
+			this->comp_vtxs_[cursor[comp_ids[v_idx]]++] = v_idx;
+	}
 
-		for (auto e_idx : v.get_edges_l())
-			process_edge(v_idx, e_idx);
+	this->edge_counts_.assign(C, 0);
+	for (pt::idx_t e_idx{}; e_idx < E; ++e_idx)
+		this->edge_counts_[comp_ids[g.get_edge(e_idx).get_v1_idx()]]++;
 
-		for (auto e_idx : v.get_edges_r())
-			process_edge(v_idx, e_idx);
+	auto tip_comp = [&](const pgt::side_n_id_t &t) -> pt::idx_t
+	{
+		return comp_ids[g.v_id_to_idx(t.v_idx)];
+	};
 
-		if (s.empty()) {
-			curr_vg = new VG(comp_vtxs.size(), added_edges.size(),
-					 false);
+	this->tip_offsets_.assign(C + 1, 0);
+	for (const pgt::side_n_id_t &t : g.tips())
+		this->tip_offsets_[tip_comp(t) + 1]++;
+	prefix_sum(this->tip_offsets_);
 
-			/* add vertices */
-			for (auto v_idx_ : comp_vtxs) {
-				const Vertex &v_ = g.get_vertex_by_idx(v_idx_);
-				curr_vg->add_vertex(v_.id(), v_.get_label());
-			}
+	this->comp_tips_.resize(g.tips().size());
+	{
+		std::vector<pt::idx_t> cursor(this->tip_offsets_.begin(),
+					      this->tip_offsets_.end() - 1);
+		for (const pgt::side_n_id_t &t : g.tips())
+			this->comp_tips_[cursor[tip_comp(t)]++] = t;
+	}
 
-			/* add edges */
-			for (auto v_idx_ : comp_vtxs) {
-				const Vertex &v_ = g.get_vertex_by_idx(v_idx_);
-				for (auto e_idx : v_.get_edges_l()) {
-					add_edges(v_, pgt::v_end_e::l, v_idx_,
-						  e_idx);
-				}
-
-				for (auto e_idx : v_.get_edges_r()) {
-					add_edges(v_, pgt::v_end_e::r, v_idx_,
-						  e_idx);
-				}
-			}
+	this->added_edges_.assign(E, 0);
 
-			/* add tips */
-			for (auto [side, v_id] : g.tips()) {
-				if (pv_cmp::contains(comp_vtxs,
-						     g.v_id_to_idx(v_id))) {
-					curr_vg->add_tip(v_id, side);
-				}
-			}
+	stage.set_output_items(C);
+}
 
-			// clear the set for the next component
-			components.push_back(curr_vg);
-			curr_vg = nullptr;
-			added_edges.clear();
-
-			/* find the next unvisited vertex */
-			for (std::size_t v_idx_{}; v_idx_ < g.vtx_count();
-			     ++v_idx_) {
-				if (!pv_cmp::contains(
-					    visited,
-					    v_idx_)) { // if not visited
-					comp_vtxs.clear();
-					s.push(v_idx_);
-					visited.insert(v_idx_);
-					comp_vtxs.insert(v_idx_);
-					break;
-				}
-			}
+pt::idx_t ComponentGenerator::size() const
+{
+	return this->comp_count_;
+}
+
+const VG &ComponentGenerator::graph() const
+{
+	return this->g_;
+}
+
+pt::idx_t ComponentGenerator::vtx_count(pt::idx_t c) const
+{
+	return this->vtx_offsets_[c + 1] - this->vtx_offsets_[c];
+}
+
+pt::idx_t ComponentGenerator::edge_count(pt::idx_t c) const
+{
+	return this->edge_counts_[c];
+}
+
+pv_cmp::span<const pt::idx_t> ComponentGenerator::vtxs(pt::idx_t c) const
+{
+	return {this->comp_vtxs_.data() + this->vtx_offsets_[c],
+		this->vtx_count(c)};
+}
+
+std::vector<pt::idx_t> ComponentGenerator::by_size() const
+{
+	auto weight = [this](pt::idx_t c) -> std::uint64_t
+	{
+		return static_cast<std::uint64_t>(this->vtx_count(c)) +
+		       this->edge_count(c);
+	};
+
+	std::vector<pt::idx_t> order(this->comp_count_);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(),
+			 [&](pt::idx_t a, pt::idx_t b)
+			 { return weight(a) > weight(b); });
+
+	return order;
+}
+
+VG *ComponentGenerator::extract(pt::idx_t c, pa::Arena *arena)
+{
+	const VG &g = this->g_;
+	const pt::idx_t first = this->vtx_offsets_[c];
+	const pt::idx_t last = this->vtx_offsets_[c + 1];
+
+	// an edge is added when it is first met, from the smaller vertex index
+	// and from the left side of a self loop
+	auto add_edges = [&](VG *cg, const Vertex &v, pt::idx_t v_idx,
+			     pgt::v_end_e ve, pv_cmp::span<const pt::idx_t> es)
+	{
+		for (pt::idx_t e_idx : es) {
+			if (this->added_edges_[e_idx])
+				continue;
+
+			this->added_edges_[e_idx] = 1;
+			const Edge &e = g.get_edge(e_idx);
+			// handles self loops
+			auto [adj_s, adj_v_idx] = e.get_other_vtx(v_idx, ve);
+			cg->add_edge(v.id(), ve, g.v_idx_to_id(adj_v_idx),
+				     adj_s);
 		}
+	};
+
+	VG *cg = new VG(last - first, this->edge_counts_[c], 0);
+	cg->set_label_store(g.get_label_store());
+	cg->set_arena(arena);
+
+	for (pt::idx_t i{first}; i < last; ++i) {
+		const Vertex &v = g.get_vertex_by_idx(this->comp_vtxs_[i]);
+		cg->add_labelled_vertex(v.id(), v.get_label_idx());
 	}
 
-	stage.set_output_items(components.size());
-	return components;
+	for (pt::idx_t i{first}; i < last; ++i) {
+		pt::idx_t v_idx = this->comp_vtxs_[i];
+		const Vertex &v = g.get_vertex_by_idx(v_idx);
+		add_edges(cg, v, v_idx, pgt::v_end_e::l, v.get_edges_l());
+		add_edges(cg, v, v_idx, pgt::v_end_e::r, v.get_edges_r());
+	}
+
+	for (pt::idx_t i{this->tip_offsets_[c]}; i < this->tip_offsets_[c + 1];
+	     ++i) {
+		auto [side, v_id] = this->comp_tips_[i];
+		cg->add_tip(v_id, side);
+	}
+
+	cg->freeze();
+	return cg;
 }
 } // namespace povu::bidirected
@@ -1,6 +1,8 @@
 #include "povu/graph/bracket_list.hpp"
 
-#include "povu/common/constants.hpp" // for UNDEFINED_SIZE_T
+#include <cassert> // for assert
+
+#include "povu/common/constants.hpp" // for UNDEFINED_SIZE_T, INVALID_IDX
 
 namespace povu::bracket_list
 {
@@ -42,61 +44,126 @@ void Bracket::set_recent_class(std::size_t c)
 }
 
 /*
- * BracketList Wrapper
- * -------------------
+ * BracketPool
+ * -----------
  */
 
-WBracketList::WBracketList()
+BracketPool::BracketPool(std::size_t vtx_count, std::size_t be_count)
+    : nodes_(be_count,
+	     {Bracket(UNDEFINED_SIZE_T), INVALID_IDX, INVALID_IDX, false}),
+      lists_(vtx_count)
 {
-	this->brackets = std::list<Bracket>{};
-	this->bracket_map =
-		std::unordered_map<std::size_t, std::list<Bracket>::iterator>{};
+#ifdef DEBUG
+	this->pushed_to_.assign(be_count, INVALID_IDX);
+	this->moved_to_.assign(vtx_count, INVALID_IDX);
+#endif
 }
 
-std::size_t WBracketList::size() const
+std::size_t BracketPool::size(std::size_t v_idx) const
 {
-	return this->brackets.size();
+	return this->lists_[v_idx].size;
 }
 
-void WBracketList::push(Bracket br)
+Bracket &BracketPool::top(std::size_t v_idx)
 {
-	this->brackets.push_front(br);
-	this->bracket_map[br.back_edge_id()] = this->brackets.begin();
+	return this->nodes_[this->lists_[v_idx].head].br;
 }
 
-Bracket &WBracketList::top()
+pt::idx_t BracketPool::owner(std::size_t be_idx) const
 {
-	return this->brackets.front();
+	pt::idx_t v_idx = this->pushed_to_[be_idx];
+	while (this->moved_to_[v_idx] != INVALID_IDX)
+		v_idx = this->moved_to_[v_idx];
+
+	return v_idx;
 }
 
-void WBracketList::del(std::size_t be_id)
+void BracketPool::push(std::size_t v_idx, std::size_t be_idx,
+		       std::size_t be_id)
 {
-	// check if bracket_map has the backedge_id
-	// TODO: the be_id should always be in the bracket_map, why the need to
-	// check?
-	if (this->bracket_map.find(be_id) == this->bracket_map.end()) {
-		return;
-		// throw std::runtime_error("Bracket not found");
+#ifdef DEBUG
+	// its older brackets would be taken to be in this list
+	assert(this->moved_to_[v_idx] == INVALID_IDX);
+	if (this->pushed_to_.size() <= be_idx)
+		this->pushed_to_.resize(be_idx + 1, INVALID_IDX);
+	this->pushed_to_[be_idx] = static_cast<pt::idx_t>(v_idx);
+#endif
+
+	if (this->nodes_.size() <= be_idx) {
+		this->nodes_.resize(be_idx + 1, {Bracket(UNDEFINED_SIZE_T),
+						 INVALID_IDX, INVALID_IDX,
+						 false});
 	}
-	this->brackets.erase(this->bracket_map[be_id]);
-	this->bracket_map.erase(be_id);
+
+	BracketList &l = this->lists_[v_idx];
+	pt::idx_t n_idx = static_cast<pt::idx_t>(be_idx);
+	this->nodes_[n_idx] = {Bracket(be_id), INVALID_IDX, l.head, true};
+
+	if (l.head != INVALID_IDX)
+		this->nodes_[l.head].prev = n_idx;
+	else
+		l.tail = n_idx;
+
+	l.head = n_idx;
+	l.size++;
 }
 
-BracketList &WBracketList::get_bracket_list()
+void BracketPool::del(std::size_t v_idx, std::size_t be_idx)
 {
-	return this->brackets;
+	if (be_idx >= this->nodes_.size() || !this->nodes_[be_idx].linked)
+		return;
+
+#ifdef DEBUG
+	// unlinking it from another list corrupts that list's ends and size
+	assert(this->owner(be_idx) == v_idx);
+#endif
+
+	BracketList &l = this->lists_[v_idx];
+	node_t &n = this->nodes_[be_idx];
+
+	if (n.prev != INVALID_IDX)
+		this->nodes_[n.prev].next = n.next;
+	else
+		l.head = n.next;
+
+	if (n.next != INVALID_IDX)
+		this->nodes_[n.next].prev = n.prev;
+	else
+		l.tail = n.prev;
+
+	n.prev = n.next = INVALID_IDX;
+	n.linked = false;
+	l.size--;
 }
 
-void WBracketList::concat(WBracketList *child)
+void BracketPool::concat(std::size_t p_v_idx, std::size_t c_v_idx)
 {
-	this->brackets.splice(this->brackets.begin(),
-			      child->get_bracket_list());
+	BracketList &p = this->lists_[p_v_idx];
+	BracketList &c = this->lists_[c_v_idx];
+
+	if (c.size == 0)
+		return;
 
-	// update the bracket_map by iterating through the list
-	for (auto it = this->brackets.begin(); it != this->brackets.end();
-	     ++it) {
-		this->bracket_map[it->back_edge_id()] = it;
+	if (p.size > 0) {
+		this->nodes_[c.tail].next = p.head;
+		this->nodes_[p.head].prev = c.tail;
+		c.tail = p.tail;
 	}
+
+	p = {c.head, c.tail, p.size + c.size};
+	c = {};
+#ifdef DEBUG
+	this->moved_to_[c_v_idx] = static_cast<pt::idx_t>(p_v_idx);
+#endif
+}
+
+void BracketPool::clear()
+{
+	// swap to release the memory, clear keeps the capacity
+	std::vector<node_t>().swap(this->nodes_);
+	std::vector<BracketList>().swap(this->lists_);
+	std::vector<pt::idx_t>().swap(this->pushed_to_);
+	std::vector<pt::idx_t>().swap(this->moved_to_);
 }
 
 } // namespace povu::bracket_list
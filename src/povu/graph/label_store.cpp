@@ -0,0 +1,244 @@
+#include "povu/graph/label_store.hpp"
+
+#include <algorithm> // for min, max, all_of
+#include <array>     // for array
+#include <cstdint>   // for uintptr_t
+#include <utility>   // for move
+
+namespace povu::bidirected
+{
+
+namespace
+{
+constexpr std::uint8_t NOT_ACGT = 4;
+constexpr char BASES[] = "ACGT";
+
+constexpr std::array<std::uint8_t, 256> gen_codes()
+{
+	std::array<std::uint8_t, 256> t{};
+	for (std::size_t i{}; i < t.size(); ++i)
+		t[i] = NOT_ACGT;
+
+	t['A'] = 0;
+	t['C'] = 1;
+	t['G'] = 2;
+	t['T'] = 3;
+	return t;
+}
+
+// same as pu::complement, anything but ACGT is its own complement
+constexpr std::array<char, 256> gen_complements()
+{
+	std::array<char, 256> t{};
+	for (std::size_t i{}; i < t.size(); ++i)
+		t[i] = static_cast<char>(i);
+
+	t['A'] = 'T';
+	t['T'] = 'A';
+	t['C'] = 'G';
+	t['G'] = 'C';
+	return t;
+}
+
+constexpr std::array<std::uint8_t, 256> CODES = gen_codes();
+constexpr std::array<char, 256> COMPLEMENTS = gen_complements();
+
+/**
+ * reverse complement 32 packed bases at once, the complement of a 2 bit code
+ * is its bitwise not and the bases are reversed by swapping ever larger
+ * groups of bits
+ */
+inline std::uint64_t rc_word(std::uint64_t w)
+{
+	w = ~w;
+	w = ((w >> 2) & 0x3333333333333333ULL) |
+	    ((w & 0x3333333333333333ULL) << 2);
+	w = ((w >> 4) & 0x0F0F0F0F0F0F0F0FULL) |
+	    ((w & 0x0F0F0F0F0F0F0F0FULL) << 4);
+	return __builtin_bswap64(w);
+}
+
+/** emit the lowest @p n bases of @p w, lowest first */
+inline char *decode_word(std::uint64_t w, std::uint64_t n, char *dst)
+{
+	for (std::uint64_t k{}; k < n; ++k, w >>= 2)
+		*dst++ = BASES[w & 3];
+
+	return dst;
+}
+} // namespace
+
+std::string_view to_str(label_enc_e e)
+{
+	switch (e) {
+	case label_enc_e::text:
+		return "text";
+	case label_enc_e::packed:
+		return "packed";
+	default:
+		return "?";
+	}
+}
+
+// --------------
+// constructor(s)
+// --------------
+
+LabelStore::LabelStore(label_enc_e enc) : enc_{enc}
+{}
+
+LabelStore::LabelStore(std::shared_ptr<const void> owner,
+		       std::string_view backing, label_enc_e enc)
+    : enc_{enc}, backing_owner_{std::move(owner)}, backing_{backing.data()},
+      backing_size_{backing.size()}
+{}
+
+// ---------
+// getter(s)
+// ---------
+
+label_enc_e LabelStore::encoding() const
+{
+	return this->enc_;
+}
+
+pt::idx_t LabelStore::size() const
+{
+	return static_cast<pt::idx_t>(this->entries_.size());
+}
+
+pt::u32 LabelStore::length(pt::idx_t l_idx) const
+{
+	return l_idx == pc::INVALID_IDX ? 0 : this->entries_[l_idx].len;
+}
+
+std::size_t LabelStore::owned_bytes() const
+{
+	return this->owned_.capacity() +
+	       (this->packed_.capacity() * sizeof(std::uint64_t)) +
+	       (this->entries_.capacity() * sizeof(entry_t));
+}
+
+bool LabelStore::in_backing(std::string_view label) const
+{
+	auto b = reinterpret_cast<std::uintptr_t>(this->backing_);
+	auto l = reinterpret_cast<std::uintptr_t>(label.data());
+	return this->backing_size_ > 0 && l >= b &&
+	       l + label.size() <= b + this->backing_size_;
+}
+
+const char *LabelStore::text_at(const entry_t &e) const
+{
+	return e.off < this->backing_size_
+		       ? this->backing_ + e.off
+		       : this->owned_.data() + (e.off - this->backing_size_);
+}
+
+void LabelStore::append(pt::idx_t l_idx, std::string &out) const
+{
+	if (l_idx == pc::INVALID_IDX)
+		return;
+
+	const entry_t &e = this->entries_[l_idx];
+	if (!e.packed) {
+		out.append(this->text_at(e), e.len);
+		return;
+	}
+
+	std::size_t n = out.size();
+	out.resize(n + e.len);
+	char *dst = out.data() + n;
+
+	for (std::uint64_t p = e.off, end = e.off + e.len; p < end;) {
+		std::uint64_t w = this->packed_[p / 32] >> (2 * (p % 32));
+		std::uint64_t k =
+			std::min<std::uint64_t>(32 - (p % 32), end - p);
+		dst = decode_word(w, k, dst);
+		p += k;
+	}
+}
+
+void LabelStore::append_rc(pt::idx_t l_idx, std::string &out) const
+{
+	if (l_idx == pc::INVALID_IDX)
+		return;
+
+	const entry_t &e = this->entries_[l_idx];
+	std::size_t n = out.size();
+	out.resize(n + e.len);
+	char *dst = out.data() + n;
+
+	if (!e.packed) {
+		const char *src = this->text_at(e);
+		for (pt::u32 j{}; j < e.len; ++j)
+			dst[j] = COMPLEMENTS[static_cast<std::uint8_t>(
+				src[e.len - 1 - j])];
+		return;
+	}
+
+	// walk the words from the last base back, after rc_word the base at
+	// position q of a word is at 31 - q
+	for (std::uint64_t hi = e.off + e.len; hi > e.off;) {
+		std::uint64_t w_idx = (hi - 1) / 32;
+		std::uint64_t lo = std::max(e.off, w_idx * 32);
+		std::uint64_t w = rc_word(this->packed_[w_idx]) >>
+				  (2 * ((32 * (w_idx + 1)) - hi));
+		dst = decode_word(w, hi - lo, dst);
+		hi = lo;
+	}
+}
+
+// ---------
+// setter(s)
+// ---------
+
+void LabelStore::reserve(pt::idx_t label_count)
+{
+	this->entries_.reserve(label_count);
+}
+
+void LabelStore::pack(std::string_view label)
+{
+	std::uint64_t p = this->packed_len_;
+	this->packed_.resize((p + label.size() + 31) / 32, 0);
+
+	for (char c : label) {
+		std::uint64_t code = CODES[static_cast<std::uint8_t>(c)];
+		this->packed_[p / 32] |= code << (2 * (p % 32));
+		++p;
+	}
+
+	this->packed_len_ = p;
+}
+
+pt::idx_t LabelStore::add(std::string_view label)
+{
+	if (label.empty())
+		return pc::INVALID_IDX;
+
+	auto is_acgt = [](char c)
+	{
+		return CODES[static_cast<std::uint8_t>(c)] != NOT_ACGT;
+	};
+
+	const pt::u32 len = static_cast<pt::u32>(label.size());
+
+	if (this->enc_ == label_enc_e::packed &&
+	    std::all_of(label.begin(), label.end(), is_acgt)) {
+		this->entries_.push_back({this->packed_len_, len, true});
+		this->pack(label);
+	}
+	else if (this->in_backing(label)) {
+		std::uint64_t off = label.data() - this->backing_;
+		this->entries_.push_back({off, len, false});
+	}
+	else {
+		std::uint64_t off = this->backing_size_ + this->owned_.size();
+		this->owned_.append(label);
+		this->entries_.push_back({off, len, false});
+	}
+
+	return this->size() - 1;
+}
+
+} // namespace povu::bidirected
@@ -1,19 +1,17 @@
 #include "povu/graph/spanning_tree.hpp"
 
-#include <algorithm>	 // for max, min
+#include <algorithm>	 // for max, min, sort, unique, binary_search
 #include <stack>	 // for stack
-#include <stdexcept>	 // for runtime_error
+#include <stdexcept>	 // for runtime_error, logic_error
 #include <string>	 // for basic_string, string, operator<<
 #include <string_view>	 // for string_view, basic_string_view
 #include <sys/types.h>	 // for u_int8_t
-#include <unordered_set> // for unordered_set, operator!=
 
 #include "fmt/core.h"		       // for format
 #include "povu/common/compat.hpp"      // for pv_cmp, format, contains
 #include "povu/common/constants.hpp"   // for INVALID_CLS, COL_SEP, INVALI...
 #include "povu/common/stage_cost.hpp"
 #include "povu/graph/bidirected.hpp"   // for Vertex, VG, pgt, Edge
-#include "povu/graph/bracket_list.hpp" // for WBracketList, Bracket, Bracke...
 #include "povu/graph/types.hpp"	       // for v_type_e, v_end_e, color_e
 
 namespace povu::spanning_tree
@@ -113,8 +111,10 @@ void BackEdge::set_class(pt::idx_t c)
 // ======
 
 /* constructor(s) */
-Vertex::Vertex(pt::idx_t dfs_num, pt::idx_t g_v_id, v_type_e type)
-    : dfs_num_(dfs_num), parent_e_idx_(pc::INVALID_IDX), hi_(pc::INVALID_IDX),
+Vertex::Vertex(pt::idx_t dfs_num, pt::idx_t g_v_id, v_type_e type,
+	       pa::Arena *arena)
+    : child_e_idxs_(arena), child_v_idxs_(arena), obe(arena), ibe(arena),
+      dfs_num_(dfs_num), parent_e_idx_(pc::INVALID_IDX), hi_(pc::INVALID_IDX),
       g_v_id_(g_v_id), pre_order_(pc::INVALID_IDX),
       post_order_(pc::INVALID_IDX), type_(type)
 {}
@@ -142,7 +142,7 @@ bool Vertex::is_root() const
 
 bool Vertex::is_leaf() const
 {
-	return this->child_e_idxs_.empty();
+	return this->get_child_edge_idxs().empty();
 }
 
 pt::idx_t Vertex::dfs_num() const
@@ -165,40 +165,79 @@ pt::idx_t Vertex::get_parent_e_idx() const
 	return this->parent_e_idx_;
 }
 
-std::set<pt::idx_t> const &Vertex::get_ibe() const
+namespace
 {
-	return this->ibe;
+// the owned vector while the tree is built, the view into the CSR after
+inline pv_cmp::span<const pt::idx_t>
+owned_or_csr(const pa::vector<pt::idx_t> &owned,
+	     pv_cmp::span<const pt::idx_t> csr)
+{
+	return owned.empty()
+		       ? csr
+		       : pv_cmp::span<const pt::idx_t>{owned.data(),
+						       owned.size()};
+}
+} // namespace
+
+pv_cmp::span<const pt::idx_t> Vertex::get_ibe() const
+{
+	return owned_or_csr(this->ibe, this->csr_.ibe);
+}
+
+pv_cmp::span<const pt::idx_t> Vertex::get_obe() const
+{
+	return owned_or_csr(this->obe, this->csr_.obe);
 }
 
-std::set<pt::idx_t> const &Vertex::get_obe() const
+pv_cmp::span<const pt::idx_t> Vertex::get_obe_tgts() const
 {
-	return this->obe;
+	return this->csr_.obe_tgts;
 }
 
-std::set<pt::idx_t> const &Vertex::get_child_edge_idxs() const
+pv_cmp::span<const pt::idx_t> Vertex::get_ibe_srcs() const
 {
-	return this->child_e_idxs_;
+	return this->csr_.ibe_srcs;
+}
+
+pv_cmp::span<const pt::idx_t> Vertex::get_child_edge_idxs() const
+{
+	return owned_or_csr(this->child_e_idxs_, this->csr_.child_e_idxs);
+}
+
+pv_cmp::span<const pt::idx_t> Vertex::get_children() const
+{
+	return owned_or_csr(this->child_v_idxs_, this->csr_.child_v_idxs);
 }
 
 pt::idx_t Vertex::child_count() const
 {
-	return static_cast<pt::idx_t>(this->child_e_idxs_.size());
+	return static_cast<pt::idx_t>(this->get_child_edge_idxs().size());
 }
 
 // setters
 void Vertex::add_obe(pt::idx_t obe_id)
 {
-	this->obe.insert(obe_id);
+	this->obe.push_back(obe_id);
 }
 
 void Vertex::add_ibe(pt::idx_t ibe_id)
 {
-	this->ibe.insert(ibe_id);
+	this->ibe.push_back(ibe_id);
+}
+
+void Vertex::add_child(pt::idx_t e_idx, pt::idx_t c_v_idx)
+{
+	this->child_e_idxs_.push_back(e_idx);
+	this->child_v_idxs_.push_back(c_v_idx);
 }
 
-void Vertex::add_child_e_idx(pt::idx_t e_id)
+void Vertex::freeze(const adj_t &csr)
 {
-	this->child_e_idxs_.insert(e_id);
+	this->csr_ = csr;
+	pa::vector<pt::idx_t>().swap(this->child_e_idxs_);
+	pa::vector<pt::idx_t>().swap(this->child_v_idxs_);
+	pa::vector<pt::idx_t>().swap(this->obe);
+	pa::vector<pt::idx_t>().swap(this->ibe);
 }
 
 void Vertex::set_parent_e_idx(pt::idx_t e_idx)
@@ -245,21 +284,16 @@ void Vertex::set_post_order(pt::idx_t idx)
 
 Tree::Tree(std::size_t size)
     : nodes(std::vector<Vertex>{}), tree_edges(std::vector<Edge>{}),
-      back_edges(std::vector<BackEdge>{}),
-      // bracket_lists(std::vector<BracketList*>{}),
+      back_edges(std::vector<BackEdge>{})
       // sort_(std::vector<std::size_t>{}),
       // sort_g(std::vector<std::size_t>{}),
-      equiv_class_count_(0)
 {
 	this->nodes.reserve(size);
 	this->tree_edges.reserve(size);
 	this->back_edges.reserve(size);
-	// this->bracket_lists.reserve(size);
-	// TODO: is this necessary?
-	this->bracket_lists = std::vector<WBracketList *>(size, nullptr);
 }
 
-Tree Tree::from_bd(const bd::VG &g)
+Tree Tree::from_bd(const bd::VG &g, pa::Arena *arena)
 {
 	stage_cost::Scope augmentation_stage{
 		stage_cost::Stage::tip_dummy_augmentation,
@@ -271,9 +305,7 @@ Tree Tree::from_bd(const bd::VG &g)
 
 	std::stack<pt::idx_t> s;
 	std::vector<u_int8_t> visited(g.vtx_count(), 0);
-
-	std::set<std::pair<pt::idx_t, pt::idx_t>> added_edges;
-	std::unordered_set<pt::idx_t> self_loops;
+	std::vector<u_int8_t> self_loops(g.vtx_count(), 0);
 
 	pt::idx_t order{};
 	// pt::idx_t post_order {};
@@ -290,20 +322,47 @@ Tree Tree::from_bd(const bd::VG &g)
 	// biedged idx to tree idx (or counter)
 	std::vector<pt::id_t> be_idx_to_ctr(t_vtx_count, 0);
 
-	auto unordered_pair = [](pt::idx_t a,
-				 pt::idx_t b) -> std::pair<pt::idx_t, pt::idx_t>
+	/*
+	  neighbour stamping: stamp[x] == stamped when tree vertex x is joined
+	  to the vertex being processed (stamped) by a tree edge or a backedge.
+	  When a vertex comes back to the top of the stack its stamps are set
+	  again from its edges in the tree, while it stays there connect keeps
+	  them current
+	*/
+	std::vector<pt::idx_t> stamp(t_vtx_count, pc::INVALID_IDX);
+	pt::idx_t stamped{pc::INVALID_IDX};
+
+	auto restamp = [&](pt::idx_t v_idx) -> void
 	{
-		return {std::min(a, b), std::max(a, b)};
+		stamped = v_idx;
+		const Vertex &v = t.get_vertex(v_idx);
+
+		if (!v.is_root())
+			stamp[t.get_parent_v_idx(v_idx)] = v_idx;
+
+		for (pt::idx_t e_idx : v.get_child_edge_idxs())
+			stamp[t.get_tree_edge(e_idx).get_child_v_idx()] = v_idx;
+
+		for (pt::idx_t be_idx : v.get_obe())
+			stamp[t.get_be(be_idx).get_tgt()] = v_idx;
+
+		for (pt::idx_t be_idx : v.get_ibe())
+			stamp[t.get_be(be_idx).get_src()] = v_idx;
 	};
 
+	// an edge not touching the stamped vertex is found by restamp later
 	auto connect = [&](pt::idx_t a, pt::idx_t b) -> void
 	{
-		added_edges.insert(unordered_pair(a, b));
+		if (a == stamped)
+			stamp[b] = a;
+		else if (b == stamped)
+			stamp[a] = b;
 	};
 
+	// a is always the stamped vertex
 	auto are_connected = [&](pt::idx_t a, pt::idx_t b) -> bool
 	{
-		return pv_cmp::contains(added_edges, unordered_pair(a, b));
+		return stamp[b] == a;
 	};
 
 	auto to_be = [&g](pgt::side_n_id_t i) -> pt::idx_t
@@ -332,16 +391,23 @@ Tree Tree::from_bd(const bd::VG &g)
 	{
 		const bd::Vertex &v = g.get_vertex_by_idx(bd_v_idx);
 
-		Vertex v1{counter++, v.id(), end2typ(e)};
+		Vertex v1{counter++, v.id(), end2typ(e), arena};
 		v1.set_pre_order(order++);
 		t.add_vertex(std::move(v1));
 
-		Vertex v2{counter++, v.id(), end2typ(pgt::complement(e))};
+		Vertex v2{counter++, v.id(), end2typ(pgt::complement(e)),
+			  arena};
 		v2.set_pre_order(order++);
 		t.add_vertex(std::move(v2));
 		// t.add_vertex({counter++, v.id(),
 		// end2typ(pgt::complement(e))});
 
+		if (pt::idx_t f = g.get_folded(bd_v_idx); f > 0) {
+			t.folded_.resize(t_vtx_count, 0);
+			t.folded_[counter - 2] = f;
+			t.folded_[counter - 1] = f;
+		}
+
 		be_idx_to_ctr[to_be({e, v.id()})] = counter - 2;
 		be_idx_to_ctr[to_be({pgt::complement(e), v.id()})] =
 			counter - 1;
@@ -385,13 +451,12 @@ Tree Tree::from_bd(const bd::VG &g)
 			connect(p_idx, be_idx_to_ctr[o_be_idx]);
 		}
 		else if (__builtin_expect(
-				 (bd_v_idx == ov_idx &&
-				  !pv_cmp::contains(self_loops, bd_v_idx)),
+				 (bd_v_idx == ov_idx && !self_loops[bd_v_idx]),
 				 0)) {
 			// add a self loop backedge, a parent-child relationship
 			t.add_be(p_idx, be_idx_to_ctr[o_be_idx],
 				 be_type_e::back_edge);
-			self_loops.insert(bd_v_idx);
+			self_loops[bd_v_idx] = 1;
 		}
 
 		return false;
@@ -399,7 +464,7 @@ Tree Tree::from_bd(const bd::VG &g)
 
 	if (has_tips) { // add a dummy vertex to the tree
 		p_idx = counter;
-		Vertex v{counter++, pc::DUMMY_VTX_ID, v_type_e::dummy};
+		Vertex v{counter++, pc::DUMMY_VTX_ID, v_type_e::dummy, arena};
 		v.set_pre_order(order++);
 		t.add_vertex(std::move(v));
 	}
@@ -421,11 +486,14 @@ Tree Tree::from_bd(const bd::VG &g)
 		pt::idx_t be_v_idx = s.top();
 
 		p_idx = be_idx_to_ctr[be_v_idx];
+		if (stamped != p_idx)
+			restamp(p_idx);
+
 		auto [syd, v_id] = to_bd(be_v_idx);
 		pt::idx_t bd_v_idx = g.v_id_to_idx(v_id);
 
 		const bd::Vertex &v = g.get_vertex_by_id(v_id);
-		const std::set<pt::idx_t> &neighbours =
+		pv_cmp::span<const pt::idx_t> neighbours =
 			syd == pgt::v_end_e::l ? v.get_edges_l()
 					       : v.get_edges_r();
 
@@ -467,16 +535,6 @@ Tree::~Tree()
 	this->nodes.clear();
 	this->tree_edges.clear();
 	this->back_edges.clear();
-	for (std::size_t i = 0; i < this->bracket_lists.size(); ++i) {
-		if (this->bracket_lists.at(i) != nullptr) {
-			delete this->bracket_lists[i];
-		}
-		// else {
-		//   std::cout << "Bracket list " << i << " is null" <<
-		//   std::endl;
-		// }
-	}
-	this->bracket_lists.clear();
 
 	// this->sort_.clear();
 	// this->sort_g.clear();
@@ -502,7 +560,7 @@ void Tree::set_vertex_type(std::size_t vertex, v_type_e type)
 
 void Tree::add_vertex(Vertex &&v)
 {
-	this->nodes.push_back(v);
+	this->nodes.push_back(std::move(v));
 }
 
 Vertex &Tree::get_root()
@@ -547,11 +605,6 @@ Vertex const &Tree::get_p_vtx(std::size_t v_idx) const
 	return this->get_vertex(p_idx);
 }
 
-std::size_t Tree::list_size(std::size_t vertex)
-{
-	return this->bracket_lists.at(vertex)->size();
-}
-
 std::size_t Tree::get_hi(std::size_t vertex)
 {
 	return this->nodes.at(vertex).hi();
@@ -565,42 +618,10 @@ bool Tree::is_desc(pt::idx_t a, pt::idx_t d) const
 		       this->get_vertex(d).post_order();
 }
 
-std::set<std::pair<std::size_t, std::size_t>>
-Tree::get_children_w_id(std::size_t vertex)
-{
-	std::set<std::pair<std::size_t, std::size_t>> res{};
-	for (auto e_idx : this->nodes.at(vertex).get_child_edge_idxs()) {
-		res.insert(std::make_pair(
-			this->tree_edges.at(e_idx).id(),
-			this->tree_edges.at(e_idx).get_child_v_idx()));
-	}
-	return res;
-}
-
-std::vector<Edge> Tree::get_child_edges(pt::idx_t v_idx)
-{
-	return this->get_child_edges_mut(v_idx);
-}
-
-std::vector<Edge> Tree::get_child_edges_mut(pt::idx_t v_idx)
+pv_cmp::span<const pt::idx_t>
+Tree::get_child_edge_idxs(pt::idx_t v_idx) const
 {
-	std::vector<Edge> v{};
-
-	for (auto e_idx : this->nodes.at(v_idx).get_child_edge_idxs()) {
-		v.push_back(this->tree_edges.at(e_idx));
-	}
-
-	return v;
-}
-
-std::vector<pt::idx_t> Tree::get_child_edge_idxs(pt::idx_t v_idx) const
-{
-	std::vector<pt::idx_t> v{};
-	for (auto e_idx : this->nodes.at(v_idx).get_child_edge_idxs()) {
-		v.push_back(e_idx);
-	}
-
-	return v;
+	return this->nodes.at(v_idx).get_child_edge_idxs();
 }
 
 pt::idx_t Tree::get_child_count(pt::idx_t v_idx) const
@@ -608,102 +629,52 @@ pt::idx_t Tree::get_child_count(pt::idx_t v_idx) const
 	return this->nodes.at(v_idx).child_count();
 }
 
-Edge const &Tree::get_parent_edge(std::size_t vertex) const
+pt::idx_t Tree::get_folded(pt::idx_t v_idx) const
 {
-	return this->tree_edges.at(this->nodes.at(vertex).get_parent_e_idx());
+	return this->folded_.empty() ? 0 : this->folded_[v_idx];
 }
 
-std::set<std::size_t> Tree::get_obe_idxs(std::size_t vertex) const
-{
-	std::set<std::size_t> v{};
-
-	for (auto be_idx : this->nodes.at(vertex).get_obe()) {
-		v.insert(be_idx);
-	}
-
-	return v;
-}
-
-std::set<std::size_t> Tree::get_ibe_idxs(std::size_t vertex) const
+Edge const &Tree::get_parent_edge(std::size_t vertex) const
 {
-	std::set<std::size_t> v{};
-
-	for (auto be_idx : this->nodes.at(vertex).get_ibe()) {
-		v.insert(be_idx);
-	}
-
-	return v;
+	return this->tree_edges.at(this->nodes.at(vertex).get_parent_e_idx());
 }
 
-std::set<std::pair<std::size_t, std::size_t>>
-Tree::get_obe_w_id(std::size_t vertex)
+pv_cmp::span<const pt::idx_t> Tree::get_obe_idxs(std::size_t vertex) const
 {
-	std::set<std::pair<std::size_t, std::size_t>> res{};
-	for (auto e_idx : this->nodes.at(vertex).get_obe()) {
-		res.insert(
-			std::make_pair(this->back_edges.at(e_idx).id(),
-				       this->back_edges.at(e_idx).get_tgt()));
-	}
-	return res;
+	return this->nodes.at(vertex).get_obe();
 }
 
-std::set<std::pair<std::size_t, std::size_t>>
-Tree::get_ibe_w_id(std::size_t vertex)
+pv_cmp::span<const pt::idx_t> Tree::get_ibe_idxs(std::size_t vertex) const
 {
-	std::set<std::pair<std::size_t, std::size_t>> res{};
-	for (auto e_idx : this->nodes.at(vertex).get_ibe()) {
-		res.insert(
-			std::make_pair(this->back_edges.at(e_idx).id(),
-				       this->back_edges.at(e_idx).get_src()));
-	}
-	return res;
+	return this->nodes.at(vertex).get_ibe();
 }
 
-std::set<std::size_t> Tree::get_children(pt::idx_t v_idx) const
+pv_cmp::span<const pt::idx_t> Tree::get_children(pt::idx_t v_idx) const
 {
-	std::set<std::size_t> res{};
-	for (auto e_idx : this->nodes.at(v_idx).get_child_edge_idxs()) {
-		res.insert(this->tree_edges.at(e_idx).get_child_v_idx());
-	}
-	return res;
+	return this->nodes.at(v_idx).get_children();
 }
 
-std::set<std::size_t> Tree::get_ibe(std::size_t vertex)
+pv_cmp::span<const pt::idx_t>
+Tree::get_ibe_src_v_idxs(std::size_t v_idx) const
 {
-	std::set<std::size_t> res{};
-	for (auto e_idx : this->nodes.at(vertex).get_ibe()) {
-		res.insert(this->back_edges.at(e_idx).get_src());
-	}
+	if (!this->frozen_)
+		throw std::logic_error("the spanning tree is not frozen");
 
-	return res;
+	return this->nodes.at(v_idx).get_ibe_srcs();
 }
 
-std::set<pt::idx_t> Tree::get_ibe_src_v_idxs(std::size_t v_idx) const
+pv_cmp::span<const pt::idx_t>
+Tree::get_obe_tgt_v_idxs(std::size_t v_idx) const
 {
-	std::set<pt::idx_t> res{};
-	for (auto e_idx : this->nodes.at(v_idx).get_ibe()) {
-		res.insert(this->back_edges.at(e_idx).get_src());
-	}
+	if (!this->frozen_)
+		throw std::logic_error("the spanning tree is not frozen");
 
-	return res;
+	return this->nodes.at(v_idx).get_obe_tgts();
 }
 
-std::set<std::size_t> Tree::get_obe(std::size_t vertex)
+bool Tree::is_frozen() const
 {
-	std::set<std::size_t> res{};
-	for (auto e_idx : this->nodes.at(vertex).get_obe()) {
-		res.insert(this->back_edges.at(e_idx).get_tgt());
-	}
-	return res;
-}
-
-std::set<pt::idx_t> Tree::get_obe_tgt_v_idxs(std::size_t v_idx) const
-{
-	std::set<pt::idx_t> res{};
-	for (auto e_idx : this->nodes.at(v_idx).get_obe()) {
-		res.insert(this->back_edges.at(e_idx).get_tgt());
-	}
-	return res;
+	return this->frozen_;
 }
 
 bool Tree::is_root(std::size_t vertex) const
@@ -718,17 +689,20 @@ bool Tree::is_leaf(std::size_t vertex) const
 
 bool Tree::has_child(std::size_t vertex, std::size_t child_idx)
 {
-	return this->get_children(vertex).count(child_idx);
+	pv_cmp::span<const pt::idx_t> c = this->get_children(vertex);
+	return std::binary_search(c.begin(), c.end(), child_idx);
 }
 
 bool Tree::has_ibe(std::size_t vertex, std::size_t qry_idx)
 {
-	return this->get_ibe_src_v_idxs(vertex).count(qry_idx);
+	pv_cmp::span<const pt::idx_t> s = this->get_ibe_src_v_idxs(vertex);
+	return std::binary_search(s.begin(), s.end(), qry_idx);
 }
 
 bool Tree::has_obe(std::size_t vertex, std::size_t qry_idx)
 {
-	return this->get_obe_tgt_v_idxs(vertex).count(qry_idx);
+	pv_cmp::span<const pt::idx_t> t = this->get_obe_tgt_v_idxs(vertex);
+	return std::binary_search(t.begin(), t.end(), qry_idx);
 }
 
 Edge &Tree::get_incoming_edge(std::size_t vertex)
@@ -754,11 +728,6 @@ const Edge &Tree::get_tree_edge(std::size_t edge_idx) const
 	return this->tree_edges.at(edge_idx);
 }
 
-std::size_t Tree::get_graph_edge_id(std::size_t tree_edge_id) const
-{
-	return this->tree_graph_idx_map_.at(tree_edge_id);
-}
-
 BackEdge &Tree::get_backedge(std::size_t backedge_idx)
 {
 	return this->back_edges.at(backedge_idx);
@@ -771,126 +740,117 @@ const BackEdge &Tree::get_be(std::size_t backedge_idx) const
 
 BackEdge &Tree::get_backedge_ref_given_id(std::size_t backedge_id)
 {
-	std::size_t be_idx = this->be_id_to_idx_map_.at(backedge_id);
+	std::size_t be_idx = this->be_id_to_idx_.at(backedge_id);
 	return this->back_edges.at(be_idx);
 }
 
 BackEdge Tree::get_backedge_given_id(std::size_t backedge_id)
 {
-	std::size_t be_idx = this->be_id_to_idx_map_.at(backedge_id);
+	std::size_t be_idx = this->be_id_to_idx_.at(backedge_id);
 	return this->back_edges[be_idx];
 }
 
 void Tree::add_tree_edge(pt::idx_t frm, pt::idx_t to, pgt::color_e c)
 {
+	if (this->frozen_)
+		throw std::logic_error("cannot add an edge to a frozen tree");
+
 	std::size_t edge_idx = this->tree_edges.size();
 	std::size_t edge_count = edge_idx + this->back_edges.size();
 	this->tree_edges.push_back(Edge(edge_count, frm, to, c));
 
-	this->nodes[frm].add_child_e_idx(edge_idx);
+	this->nodes[frm].add_child(edge_idx, to);
 	this->nodes[to].set_parent_e_idx(edge_idx);
 }
 
 pt::idx_t Tree::add_be(pt::idx_t frm, pt::idx_t to, be_type_e t)
 {
+	if (this->frozen_)
+		throw std::logic_error("cannot add an edge to a frozen tree");
+
 	pt::idx_t back_edge_idx = this->back_edges.size();
 	pt::idx_t edge_count = back_edge_idx + this->tree_edges.size();
 	this->back_edges.push_back(BackEdge(edge_count, frm, to, t));
 	this->nodes[frm].add_obe(back_edge_idx);
 	this->nodes[to].add_ibe(back_edge_idx);
 
-	this->be_id_to_idx_map_[edge_count] = back_edge_idx;
+	if (this->be_id_to_idx_.size() <= edge_count)
+		this->be_id_to_idx_.resize(edge_count + 1, pc::INVALID_IDX);
+	this->be_id_to_idx_[edge_count] = back_edge_idx;
 
 	return back_edge_idx;
 }
 
-void Tree::set_hi(std::size_t vertex, std::size_t val)
+void Tree::freeze()
 {
-	this->nodes.at(vertex).set_hi(val);
-}
+	if (this->frozen_)
+		return;
 
-/**
- * insert the elements of the child bracket list at the
- * beginning of the parent bracket list
- *
- * TODO: make constant time
- *
- * @param parent_vertex
- * @param child_vertex
- */
-void Tree::concat_bracket_lists(std::size_t parent_vertex,
-				std::size_t child_vertex)
-{
-	std::string fn_name =
-		pv_cmp::format("[povu::spanning_tree::Tree::{}]", __func__);
-
-	WBracketList *bl_p = this->bracket_lists[parent_vertex];
-	WBracketList *bl_c = this->bracket_lists[child_vertex];
+	// every list is copied once, the targets and sources of the backedges
+	// take as much room as the backedges
+	std::size_t adj_size{};
+	for (const Vertex &v : this->nodes)
+		adj_size += (2 * v.get_child_edge_idxs().size()) +
+			    (2 * v.get_obe().size()) + (2 * v.get_ibe().size());
 
-	if (bl_p == nullptr) {
-		this->bracket_lists[parent_vertex] = bl_c;
-		this->bracket_lists[child_vertex] = nullptr;
-	}
-	else {
-		bl_p->concat(bl_c);
-	}
-}
+	this->adj_.clear();
+	this->adj_.reserve(adj_size); // views below rely on no reallocation
 
-// TODO: once deleted do we care to reflect changes in the concated ones?
-// WE DO!!
-/**
- * delete the bracket that is associated with the backedge
- * given a vertex id and a backedge idx
- */
-void Tree::del_bracket(std::size_t vertex, std::size_t backedge_idx)
-{
-	std::string fn_name =
-		pv_cmp::format("[povu::spanning_tree::Tree::{}]", __func__);
+	using row_t = pv_cmp::span<const pt::idx_t>;
 
-	std::size_t be_id = this->back_edges.at(backedge_idx).id();
-	this->bracket_lists[vertex]->del(be_id);
-}
+	auto begin_row = [&]() -> std::size_t
+	{
+		return this->adj_.size();
+	};
 
-void Tree::push(std::size_t vertex, std::size_t backege_idx)
-{
-	std::string fn_name =
-		pv_cmp::format("[povu::spanning_tree::{}]", __func__);
+	auto end_row = [&](std::size_t b) -> row_t
+	{
+		return {this->adj_.data() + b, this->adj_.size() - b};
+	};
 
-	// TODO: based on the Tree constructor we expect the pointer at v_idx
-	// will never be null why then do we need to check for null else code
-	// fails we then create a  bracket using the backedge ID
+	auto copy_row = [&](row_t r) -> row_t
+	{
+		std::size_t b = begin_row();
+		this->adj_.insert(this->adj_.end(), r.begin(), r.end());
+		return end_row(b);
+	};
 
-	if (this->bracket_lists[vertex] == nullptr) {
-		this->bracket_lists[vertex] = new WBracketList{};
-	}
+	// sort and drop duplicates, erasing keeps the capacity
+	auto unique_row = [&](std::size_t b) -> row_t
+	{
+		auto first = this->adj_.begin() + b;
+		std::sort(first, this->adj_.end());
+		this->adj_.erase(std::unique(first, this->adj_.end()),
+				 this->adj_.end());
+		return end_row(b);
+	};
 
-	this->bracket_lists[vertex]->push(
-		Bracket(this->back_edges.at(backege_idx).id()));
-}
+	for (Vertex &v : this->nodes) {
+		Vertex::adj_t csr;
+		csr.child_e_idxs = copy_row(v.get_child_edge_idxs());
+		csr.child_v_idxs = copy_row(v.get_children());
+		csr.obe = copy_row(v.get_obe());
+		csr.ibe = copy_row(v.get_ibe());
 
-BracketList &Tree::get_bracket_list(std::size_t vertex)
-{
-	std::string fn_name =
-		pv_cmp::format("[povu::spanning_tree::{}]", __func__);
-	if (this->bracket_lists[vertex] == nullptr) {
-		throw std::runtime_error(
-			pv_cmp::format("{} Bracket list is null", fn_name));
-	}
+		std::size_t b = begin_row();
+		for (pt::idx_t be_idx : csr.obe)
+			this->adj_.push_back(this->get_be(be_idx).get_tgt());
+		csr.obe_tgts = unique_row(b);
 
-	return this->bracket_lists[vertex]->get_bracket_list();
-}
+		b = begin_row();
+		for (pt::idx_t be_idx : csr.ibe)
+			this->adj_.push_back(this->get_be(be_idx).get_src());
+		csr.ibe_srcs = unique_row(b);
 
-Bracket &Tree::top(std::size_t vertex)
-{
-	std::string fn_name =
-		pv_cmp::format("[povu::spanning_tree::{}]", __func__);
+		v.freeze(csr);
+	}
 
-	return this->bracket_lists[vertex]->top();
+	this->frozen_ = true;
 }
 
-std::size_t Tree::new_class()
+void Tree::set_hi(std::size_t vertex, std::size_t val)
 {
-	return this->equiv_class_count_++;
+	this->nodes.at(vertex).set_hi(val);
 }
 
 /**
@@ -909,12 +869,6 @@ std::size_t Tree::new_class()
 // std::size_t Tree::get_sorted_g(std::size_t idx) { return
 // this->sort_g.at(idx);}
 
-const std::map<std::size_t, std::pair<be_type_e, std::size_t>> &
-Tree::get_g_edge_idx_map() const
-{
-	return this->g_edge_idx_map;
-}
-
 void Tree::print_dot(std::ostream &os)
 {
 
@@ -945,7 +899,7 @@ void Tree::print_dot(std::ostream &os)
 		os << str;
 	};
 
-	auto tree_edge_to_dot = [&](pt::idx_t p_v_idx, Edge &e)
+	auto tree_edge_to_dot = [&](pt::idx_t p_v_idx, const Edge &e)
 	{
 		std::string cls = e.get_class() == INVALID_CLS
 					  ? ""
@@ -958,13 +912,11 @@ void Tree::print_dot(std::ostream &os)
 			e.get_child_v_idx(), e.id(), cls, clr);
 	};
 
-	auto be_to_dot =
-		[&](pt::idx_t i, const std::pair<std::size_t, std::size_t> &o)
+	auto be_to_dot = [&](pt::idx_t i, const BackEdge &be)
 	{
-		auto [f, s] = o;
+		std::size_t f = be.id();
 		std::string cl = f > 10000 ? "\u2205" : std::to_string(f);
 		// a capping backedge is red and can never have been gray
-		BackEdge be = this->get_backedge_given_id(f);
 		std::string class_ = be.get_class() == INVALID_CLS
 					     ? ""
 					     : std::to_string(be.get_class());
@@ -1000,11 +952,11 @@ void Tree::print_dot(std::ostream &os)
 
 	// print the edges
 	for (std::size_t i{}; i < this->vtx_count(); i++) {
-		for (auto &c : this->get_child_edges_mut(i)) // tree edges
-			tree_edge_to_dot(i, c);
+		for (pt::idx_t e_idx : this->get_child_edge_idxs(i)) // tree edges
+			tree_edge_to_dot(i, this->get_tree_edge(e_idx));
 
-		for (auto o : this->get_obe_w_id(i)) // back edges
-			be_to_dot(i, o);
+		for (pt::idx_t be_idx : this->get_obe_idxs(i)) // back edges
+			be_to_dot(i, this->get_be(be_idx));
 	}
 
 	// end the dot format
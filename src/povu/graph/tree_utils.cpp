@@ -1,6 +1,5 @@
 #include <algorithm>	 // for max, min, sort
 #include <assert.h>	 // for assert
-#include <limits>	 // for numeric_limits
 #include <queue>	 // for priority_queue, queue
 #include <set>		 // for set
 #include <stack>	 // for stack
@@ -47,7 +46,7 @@ BranchDesc br_desc(const pst::Tree &st)
 	{
 		pt::idx_t black_e_idx = branch_desc[v_idx].black_e_idx;
 
-		const std::vector<pt::idx_t> &c_e_idxs =
+		pv_cmp::span<const pt::idx_t> c_e_idxs =
 			st.get_child_edge_idxs(v_idx);
 
 		std::vector<pt::idx_t> &temp_sorted =
@@ -409,37 +408,104 @@ void euler_tour(const pst::Tree &st, tree_meta &tm)
 	return;
 }
 
-pt::idx_t find_lca(const tree_meta &tm, std::vector<pt::idx_t> &vtxs)
+/*
+ * RMQ
+ * ---
+ */
+
+namespace
 {
+constexpr pt::idx_t RMQ_BLOCK{64};
 
-	// TODO: [B] replace with O(1) op
-	auto rmq = [&](pt::idx_t L, pt::idx_t R)
-	{
-		const auto &D = tm.D;
-		pt::idx_t minDepth = std::numeric_limits<pt::idx_t>::max();
-		pt::idx_t minPos = L;
-		for (pt::idx_t i = L; i <= R; ++i) {
-			if (D[i] < minDepth) {
-				minDepth = D[i];
-				minPos = i;
-			}
+inline pt::idx_t floor_log2(pt::idx_t x)
+{
+	return 31 - __builtin_clz(x);
+}
+} // namespace
+
+RMQ::RMQ(const std::vector<pt::idx_t> &a)
+{
+	const pt::idx_t n = static_cast<pt::idx_t>(a.size());
+	if (n == 0)
+		return;
+
+	// the bits set in a mask are the positions on a stack of non
+	// decreasing values, the lowest one at or after l is the first
+	// minimum of [l, i]
+	this->masks_.resize(n);
+	for (pt::idx_t b{}; b < n; b += RMQ_BLOCK) {
+		std::uint64_t m{};
+		pt::idx_t end = std::min(n, b + RMQ_BLOCK);
+		for (pt::idx_t i{b}; i < end; ++i) {
+			while (m != 0 && a[b + 63 - __builtin_clzll(m)] > a[i])
+				m &= ~(1ULL << (63 - __builtin_clzll(m)));
+
+			m |= 1ULL << (i - b);
+			this->masks_[i] = m;
 		}
-		return minPos;
+	}
+
+	this->block_count_ = (n + RMQ_BLOCK - 1) / RMQ_BLOCK;
+	const pt::idx_t bc = this->block_count_;
+	const pt::idx_t levels = floor_log2(bc) + 1;
+	this->sparse_.resize(static_cast<std::size_t>(levels) * bc);
+
+	for (pt::idx_t b{}; b < bc; ++b) {
+		pt::idx_t end = std::min(n, (b + 1) * RMQ_BLOCK) - 1;
+		this->sparse_[b] = this->in_block(b * RMQ_BLOCK, end);
+	}
+
+	for (pt::idx_t k{1}; k < levels; ++k) {
+		const pt::idx_t *prev = this->sparse_.data() + ((k - 1) * bc);
+		pt::idx_t *curr = this->sparse_.data() + (k * bc);
+		pt::idx_t half = 1U << (k - 1);
+		for (pt::idx_t b{}; b + (2 * half) <= bc; ++b) {
+			pt::idx_t x = prev[b];
+			pt::idx_t y = prev[b + half];
+			curr[b] = a[y] < a[x] ? y : x;
+		}
+	}
+}
+
+pt::idx_t RMQ::in_block(pt::idx_t l, pt::idx_t r) const
+{
+	pt::idx_t b = l - (l % RMQ_BLOCK);
+	std::uint64_t m = this->masks_[r] & (~0ULL << (l - b));
+	return b + __builtin_ctzll(m);
+}
+
+pt::idx_t RMQ::query(const std::vector<pt::idx_t> &a, pt::idx_t l,
+		     pt::idx_t r) const
+{
+	pt::idx_t bl = l / RMQ_BLOCK;
+	pt::idx_t br = r / RMQ_BLOCK;
+
+	if (bl == br)
+		return this->in_block(l, r);
+
+	// the leftmost of equal minima wins
+	auto min_of = [&a](pt::idx_t x, pt::idx_t y) -> pt::idx_t
+	{
+		return a[y] < a[x] ? y : x;
 	};
 
-	// auto rmq = [&](pt::idx_t L, pt::idx_t R) {
-	//   pt::idx_t min {pc::MAX_IDX};
-	//   const std::vector<pt::idx_t> &D = tm.D;
-	//   for (pt::idx_t i {L}; i <= R; i++){
-	//     std::cerr << pv_cmp::format("c {} {}, ", i, D[i]);
-	//     if( D[i] < min) {
-	//       min = D[i];
-	//     }
-	//   }
+	pt::idx_t m = this->in_block(l, ((bl + 1) * RMQ_BLOCK) - 1);
+
+	if (br - bl > 1) {
+		pt::idx_t fb = bl + 1;
+		pt::idx_t lb = br - 1;
+		pt::idx_t k = floor_log2(lb - fb + 1);
+		const pt::idx_t *lvl =
+			this->sparse_.data() + (k * this->block_count_);
+		m = min_of(m, lvl[fb]);
+		m = min_of(m, lvl[lb + 1 - (1U << k)]);
+	}
 
-	//   return min;
-	// };
+	return min_of(m, this->in_block(br * RMQ_BLOCK, r));
+}
 
+pt::idx_t find_lca(const tree_meta &tm, std::vector<pt::idx_t> &vtxs)
+{
 	// 1) find the bounding interval [L…R]
 	pt::idx_t L = {pc::MAX_IDX};
 	pt::idx_t R = 0;
@@ -463,7 +529,7 @@ pt::idx_t find_lca(const tree_meta &tm, std::vector<pt::idx_t> &vtxs)
 	//    std::swap(L, R);
 	// }
 
-	pt::idx_t m = rmq(L, R);
+	pt::idx_t m = tm.D_rmq.query(tm.D, L, R);
 
 	// std::cerr << "m: " << m << "\n";
 
@@ -509,7 +575,7 @@ std::vector<pt::idx_t> compute_be_count(pst::Tree &st)
 		be_count[v_idx] = be_map[v_idx].size();
 
 		//::idx_t be_count {0};
-		std::set<std::size_t> be_idxs = st.get_obe_idxs(v_idx);
+		pv_cmp::span<const pt::idx_t> be_idxs = st.get_obe_idxs(v_idx);
 
 		for (auto be_idx : be_idxs) {
 
@@ -599,15 +665,13 @@ void compute_depth(const pst::Tree &st, tree_meta &tm)
 
 void compute_pre_post(const pst::Tree &st, tree_meta &tm)
 {
-	std::map<pt::idx_t, pt::idx_t> &pre = tm.pre;
-	std::map<pt::idx_t, pt::idx_t> &post = tm.post;
+	std::vector<pt::idx_t> &pre = tm.pre;
+	std::vector<pt::idx_t> &post = tm.post;
 
-	// pt::idx_t exp_size = st.vtx_count();
-
-	// for (pt::idx_t i = 0; i < exp_size; ++i) {
-	//   pre.push_back(pc::INVALID_IDX);
-	//   post.push_back(pc::INVALID_IDX);
-	// }
+	// the pre and post orders of all the vertices are below this
+	pt::idx_t order_count = 2 * st.vtx_count();
+	pre.assign(order_count, pc::INVALID_IDX);
+	post.assign(order_count, pc::INVALID_IDX);
 
 	for (pt::idx_t i = 0; i < st.vtx_count(); ++i) {
 		const pst::Vertex &v = st.get_vertex(i);
@@ -679,6 +743,7 @@ tree_meta gen_tree_meta(const pst::Tree &st)
 	tree_meta tm;
 	euler_tour(st, tm);
 	compute_depth(st, tm);
+	tm.D_rmq = RMQ(tm.D);
 	compute_bracket_vals(st, tm);
 	compute_pre_post(st, tm);
 	pre_process(st, tm);
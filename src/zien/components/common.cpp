@@ -94,7 +94,7 @@ void comp_update_refs(const bd::VG &g, const mto::from_vcf::VCFile &vcf_file,
 
 		for (pt::u32 h_idx : ref_ids) {
 
-			const lq::ref_walk *rw = g.get_ref_vec(h_idx)->walk;
+			const lq::ref_walk *rw = g.get_ref_walk(h_idx);
 			pt::u32 N = rw->step_count;
 
 			curr_l.clear();
@@ -112,7 +112,7 @@ void comp_update_refs(const bd::VG &g, const mto::from_vcf::VCFile &vcf_file,
 			//	  << sn << "\n";
 
 			pt::u32 anchor_v_idx = g.v_id_to_idx(anchor_v_id);
-			const std::vector<pt::idx_t> &starts =
+			pv_cmp::span<const pt::idx_t> starts =
 				g.get_vertex_ref_idxs(anchor_v_idx, h_idx);
 
 			if (starts.empty())
@@ -93,7 +93,7 @@ matrix comp_hap_rows(const bd::VG &g, const std::vector<std::string> &order,
 		     std::vector<pt::u32> &col_width,
 		     std::vector<pt::u32> &hap_row_count)
 {
-	auto count_rows = [](const std::vector<pt::idx_t> &positions) -> pt::u32
+	auto count_rows = [](pv_cmp::span<const pt::idx_t> positions) -> pt::u32
 	{
 		pt::u32 N = positions.size();
 		if (N < 2)
@@ -108,7 +108,7 @@ matrix comp_hap_rows(const bd::VG &g, const std::vector<std::string> &order,
 	};
 
 	auto baz = [](const liteseq::ref_walk *rw,
-		      const std::vector<pt::idx_t> &positions, pt::u32 pos_idx,
+		      pv_cmp::span<const pt::idx_t> positions, pt::u32 pos_idx,
 		      pt::u32 order_step_idx,
 		      const std::vector<std::string> &order, pt::u32 &prev_pos,
 		      pt::u32 &w, cell &cell_)
@@ -123,7 +123,7 @@ matrix comp_hap_rows(const bd::VG &g, const std::vector<std::string> &order,
 		prev_pos = pos;
 	};
 
-	auto check_prev = [](const std::vector<pt::idx_t> &positions,
+	auto check_prev = [](pv_cmp::span<const pt::idx_t> positions,
 			     pt::u32 prev_pos, bool row_has_data,
 			     pt::u32 row_idx) -> std::vector<pt::u32>
 	{
@@ -166,7 +166,7 @@ matrix comp_hap_rows(const bd::VG &g, const std::vector<std::string> &order,
 		bool row_has_data{false};
 		hap_row row; // single hap row
 		for (pt::u32 v_idx{start}; v_idx < end; v_idx++) {
-			const std::vector<pt::idx_t> &positions =
+			pv_cmp::span<const pt::idx_t> positions =
 				g.get_vertex_ref_idxs(v_idx, hap_idx);
 
 			if (positions.empty()) {
@@ -248,7 +248,7 @@ void update_paths(const bd::VG &g, const ui_state &state, display_lines &pd)
 			pd.lh = tag.length();
 
 		// row content
-		const liteseq::ref_walk *rw = g.get_ref_vec(hap_idx)->walk;
+		const liteseq::ref_walk *rw = g.get_ref_walk(hap_idx);
 		pt::u32 N = std::min(rw->step_count, end);
 		matrix hap_rows = comp_hap_rows(g, order, hap_idx, start, N, rw,
 						col_width, hap_row_count);
@@ -23,10 +23,10 @@ unroll_tangle(const bd::VG &g, const pt::op_t<ptg::id_or_t> &ef)
 	auto [v, __] = ef.second;
 
 	for (pt::u32 h_idx{}; h_idx < g.get_hap_count(); h_idx++) {
-		const std::vector<pt::u32> &positions_u =
+		pv_cmp::span<const pt::u32> positions_u =
 			g.get_vertex_ref_idxs(g.v_id_to_idx(u), h_idx);
 
-		const std::vector<pt::u32> &positions_v =
+		pv_cmp::span<const pt::u32> positions_v =
 			g.get_vertex_ref_idxs(g.v_id_to_idx(v), h_idx);
 
 		pt::u32 N = std::min(positions_u.size(), positions_v.size());
@@ -55,7 +55,7 @@ ptg::walk_t slice_to_walk(const bd::VG &g, pt::u32 h_idx, const pt::slice &s)
 {
 	ptg::walk_t w;
 
-	const lq::ref_walk *rw = g.get_ref_vec(h_idx)->walk;
+	const lq::ref_walk *rw = g.get_ref_walk(h_idx);
 	for (pt::u32 i = s.start(); i < s.start() + s.len(); i++) {
 		pt::id_t v_id = rw->v_ids[i];
 		ptg::or_e o = lq_strand_to_or(rw->strands[i]);
@@ -128,7 +128,7 @@ struct bar {
 			//	  << ref_sl.len() << "\n";
 			pt::u32 ref_end = ref_start + (ref_sl.len() - 1);
 			// std::cerr << "ref end " << ref_end;
-			const lq::ref_walk *rw = g.get_ref_vec(ref_h_idx)->walk;
+			const lq::ref_walk *rw = g.get_ref_walk(ref_h_idx);
 
 			pt::u32 s = rw->loci[ref_start];
 			pt::u32 e = rw->loci[ref_end];
@@ -75,13 +75,13 @@ bool check_at(const bd::VG &g, const std::string &at, pt::idx_t ref_id)
 	ptg::walk_t w = at_to_walk(at);
 	pt::u32 at_len = w.size();
 	pt::u32 s = g.v_id_to_idx(w.front().v_id);
-	const std::vector<pt::idx_t> &positions =
+	pv_cmp::span<const pt::idx_t> positions =
 		g.get_vertex_ref_idxs(s, ref_id);
 
 	if (positions.empty())
 		return false;
 
-	const lq::ref_walk *rw = g.get_ref_vec(ref_id)->walk;
+	const lq::ref_walk *rw = g.get_ref_walk(ref_id);
 
 	bool any_of = false;
 
@@ -10,6 +10,7 @@
 
 #include "ita/genomics/genomics.hpp"
 #include "mto/from_gfa.hpp"
+#include "mto/to_manifest.hpp"
 #include "povu/common/app.hpp"
 #include "povu/common/bounded_queue.hpp"
 #include "povu/common/constants.hpp"
@@ -106,3 +107,59 @@ TEST(GenomicsTest, RunsSneForFinalPartialChunkAndEmitsSingleSubr)
 	std::filesystem::remove(gfa_fp);
 	EXPECT_EQ(subr_count, 1U);
 }
+
+TEST(GenomicsTest, ManifestRefRangesEndAtTheLastStep)
+{
+	const std::filesystem::path gfa_fp =
+		std::filesystem::temp_directory_path() /
+		("povu_manifest_ranges_" +
+		 std::to_string(std::chrono::steady_clock::now()
+					.time_since_epoch()
+					.count()) +
+		 ".gfa");
+	{
+		std::ofstream out(gfa_fp);
+		out << "H\tVN:Z:1.0\n";
+		out << "S\t1\tACGT\n";
+		out << "S\t2\tC\n";
+		out << "S\t3\tGG\n";
+		out << "S\t4\tTTT\n";
+		out << "S\t5\tAAA\n";
+		out << "S\t6\tC\n";
+		out << "L\t1\t+\t2\t+\t0M\n";
+		out << "L\t1\t+\t3\t+\t0M\n";
+		out << "L\t2\t+\t4\t+\t0M\n";
+		out << "L\t3\t+\t4\t+\t0M\n";
+		out << "L\t5\t+\t6\t+\t0M\n";
+		out << "P\tref\t1+,2+,4+\t*\n";
+		out << "P\talt\t1+,3+,4+\t*\n";
+		out << "P\tother\t5+,6+\t*\n";
+	}
+
+	// the ranges need the refs but not the labels, as in decompose
+	core::config app_config = sne_subr_config(gfa_fp);
+	app_config.set_inc_vtx_labels(false);
+	std::unique_ptr<bd::VG> graph(mto::from_gfa::to_bd(app_config));
+	std::filesystem::remove(gfa_fp);
+
+	bd::ComponentGenerator components(*graph);
+	ASSERT_EQ(components.size(), 2U);
+
+	std::vector<mto::manifest::ref_range_t> first =
+		mto::to_manifest::ref_ranges(*graph, components.vtxs(0));
+	ASSERT_EQ(first.size(), 2U);
+	EXPECT_EQ(first[0].ref, "alt");
+	EXPECT_EQ(first[0].start_locus, 0U);
+	EXPECT_EQ(first[0].end_locus, 9U);
+	// 4 starts at 5 on ref, the range ends after it and not at 5
+	EXPECT_EQ(first[1].ref, "ref");
+	EXPECT_EQ(first[1].start_locus, 0U);
+	EXPECT_EQ(first[1].end_locus, 8U);
+
+	std::vector<mto::manifest::ref_range_t> second =
+		mto::to_manifest::ref_ranges(*graph, components.vtxs(1));
+	ASSERT_EQ(second.size(), 1U);
+	EXPECT_EQ(second[0].ref, "other");
+	EXPECT_EQ(second[0].start_locus, 0U);
+	EXPECT_EQ(second[0].end_locus, 4U);
+}
@@ -1,11 +1,30 @@
 #include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <set>
+#include <string>
 #include <vector>
 
+#include "mto/from_forest.hpp"
+#include "mto/from_gfa.hpp"
+#include "mto/from_manifest.hpp"
+#include "mto/from_pvst.hpp"
+#include "mto/to_forest.hpp"
+#include "mto/to_manifest.hpp"
+#include "mto/to_pvst.hpp"
+#include "povu/algorithms/concealed.hpp"
 #include "povu/algorithms/flubbles.hpp"
+#include "povu/algorithms/midi.hpp"
+#include "povu/algorithms/parallel.hpp"
+#include "povu/algorithms/smothered.hpp"
+#include "povu/algorithms/subflubbles.hpp"
+#include "povu/algorithms/tiny.hpp"
 #include "povu/common/app.hpp"
 #include "povu/graph/bidirected.hpp"
 #include "povu/graph/pvst.hpp"
 #include "povu/graph/spanning_tree.hpp"
+#include "povu/graph/tree_utils.hpp"
 
 namespace pfl = povu::flubbles;
 
@@ -66,6 +85,22 @@ pvst::Tree decompose_and_cleanup()
 	return pvst;
 }
 
+// the vertices of @p a and @p b match in order, and so do their children
+void expect_same_pvst(const pvst::Tree &a, const pvst::Tree &b)
+{
+	ASSERT_EQ(a.vtx_count(), b.vtx_count());
+	EXPECT_EQ(a.root_idx(), b.root_idx());
+	for (pt::idx_t i = 0; i < a.vtx_count(); ++i) {
+		EXPECT_EQ(a.get_vertex(i).as_str(), b.get_vertex(i).as_str());
+		EXPECT_EQ(a.get_vertex(i).get_fam(), b.get_vertex(i).get_fam());
+
+		pv_cmp::span<const pt::idx_t> ac = a.get_children(i);
+		pv_cmp::span<const pt::idx_t> bc = b.get_children(i);
+		EXPECT_EQ(std::vector<pt::idx_t>(ac.begin(), ac.end()),
+			  std::vector<pt::idx_t>(bc.begin(), bc.end()));
+	}
+}
+
 TEST(PVSTTest, VertexCount)
 {
 	pvst::Tree pvst = decompose_and_cleanup();
@@ -96,7 +131,7 @@ TEST(PVSTTest, VertexHierarchy)
 	for (pt::idx_t i = 0; i < pvst.vtx_count(); ++i) {
 		const pvst::VertexBase &v = pvst.get_vertex(i);
 
-		const std::vector<pt::idx_t> &children = pvst.get_children(i);
+		pv_cmp::span<const pt::idx_t> children = pvst.get_children(i);
 
 		if (v.as_str() == ".") {
 			EXPECT_EQ(pvst.root_idx(), i);
@@ -126,3 +161,342 @@ TEST(PVSTTest, VertexHierarchy)
 		}
 	}
 }
+
+TEST(PVSTTest, FreezeKeepsChildren)
+{
+	pvst::Tree pvst = decompose_and_cleanup();
+
+	std::vector<std::vector<pt::idx_t>> before;
+	for (pt::idx_t i = 0; i < pvst.vtx_count(); ++i) {
+		pv_cmp::span<const pt::idx_t> ch = pvst.get_children(i);
+		before.emplace_back(ch.begin(), ch.end());
+	}
+
+	pvst.freeze();
+	EXPECT_TRUE(pvst.is_frozen());
+
+	for (pt::idx_t i = 0; i < pvst.vtx_count(); ++i) {
+		pv_cmp::span<const pt::idx_t> ch = pvst.get_children(i);
+		EXPECT_EQ(std::vector<pt::idx_t>(ch.begin(), ch.end()),
+			  before[i]);
+	}
+
+	EXPECT_THROW(pvst.add_edge(pvst.root_idx(), 0), std::logic_error);
+}
+
+TEST(PVSTTest, BinaryMatchesText)
+{
+	pvst::Tree pvst = decompose_and_cleanup();
+
+	const std::filesystem::path dir =
+		std::filesystem::temp_directory_path() / "povu_pvst_bin_test";
+	std::filesystem::create_directories(dir);
+
+	core::config conf = create_test_config();
+	conf.set_output_dir(dir.string());
+	mto::to_pvst::write_pvst(pvst, "text", conf);
+	conf.set_binary_pvst(true);
+	mto::to_pvst::write_pvst(pvst, "bin", conf);
+
+	pvst::Tree txt = pv_frm_pvst::read_pvst((dir / "text.pvst").string());
+	pvst::Tree bin = pv_frm_pvst::read_pvst((dir / "bin.pvst").string());
+	std::filesystem::remove_all(dir);
+
+	EXPECT_TRUE(bin.is_frozen());
+	expect_same_pvst(bin, txt);
+}
+
+TEST(PVSTTest, CompactChainsKeepsTheTree)
+{
+	// 2 to 14 by the run 3 .. 9, by an edge and by the bubble 10 .. 13,
+	// the run is walked after the bubble
+	bd::VG g(15, 18, 0);
+	for (pt::id_t v_id{1}; v_id <= 15; ++v_id)
+		g.add_vertex(v_id, "A");
+
+	auto fwd = [&](pt::id_t a, pt::id_t b)
+	{ g.add_edge(a, bd::v_end_e::r, b, bd::v_end_e::l); };
+
+	fwd(1, 2);
+	fwd(1, 15);
+	fwd(2, 3);
+	fwd(2, 10);
+	fwd(2, 14);
+	for (pt::id_t v_id{3}; v_id < 9; ++v_id)
+		fwd(v_id, v_id + 1);
+	fwd(9, 14);
+	fwd(10, 11);
+	fwd(10, 12);
+	fwd(11, 13);
+	fwd(12, 13);
+	fwd(13, 14);
+	fwd(14, 15);
+	g.add_tip(1, bd::v_end_e::l);
+	g.add_tip(15, bd::v_end_e::r);
+	g.freeze();
+
+	bd::VG *cg = bd::VG::compact_chains(g);
+	EXPECT_LT(cg->vtx_count(), g.vtx_count());
+
+	core::config conf = create_test_config();
+	pvst::Tree t = decompose(&g, conf);
+	pvst::Tree ct = decompose(cg, conf);
+	delete cg;
+
+	expect_same_pvst(ct, t);
+}
+
+// some subflubbles are labelled in an order other than their route
+TEST(PVSTTest, BinaryMatchesTextWithSubflubbles)
+{
+	core::config conf = create_test_config();
+	conf.set_input_gfa((std::filesystem::path(POVU_SOURCE_DIR) / "tests" /
+			    "data" / "LPA.gfa")
+				   .string());
+	conf.set_inc_vtx_labels(false);
+	conf.set_inc_refs(false);
+	bd::VG *vg = mto::from_gfa::to_bd(conf);
+	std::vector<bd::VG *> components = bd::VG::componetize(*vg);
+	delete vg;
+
+	const std::filesystem::path dir =
+		std::filesystem::temp_directory_path() / "povu_pvst_sub_test";
+	std::filesystem::create_directories(dir);
+	conf.set_output_dir(dir.string());
+
+	pt::idx_t subflubble_count{};
+	for (bd::VG *component : components) {
+		pst::Tree st = pst::Tree::from_bd(*component);
+		delete component;
+		pvst::Tree ft = pfl::find_flubbles(st, conf);
+		povu::tree_utils::tree_meta tm =
+			povu::tree_utils::gen_tree_meta(st);
+		povu::subflubbles::find_subflubbles(st, ft, tm);
+
+		conf.set_binary_pvst(false);
+		mto::to_pvst::write_pvst(ft, "text", conf);
+		pvst::Tree txt =
+			pv_frm_pvst::read_pvst((dir / "text.pvst").string());
+		pvst::Tree bin = pv_frm_pvst::from_bin(
+			mto::to_pvst::to_bin(ft), "bin.pvst");
+
+		ASSERT_EQ(bin.vtx_count(), txt.vtx_count());
+		for (pt::idx_t i = 0; i < txt.vtx_count(); ++i) {
+			const pvst::VertexBase &b = bin.get_vertex(i);
+			const pvst::VertexBase &t = txt.get_vertex(i);
+			EXPECT_EQ(b.as_str(), t.as_str());
+			EXPECT_EQ(b.get_fam(), t.get_fam());
+
+			std::optional<pvst::route_params_t> brp =
+				b.get_route_params();
+			std::optional<pvst::route_params_t> trp =
+				t.get_route_params();
+			ASSERT_EQ(brp.has_value(), trp.has_value());
+			if (brp) {
+				EXPECT_EQ(brp->route, trp->route);
+			}
+
+			if (t.get_fam() == pvst::vt_e::concealed ||
+			    t.get_fam() == pvst::vt_e::smothered ||
+			    t.get_fam() == pvst::vt_e::midi)
+				++subflubble_count;
+		}
+	}
+	std::filesystem::remove_all(dir);
+
+	EXPECT_GT(subflubble_count, 0U);
+}
+
+// a concealed bubble of flubble 6 .. 7 is nested under the child flubble
+// 8 .. 9, which then holds two concealed bubbles and a midi bubble
+TEST(PVSTTest, SubflubblesMatchTheSeparateFinders)
+{
+	bd::VG g(20, 28, 0);
+	for (pt::id_t v_id{1}; v_id <= 20; ++v_id)
+		g.add_vertex(v_id, "A");
+
+	auto fwd = [&](pt::id_t a, pt::id_t b)
+	{ g.add_edge(a, bd::v_end_e::r, b, bd::v_end_e::l); };
+
+	for (auto [a, b] : std::vector<std::pair<pt::id_t, pt::id_t>>{
+		     {1, 2},   {2, 4},	 {4, 5},   {5, 3},   {2, 6},   {6, 7},
+		     {6, 8},   {8, 10},	 {10, 11}, {11, 9},  {8, 12},  {12, 13},
+		     {13, 9},  {8, 9},	 {9, 7},   {7, 15},  {15, 16}, {16, 17},
+		     {17, 14}, {7, 14},	 {7, 18},  {18, 19}, {19, 20}, {20, 14},
+		     {14, 3},  {16, 18}, {3, 8},   {8, 11}})
+		fwd(a, b);
+	g.add_tip(1, bd::v_end_e::l);
+	g.add_tip(3, bd::v_end_e::r);
+	g.freeze();
+
+	core::config conf = create_test_config();
+
+	pst::Tree st = pst::Tree::from_bd(g);
+	pvst::Tree t = pfl::find_flubbles(st, conf);
+	povu::tree_utils::tree_meta tm = povu::tree_utils::gen_tree_meta(st);
+	povu::tiny::find_tiny(st, t, tm);
+	povu::parallel::find_parallel(st, t, tm);
+	povu::concealed::find_concealed(st, t, tm);
+	povu::midi::find_midi(st, t, tm);
+	povu::smothered::find_smothered(st, t, tm);
+
+	// find_flubbles adds the capping and simplifying backedges to the tree
+	pst::Tree fst = pst::Tree::from_bd(g);
+	pvst::Tree ft = pfl::find_flubbles(fst, conf);
+	povu::tree_utils::tree_meta ftm = povu::tree_utils::gen_tree_meta(fst);
+	povu::subflubbles::find_subflubbles(fst, ft, ftm);
+
+	expect_same_pvst(ft, t);
+
+	pt::idx_t midi_count{};
+	for (pt::idx_t i = 0; i < t.vtx_count(); ++i)
+		if (t.get_vertex(i).get_fam() == pvst::vt_e::midi)
+			++midi_count;
+
+	EXPECT_EQ(midi_count, 1U);
+}
+
+// the right side of 1 is a cut vertex with three petals, cycles of bubbles
+// back to it, each a block of the graph of the spanning tree large enough to
+// be handled on a thread of its own
+TEST(PVSTTest, SplitClassesMatchOneThread)
+{
+	const pt::id_t petal_count{3};
+	const pt::id_t bubble_count{700};
+	const pt::id_t vtx_count{1 + (petal_count * bubble_count * 3)};
+	bd::VG g(vtx_count, petal_count * ((4 * bubble_count) + 1), 0);
+	for (pt::id_t v_id{1}; v_id <= vtx_count; ++v_id)
+		g.add_vertex(v_id, "A");
+
+	auto fwd = [&](pt::id_t a, pt::id_t b)
+	{ g.add_edge(a, bd::v_end_e::r, b, bd::v_end_e::l); };
+
+	pt::id_t last{1};
+	for (pt::id_t p{}; p < petal_count; ++p) {
+		pt::id_t prev{1};
+		for (pt::id_t b{}; b < bubble_count; ++b) {
+			pt::id_t u{++last}, w{++last}, z{++last};
+			fwd(prev, u);
+			fwd(prev, w);
+			fwd(u, z);
+			fwd(w, z);
+			prev = z;
+		}
+		g.add_edge(prev, bd::v_end_e::r, 1, bd::v_end_e::r);
+	}
+	g.add_tip(1, bd::v_end_e::l);
+	g.freeze();
+
+	core::config conf = create_test_config();
+	povu::thread::thread_pool pool(4);
+
+	pst::Tree st = pst::Tree::from_bd(g);
+	pvst::Tree ft = pfl::find_flubbles(st, conf);
+	povu::tree_utils::tree_meta tm = povu::tree_utils::gen_tree_meta(st);
+	povu::subflubbles::find_subflubbles(st, ft, tm);
+
+	pst::Tree sst = pst::Tree::from_bd(g);
+	pvst::Tree sft = pfl::find_flubbles(sst, conf, &pool);
+	povu::tree_utils::tree_meta stm = povu::tree_utils::gen_tree_meta(sst);
+	povu::subflubbles::find_subflubbles(sst, sft, stm);
+
+	ASSERT_EQ(sst.vtx_count(), st.vtx_count());
+	for (pt::idx_t v{}; v < st.vtx_count(); ++v)
+		EXPECT_EQ(sst.get_vertex(v).hi(), st.get_vertex(v).hi());
+
+	for (pt::idx_t e{}; e < st.tree_edge_count(); ++e)
+		EXPECT_EQ(sst.get_tree_edge(e).get_class(),
+			  st.get_tree_edge(e).get_class());
+
+	ASSERT_EQ(sst.back_edge_count(), st.back_edge_count());
+	for (pt::idx_t b{}; b < st.back_edge_count(); ++b) {
+		const pst::BackEdge &sbe = sst.get_be(b);
+		const pst::BackEdge &be = st.get_be(b);
+		EXPECT_EQ(sbe.get_src(), be.get_src());
+		EXPECT_EQ(sbe.get_tgt(), be.get_tgt());
+		EXPECT_EQ(sbe.type(), be.type());
+		EXPECT_EQ(sbe.get_class(), be.get_class());
+	}
+
+	EXPECT_GT(ft.vtx_count(), bubble_count * (petal_count - 1));
+	expect_same_pvst(sft, ft);
+}
+
+TEST(PVSTTest, ForestArchiveByComponent)
+{
+	pvst::Tree pvst = decompose_and_cleanup();
+
+	const std::filesystem::path fp =
+		std::filesystem::temp_directory_path() / "povu_forest_test.pvf";
+
+	{
+		mto::to_forest::Writer forest(fp);
+		forest.add(7, pvst);
+		forest.add(3, pvst);
+		forest.finish();
+		EXPECT_THROW(forest.add(5, pvst), std::logic_error);
+	}
+
+	ASSERT_TRUE(mto::from_forest::is_forest(fp.string()));
+	mto::from_forest::Reader forest(fp.string());
+	ASSERT_EQ(forest.size(), 2);
+	EXPECT_EQ(forest.component_id(0), 3);
+	EXPECT_EQ(forest.component_id(1), 7);
+
+	pvst::Tree t = forest.read(1);
+	std::filesystem::remove(fp);
+
+	expect_same_pvst(t, pvst);
+}
+
+TEST(PVSTTest, ManifestRoundTrip)
+{
+	const std::filesystem::path fp =
+		std::filesystem::temp_directory_path() / "povu_manifest.tsv";
+
+	{
+		mto::to_manifest::Writer manifest(fp);
+		manifest.add(4, {{"HG002#1#chr1", 10, 90},
+				 {"ref#chr1", 0, 80}});
+		manifest.add(2, {});
+		manifest.finish();
+	}
+
+	mto::manifest::manifest_t m =
+		mto::from_manifest::read_manifest(fp.string());
+	std::filesystem::remove(fp);
+
+	ASSERT_EQ(m.size(), 2);
+	EXPECT_TRUE(m.at(2).empty());
+
+	const std::vector<mto::manifest::ref_range_t> &ranges = m.at(4);
+	ASSERT_EQ(ranges.size(), 2);
+	EXPECT_EQ(ranges[0].ref, "HG002#1#chr1");
+	EXPECT_EQ(ranges[0].start_locus, 10);
+	EXPECT_EQ(ranges[0].end_locus, 90);
+	EXPECT_EQ(ranges[1].ref, "ref#chr1");
+}
+
+TEST(PVSTTest, ManifestSkips)
+{
+	mto::manifest::manifest_t m;
+	m[1] = {{"alt", 0, 40}, {"ref", 0, 100}};
+	m[2] = {{"ref", 100, 250}};
+	m[3] = {};
+
+	using skips_t = std::set<std::uint64_t>;
+	auto find_skips = [&](const std::set<std::string> &tags,
+			      std::optional<mto::manifest::region_t> region)
+	{ return mto::from_manifest::find_skips(m, tags, region); };
+
+	// every ref to call must pass through the component
+	EXPECT_EQ(find_skips({}, std::nullopt), skips_t{});
+	EXPECT_EQ(find_skips({"ref"}, std::nullopt), (skips_t{3}));
+	EXPECT_EQ(find_skips({"alt", "ref"}, std::nullopt), (skips_t{2, 3}));
+
+	// the last vertex of 1 starts before 95 but ends in the region
+	EXPECT_EQ(find_skips({"ref"}, {{"ref", 95, 120}}), (skips_t{3}));
+	// the end locus is exclusive
+	EXPECT_EQ(find_skips({"ref"}, {{"ref", 100, 120}}), (skips_t{1, 3}));
+	EXPECT_EQ(find_skips({}, {{"alt", 50, 60}}), (skips_t{1, 2, 3}));
+}
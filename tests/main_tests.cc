@@ -7,4 +7,7 @@
 #include "./integration_tests/pvst_tests.cc"
 
 // unit tests
+#include "./unit_tests/bidirected_tests.cc"
+#include "./unit_tests/gfa_tests.cc"
 #include "./unit_tests/spanning_tree_tests.cc"
+#include "./unit_tests/tree_utils_tests.cc"
@@ -0,0 +1,392 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "mto/from_index.hpp"
+#include "mto/index.hpp"
+#include "mto/to_index.hpp"
+#include "povu/common/app.hpp"
+#include "povu/common/utils.hpp" // for reverse_complement
+#include "povu/graph/bidirected.hpp"
+#include "povu/graph/label_store.hpp"
+
+namespace povu::unit_tests_bidirected
+{
+namespace bd = povu::bidirected;
+
+bd::VertexIdMap map_ids(const std::vector<pt::id_t> &v_ids)
+{
+	bd::VertexIdMap m;
+	for (pt::id_t v_id : v_ids)
+		m.push_back(v_id);
+
+	return m;
+}
+
+// patch the u32 at @p off of a copy of the index at fp and load the copy
+void expect_rejected(const std::filesystem::path &fp, std::uint64_t off,
+		     std::uint32_t value, const core::config &cfg)
+{
+	const std::filesystem::path bad = fp.string() + ".bad";
+	std::filesystem::copy_file(
+		fp, bad, std::filesystem::copy_options::overwrite_existing);
+	{
+		std::fstream f(bad, std::ios::binary | std::ios::in |
+					    std::ios::out);
+		f.seekp(static_cast<std::streamoff>(off));
+		f.write(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+
+	EXPECT_THROW(mto::from_index::to_bd(bad.string(), cfg),
+		     std::runtime_error);
+	std::filesystem::remove(bad);
+}
+
+void expect_round_trip(const bd::VertexIdMap &m,
+		       const std::vector<pt::id_t> &v_ids)
+{
+	for (pt::idx_t v_idx{}; v_idx < v_ids.size(); ++v_idx) {
+		EXPECT_EQ(m.get_idx(v_ids[v_idx]), v_idx);
+		EXPECT_EQ(m.get_id(v_idx), v_ids[v_idx]);
+	}
+}
+
+TEST(VertexIdMapTest, DenseIds)
+{
+	std::vector<pt::id_t> v_ids{1, 2, 3, 4, 5};
+	bd::VertexIdMap m = map_ids(v_ids);
+
+	EXPECT_EQ(m.mode(), bd::id_map_e::dense);
+	expect_round_trip(m, v_ids);
+	EXPECT_EQ(m.get_idx(0), 0);
+	EXPECT_EQ(m.get_idx(6), 0);
+}
+
+TEST(VertexIdMapTest, GappedIds)
+{
+	std::vector<pt::id_t> v_ids{10, 11, 14, 12, 7};
+	bd::VertexIdMap m = map_ids(v_ids);
+
+	EXPECT_EQ(m.mode(), bd::id_map_e::flat);
+	expect_round_trip(m, v_ids);
+	EXPECT_EQ(m.get_idx(13), 0);
+}
+
+TEST(VertexIdMapTest, SparseIds)
+{
+	std::vector<pt::id_t> v_ids{1, 1000000, 50, 3000000000};
+	bd::VertexIdMap m = map_ids(v_ids);
+
+	EXPECT_EQ(m.mode(), bd::id_map_e::hashed);
+	expect_round_trip(m, v_ids);
+	EXPECT_EQ(m.get_idx(2), 0);
+}
+
+void expect_labels(const bd::LabelStore &s,
+		   const std::vector<pt::idx_t> &l_idxs,
+		   const std::vector<std::string> &labels)
+{
+	for (std::size_t i{}; i < labels.size(); ++i) {
+		std::string fwd;
+		std::string rc;
+		s.append(l_idxs[i], fwd);
+		s.append_rc(l_idxs[i], rc);
+
+		EXPECT_EQ(s.length(l_idxs[i]), labels[i].size());
+		EXPECT_EQ(fwd, labels[i]);
+		EXPECT_EQ(rc, povu::utils::reverse_complement(labels[i]));
+	}
+}
+
+TEST(LabelStoreTest, PackedLabels)
+{
+	// long enough to straddle packed words, with a non ACGT fallback
+	std::vector<std::string> labels{
+		"ACGT", "GATTACAGATTACAGATTACAGATTACAGATTACA", "ACNGT", "T",
+		std::string(70, 'G') + "CAT"};
+
+	bd::LabelStore s(bd::label_enc_e::packed);
+	std::vector<pt::idx_t> l_idxs;
+	for (const std::string &l : labels)
+		l_idxs.push_back(s.add(l));
+
+	EXPECT_EQ(s.add(""), pc::INVALID_IDX);
+	expect_labels(s, l_idxs, labels);
+}
+
+TEST(LabelStoreTest, BackedLabels)
+{
+	auto gfa =
+		std::make_shared<const std::string>("S\t1\tACGT\nS\t2\tTTG\n");
+	bd::LabelStore s(gfa, *gfa);
+
+	std::string_view v(*gfa);
+	std::vector<pt::idx_t> l_idxs{s.add(v.substr(4, 4)),
+				      s.add(v.substr(13, 3)), s.add("GGA")};
+
+	expect_labels(s, l_idxs, {"ACGT", "TTG", "GGA"});
+}
+
+TEST(VGTest, CompactChains)
+{
+	using bd::v_end_e;
+
+	// two bubbles joined by the run 5+ 6- 7+
+	bd::VG g(11, 12, 0);
+	for (pt::id_t v_id{1}; v_id <= 11; ++v_id)
+		g.add_vertex(v_id, "A");
+
+	auto fwd = [&](pt::id_t a, pt::id_t b)
+	{ g.add_edge(a, v_end_e::r, b, v_end_e::l); };
+
+	fwd(1, 2);
+	fwd(1, 3);
+	fwd(2, 4);
+	fwd(3, 4);
+	fwd(4, 5);
+	g.add_edge(5, v_end_e::r, 6, v_end_e::r);
+	g.add_edge(6, v_end_e::l, 7, v_end_e::l);
+	fwd(7, 8);
+	fwd(8, 9);
+	fwd(8, 10);
+	fwd(9, 11);
+	fwd(10, 11);
+	g.add_tip(1, v_end_e::l);
+	g.add_tip(11, v_end_e::r);
+	g.freeze();
+
+	bd::VG *cg = bd::VG::compact_chains(g);
+
+	// 6 is dropped and 5 is joined to 7, the bubbles are unchanged
+	EXPECT_EQ(cg->vtx_count(), 10);
+	EXPECT_EQ(cg->edge_count(), 11);
+	EXPECT_EQ(cg->tips().size(), 2);
+
+	const bd::Vertex &v5 = cg->get_vertex_by_id(5);
+	ASSERT_EQ(v5.get_edges_r().size(), 1);
+	auto [side, v_idx] = cg->get_edge(v5.get_edges_r()[0])
+				     .get_other_vtx(cg->v_id_to_idx(5),
+						    v_end_e::r);
+	EXPECT_EQ(cg->v_idx_to_id(v_idx), 7);
+	EXPECT_EQ(side, v_end_e::l);
+	EXPECT_EQ(cg->get_vertex_by_id(1).get_edges_r().size(), 2);
+
+	delete cg;
+}
+
+TEST(VGTest, IndexRewrittenOverItself)
+{
+	const std::filesystem::path fp =
+		std::filesystem::temp_directory_path() / "povu_index_test.pvg";
+
+	bd::VG g(3, 2, 0);
+	g.add_vertex(1, "ACGT");
+	g.add_vertex(2, "T");
+	g.add_vertex(3, "GGA");
+	g.add_edge(1, bd::v_end_e::r, 2, bd::v_end_e::l);
+	g.add_edge(2, bd::v_end_e::r, 3, bd::v_end_e::l);
+	g.freeze();
+	mto::to_index::write_index(g, "in.gfa", fp);
+
+	core::config cfg;
+	cfg.set_inc_vtx_labels(true);
+
+	// the labels of g1 are views into the mapping of fp
+	bd::VG *g1 = mto::from_index::to_bd(fp.string(), cfg);
+	mto::to_index::write_index(*g1, "in.gfa", fp);
+	delete g1;
+
+	bd::VG *g2 = mto::from_index::to_bd(fp.string(), cfg);
+	std::filesystem::remove(fp);
+
+	ASSERT_EQ(g2->vtx_count(), 3);
+	EXPECT_EQ(g2->edge_count(), 2);
+	EXPECT_TRUE(g2->is_frozen());
+	EXPECT_EQ(g2->get_vertex_by_id(1).get_label(), "ACGT");
+	EXPECT_EQ(g2->get_vertex_by_id(3).get_label(), "GGA");
+
+	const bd::Vertex &v2 = g2->get_vertex_by_id(2);
+	ASSERT_EQ(v2.get_edges_l().size(), 1);
+	ASSERT_EQ(v2.get_edges_r().size(), 1);
+	EXPECT_EQ(g2->get_edge(v2.get_edges_l()[0]).get_v1_idx(),
+		  g2->v_id_to_idx(1));
+	EXPECT_EQ(g2->get_edge(v2.get_edges_r()[0]).get_v2_idx(),
+		  g2->v_id_to_idx(3));
+
+	delete g2;
+}
+
+TEST(VGTest, IndexKeepsTheIdMap)
+{
+	const std::filesystem::path fp =
+		std::filesystem::temp_directory_path() / "povu_ids_test.pvg";
+
+	core::config cfg;
+	// gapped ids map flat, sparse ones hashed
+	for (const std::vector<pt::id_t> &v_ids :
+	     {std::vector<pt::id_t>{10, 12, 11, 15},
+	      std::vector<pt::id_t>{5, 1000000, 3, 70000}}) {
+		bd::VG g(4, 3, 0);
+		for (pt::id_t v_id : v_ids)
+			g.add_vertex(v_id, "");
+		for (pt::idx_t i{}; i + 1 < v_ids.size(); ++i)
+			g.add_edge(v_ids[i], bd::v_end_e::r, v_ids[i + 1],
+				   bd::v_end_e::l);
+		g.freeze();
+		mto::to_index::write_index(g, "in.gfa", fp);
+
+		bd::VG *ig = mto::from_index::to_bd(fp.string(), cfg);
+		EXPECT_EQ(ig->id_map_mode(), g.id_map_mode());
+		for (pt::idx_t v_idx{}; v_idx < v_ids.size(); ++v_idx) {
+			EXPECT_EQ(ig->v_id_to_idx(v_ids[v_idx]), v_idx);
+			EXPECT_EQ(ig->v_idx_to_id(v_idx), v_ids[v_idx]);
+		}
+		EXPECT_EQ(ig->get_vertex_by_id(v_ids[1]).get_edges_r().size(),
+			  1);
+		delete ig;
+	}
+
+	std::filesystem::remove(fp);
+}
+
+TEST(VGTest, CorruptIndexIsRejected)
+{
+	namespace mi = mto::index;
+
+	const std::filesystem::path fp =
+		std::filesystem::temp_directory_path() / "povu_corrupt_test.pvg";
+
+	bd::VG g(3, 2, 0);
+	g.add_vertex(1, "ACGT");
+	g.add_vertex(2, "T");
+	g.add_vertex(3, "GGA");
+	g.add_edge(1, bd::v_end_e::r, 2, bd::v_end_e::l);
+	g.add_edge(2, bd::v_end_e::r, 3, bd::v_end_e::l);
+	g.add_tip(1, bd::v_end_e::l);
+	g.add_tip(3, bd::v_end_e::r);
+	g.freeze();
+	mto::to_index::write_index(g, "in.gfa", fp);
+
+	core::config cfg;
+	cfg.set_inc_vtx_labels(true);
+
+	// both edges are listed at both of their ends, the ids are dense
+	const std::uint64_t adj_offsets = sizeof(mi::header_t) +
+					  mi::align8(3 * 4) +
+					  mi::align8(2 * 4 * 4);
+	const std::uint64_t adj = adj_offsets + mi::align8(7 * 8);
+	const std::uint64_t tips = adj + mi::align8(4 * 4);
+	const std::uint64_t label_offsets = tips + mi::align8(2 * 2 * 4);
+
+	// the first vertex id, off the dense range
+	expect_rejected(fp, sizeof(mi::header_t), 7, cfg);
+	// the edge on the right of vertex 1, past the edges
+	expect_rejected(fp, adj, 2, cfg);
+	// the same, an edge that is not on vertex 1
+	expect_rejected(fp, adj, 1, cfg);
+	// the id of the first tip
+	expect_rejected(fp, tips + 4, 99, cfg);
+	// the end of the last label, past the label bytes
+	expect_rejected(fp, label_offsets + (3 * 8), 1000, cfg);
+	// the high half of the vertex count, too many for pt::idx_t
+	expect_rejected(fp, offsetof(mi::header_t, vtx_count) + 4, 1, cfg);
+	// the high half of the tip count, the tips size wraps to a small one
+	expect_rejected(fp, offsetof(mi::header_t, tip_count) + 4, 1U << 29,
+			cfg);
+
+	std::filesystem::remove(fp);
+}
+
+TEST(VGTest, IndexKeepsTheRefs)
+{
+	namespace mi = mto::index;
+
+	const std::filesystem::path fp =
+		std::filesystem::temp_directory_path() / "povu_refs_test.pvg";
+
+	bd::VG g(3, 3, 2);
+	g.add_vertex(1, "ACGT");
+	g.add_vertex(2, "T");
+	g.add_vertex(3, "GGA");
+	g.add_edge(1, bd::v_end_e::r, 2, bd::v_end_e::l);
+	g.add_edge(2, bd::v_end_e::r, 3, bd::v_end_e::l);
+	g.add_edge(1, bd::v_end_e::r, 3, bd::v_end_e::l);
+
+	// two haplotypes of one sample, 1 2 3 and 1 3
+	std::vector<mi::walk_v_id_t> v_ids{1, 2, 3, 1, 3};
+	std::vector<mi::walk_strand_t> strands(5, liteseq::STRAND_FWD);
+	std::vector<mi::walk_locus_t> loci{0, 4, 5, 0, 4};
+	auto walk = [&](std::size_t first, pt::idx_t step_count)
+	{
+		liteseq::ref_walk w{};
+		w.v_ids = v_ids.data() + first;
+		w.strands = strands.data() + first;
+		w.loci = loci.data() + first;
+		w.step_count = step_count;
+		return w;
+	};
+
+	g.add_ref(pr::Ref::from_parts("HG1#1#chr1", "HG1", 1,
+				      liteseq::REF_ID_PANSN, 8, walk(0, 3)));
+	g.add_ref(pr::Ref::from_parts("HG1#2#chr1", "HG1", 2,
+				      liteseq::REF_ID_PANSN, 7, walk(3, 2)));
+	g.gen_vertex_step_index(2);
+	g.gen_genotype_metadata();
+	g.freeze();
+	mto::to_index::write_index(g, "in.gfa", fp);
+
+	core::config cfg;
+	cfg.set_inc_refs(true);
+	bd::VG *ig = mto::from_index::to_bd(fp.string(), cfg);
+
+	// the step index closes the file, the first step ref id is 5 steps of
+	// u32s and their padding before the step indexes
+	const std::uint64_t step_ref_ids =
+		std::filesystem::file_size(fp) - (2 * mi::align8(5 * 4));
+	expect_rejected(fp, step_ref_ids, 2, cfg);
+	std::filesystem::remove(fp);
+
+	ASSERT_EQ(ig->get_hap_count(), 2);
+	for (pt::id_t ref_id{}; ref_id < 2; ++ref_id) {
+		const pr::Ref &r = g.get_ref_by_id(ref_id);
+		const pr::Ref &ir = ig->get_ref_by_id(ref_id);
+		EXPECT_EQ(ir.tag(), r.tag());
+		EXPECT_EQ(ir.get_sample_name(), r.get_sample_name());
+		EXPECT_EQ(ir.get_hap_id(), r.get_hap_id());
+		EXPECT_EQ(ir.get_format(), r.get_format());
+		EXPECT_EQ(ir.get_length(), r.get_length());
+
+		const liteseq::ref_walk *w = g.get_ref_walk(ref_id);
+		const liteseq::ref_walk *iw = ig->get_ref_walk(ref_id);
+		ASSERT_EQ(iw->step_count, w->step_count);
+		for (pt::idx_t i{}; i < w->step_count; ++i) {
+			EXPECT_EQ(iw->v_ids[i], w->v_ids[i]);
+			EXPECT_EQ(iw->strands[i], w->strands[i]);
+			EXPECT_EQ(iw->loci[i], w->loci[i]);
+		}
+	}
+
+	EXPECT_EQ(ig->get_ref_id("HG1#2#chr1"), 1);
+	EXPECT_EQ(ig->get_ploidy("HG1"), 2);
+
+	auto to_vec = [](auto sp)
+	{ return std::vector<std::uint64_t>(sp.begin(), sp.end()); };
+	EXPECT_EQ(to_vec(ig->get_step_offsets()),
+		  to_vec(g.get_step_offsets()));
+	EXPECT_EQ(to_vec(ig->get_step_ref_ids()),
+		  to_vec(g.get_step_ref_ids()));
+	EXPECT_EQ(to_vec(ig->get_step_idxs()), to_vec(g.get_step_idxs()));
+
+	// vertex 3 is the third step of the first walk, the second of the other
+	pt::idx_t v_idx = ig->v_id_to_idx(3);
+	EXPECT_EQ(to_vec(ig->get_vertex_ref_idxs(v_idx, 0)),
+		  std::vector<std::uint64_t>{2});
+	EXPECT_EQ(to_vec(ig->get_vertex_ref_idxs(v_idx, 1)),
+		  std::vector<std::uint64_t>{1});
+
+	delete ig;
+}
+} // namespace povu::unit_tests_bidirected
@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "mto/from_gfa.hpp"
+#include "povu/common/app.hpp"
+#include "povu/graph/bidirected.hpp"
+
+namespace povu::unit_tests_gfa
+{
+namespace bd = povu::bidirected;
+namespace pgt = povu::types::graph;
+
+// read @p gfa with the native reader, the refs would need liteseq
+bd::VG *read_gfa(const std::string &gfa, pt::u8 thread_count = 1)
+{
+	const std::filesystem::path fp =
+		std::filesystem::temp_directory_path() / "povu_gfa_test.gfa";
+	{
+		std::ofstream out(fp, std::ios::binary);
+		out << gfa;
+	}
+
+	core::config cfg;
+	cfg.set_input_gfa(fp.string());
+	cfg.set_thread_count(thread_count);
+	cfg.set_inc_vtx_labels(true);
+
+	try {
+		bd::VG *g = mto::from_gfa::to_bd(cfg);
+		std::filesystem::remove(fp);
+		return g;
+	}
+	catch (...) {
+		std::filesystem::remove(fp);
+		throw;
+	}
+}
+
+// the message of the error reading @p gfa throws, empty if none
+std::string read_error(const std::string &gfa)
+{
+	try {
+		delete read_gfa(gfa);
+	}
+	catch (const std::runtime_error &e) {
+		return e.what();
+	}
+
+	return {};
+}
+
+// a chain of @p n segments with a bubble over every third one
+std::string gen_gfa(pt::id_t n, const std::string &eol)
+{
+	const std::string seq(60, 'A');
+	std::string gfa = "H\tVN:Z:1.0" + eol;
+	std::string links;
+	for (pt::id_t v_id{1}; v_id <= n; ++v_id) {
+		gfa += "S\t" + std::to_string(v_id) + "\t" + seq + "C" + eol;
+		if (v_id > 1)
+			links += "L\t" + std::to_string(v_id - 1) + "\t+\t" +
+				 std::to_string(v_id) + "\t+\t0M" + eol;
+		if (v_id > 2 && v_id % 3 == 0)
+			links += "L\t" + std::to_string(v_id - 2) + "\t+\t" +
+				 std::to_string(v_id) + "\t-\t0M" + eol;
+	}
+
+	return gfa + links;
+}
+
+void expect_same(const bd::VG &a, const bd::VG &b)
+{
+	ASSERT_EQ(a.vtx_count(), b.vtx_count());
+	for (pt::idx_t v_idx{}; v_idx < a.vtx_count(); ++v_idx) {
+		EXPECT_EQ(a.v_idx_to_id(v_idx), b.v_idx_to_id(v_idx));
+		EXPECT_EQ(a.get_vertex_by_idx(v_idx).get_label(),
+			  b.get_vertex_by_idx(v_idx).get_label());
+	}
+
+	ASSERT_EQ(a.edge_count(), b.edge_count());
+	for (pt::idx_t e_idx{}; e_idx < a.edge_count(); ++e_idx) {
+		const bd::Edge &ea = a.get_edge(e_idx);
+		const bd::Edge &eb = b.get_edge(e_idx);
+		EXPECT_EQ(ea.get_v1_idx(), eb.get_v1_idx());
+		EXPECT_EQ(ea.get_v1_end(), eb.get_v1_end());
+		EXPECT_EQ(ea.get_v2_idx(), eb.get_v2_idx());
+		EXPECT_EQ(ea.get_v2_end(), eb.get_v2_end());
+	}
+
+	ASSERT_EQ(a.tips().size(), b.tips().size());
+	auto b_tip = b.tips().begin();
+	for (const pgt::side_n_id_t &t : a.tips()) {
+		EXPECT_EQ(t.v_end, b_tip->v_end);
+		EXPECT_EQ(t.v_idx, b_tip->v_idx);
+		++b_tip;
+	}
+}
+
+TEST(GFATest, ChunkedParseMatchesSerial)
+{
+	constexpr pt::u8 THREADS = 4;
+	std::string gfa = gen_gfa(60000, "\n");
+
+	// a chunk is at least 1 MiB and cut at the first newline after these
+	ASSERT_GE(gfa.size(), std::size_t{THREADS} << 20);
+	for (std::size_t i{1}; i < THREADS; ++i)
+		ASSERT_NE(gfa[(gfa.size() / THREADS * i) - 1], '\n');
+
+	bd::VG *serial = read_gfa(gfa);
+	bd::VG *chunked = read_gfa(gfa, THREADS);
+	expect_same(*serial, *chunked);
+	EXPECT_EQ(serial->vtx_count(),
+		  std::count(gfa.begin(), gfa.end(), 'S'));
+
+	delete serial;
+	delete chunked;
+}
+
+TEST(GFATest, ChunkedParseReportsTheLine)
+{
+	constexpr pt::u8 THREADS = 4;
+	std::string gfa = gen_gfa(60000, "\n");
+
+	// break a record in the third chunk
+	std::size_t pos = gfa.find("\nS\t", gfa.size() / THREADS * 2) + 1;
+	gfa[pos] = 'X';
+	const std::size_t line_no =
+		std::count(gfa.begin(), gfa.begin() + pos, '\n') + 1;
+
+	std::string err;
+	try {
+		delete read_gfa(gfa, THREADS);
+	}
+	catch (const std::runtime_error &e) {
+		err = e.what();
+	}
+
+	EXPECT_NE(err.find("on line " + std::to_string(line_no)),
+		  std::string::npos)
+		<< err;
+}
+
+TEST(GFATest, CRLFAndNoFinalNewline)
+{
+	const std::string lf = "S\t1\tACGT\n"
+			       "S\t2\tT\n"
+			       "L\t1\t+\t2\t-\t0M\n";
+	const std::string crlf = "S\t1\tACGT\r\n"
+				 "S\t2\tT\r\n"
+				 "L\t1\t+\t2\t-\t0M";
+
+	bd::VG *a = read_gfa(lf);
+	bd::VG *b = read_gfa(crlf);
+	expect_same(*a, *b);
+	EXPECT_EQ(b->get_vertex_by_id(2).get_label(), "T");
+	delete a;
+	delete b;
+
+	// the same across chunks
+	std::string big = gen_gfa(40000, "\r\n");
+	big.resize(big.size() - 2);
+	std::string big_lf = gen_gfa(40000, "\n");
+	a = read_gfa(big_lf);
+	b = read_gfa(big, 3);
+	expect_same(*a, *b);
+	delete a;
+	delete b;
+}
+
+TEST(GFATest, LinkToMissingSegment)
+{
+	std::string err = read_error("S\t1\tA\n"
+				     "S\t2\tC\n"
+				     "L\t1\t+\t2\t+\t0M\n"
+				     "L\t2\t+\t3\t+\t0M\n");
+
+	EXPECT_NE(err.find("L record on line 4"), std::string::npos) << err;
+	EXPECT_NE(err.find("missing segment 3"), std::string::npos) << err;
+}
+
+TEST(GFATest, RepeatedSegmentId)
+{
+	std::string err = read_error("H\tVN:Z:1.0\n"
+				     "S\t2\tC\n"
+				     "S\t1\tA\n"
+				     "S\t2\tG\n");
+
+	EXPECT_NE(err.find("S record on line 4"), std::string::npos) << err;
+	EXPECT_NE(err.find("repeats segment id 2"), std::string::npos) << err;
+}
+
+TEST(GFATest, PathAndWalkSteps)
+{
+	const std::string segs = "S\t1\tA\nS\t2\tC\nL\t1\t+\t2\t+\t0M\n";
+
+	bd::VG *g = read_gfa(segs + "P\tx\t1+,2-\t*\n"
+				    "W\ts\t0\tc\t0\t2\t>1<2\n");
+	EXPECT_EQ(g->vtx_count(), 2U);
+	delete g;
+
+	std::string err = read_error(segs + "P\tx\t1+,2\t*\n");
+	EXPECT_NE(err.find("P record on line 4 has an invalid orientation"),
+		  std::string::npos)
+		<< err;
+
+	err = read_error(segs + "P\tx\t1+,b+\t*\n");
+	EXPECT_NE(err.find("non-numeric segment id 'b'"), std::string::npos)
+		<< err;
+
+	err = read_error(segs + "W\ts\t0\tc\t0\t2\t>1+2\n");
+	EXPECT_NE(err.find("W record on line 4"), std::string::npos) << err;
+
+	err = read_error(segs + "W\ts\t0\tc\t0\t2\t1>2\n");
+	EXPECT_NE(err.find("W record on line 4 has an invalid orientation"),
+		  std::string::npos)
+		<< err;
+
+	err = read_error(segs + "W\ts\t0\tc\n");
+	EXPECT_NE(err.find("fewer than 7 columns"), std::string::npos) << err;
+}
+
+TEST(GFATest, NoSegments)
+{
+	EXPECT_NE(read_error("").find("no vertices"), std::string::npos);
+	EXPECT_NE(read_error("H\tVN:Z:1.0\n").find("no vertices"),
+		  std::string::npos);
+}
+} // namespace povu::unit_tests_gfa
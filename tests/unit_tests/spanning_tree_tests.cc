@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include "povu/common/arena.hpp"
 #include "povu/graph/bidirected.hpp"
 #include "povu/graph/pvst.hpp"
 #include "povu/graph/spanning_tree.hpp"
@@ -42,4 +43,66 @@ TEST(SpanningTreeTest, ConstructSpanningTree)
 	delete vg;
 }
 
+TEST(SpanningTreeTest, FreezeKeepsAdjacency)
+{
+	bd::VG *vg = create_test_vg();
+	pst::Tree st = pst::Tree::from_bd(*vg);
+	delete vg;
+
+	auto to_vec = [](pv_cmp::span<const pt::idx_t> s)
+	{
+		return std::vector<pt::idx_t>(s.begin(), s.end());
+	};
+
+	std::vector<std::vector<pt::idx_t>> children, obe, ibe;
+	for (pt::idx_t v_idx{}; v_idx < st.vtx_count(); ++v_idx) {
+		children.push_back(to_vec(st.get_children(v_idx)));
+		obe.push_back(to_vec(st.get_obe_idxs(v_idx)));
+		ibe.push_back(to_vec(st.get_ibe_idxs(v_idx)));
+	}
+
+	EXPECT_THROW((void)st.get_obe_tgt_v_idxs(0), std::logic_error);
+	st.freeze();
+	ASSERT_TRUE(st.is_frozen());
+
+	for (pt::idx_t v_idx{}; v_idx < st.vtx_count(); ++v_idx) {
+		EXPECT_EQ(to_vec(st.get_children(v_idx)), children[v_idx]);
+		EXPECT_EQ(to_vec(st.get_obe_idxs(v_idx)), obe[v_idx]);
+		EXPECT_EQ(to_vec(st.get_ibe_idxs(v_idx)), ibe[v_idx]);
+
+		std::set<pt::idx_t> tgts;
+		for (pt::idx_t be_idx : obe[v_idx])
+			tgts.insert(st.get_be(be_idx).get_tgt());
+
+		EXPECT_EQ(to_vec(st.get_obe_tgt_v_idxs(v_idx)),
+			  std::vector<pt::idx_t>(tgts.begin(), tgts.end()));
+	}
+}
+
+TEST(SpanningTreeTest, ArenaTreeMatchesHeapTree)
+{
+	bd::VG *vg = create_test_vg();
+	povu::arena::Arena arena;
+	pst::Tree heap_st = pst::Tree::from_bd(*vg);
+	pst::Tree arena_st = pst::Tree::from_bd(*vg, &arena);
+	delete vg;
+
+	EXPECT_GT(arena.used(), 0U);
+	ASSERT_EQ(arena_st.vtx_count(), heap_st.vtx_count());
+
+	auto to_vec = [](pv_cmp::span<const pt::idx_t> s)
+	{
+		return std::vector<pt::idx_t>(s.begin(), s.end());
+	};
+
+	for (pt::idx_t v_idx{}; v_idx < heap_st.vtx_count(); ++v_idx) {
+		EXPECT_EQ(to_vec(arena_st.get_children(v_idx)),
+			  to_vec(heap_st.get_children(v_idx)));
+		EXPECT_EQ(to_vec(arena_st.get_obe_idxs(v_idx)),
+			  to_vec(heap_st.get_obe_idxs(v_idx)));
+		EXPECT_EQ(to_vec(arena_st.get_ibe_idxs(v_idx)),
+			  to_vec(heap_st.get_ibe_idxs(v_idx)));
+	}
+}
+
 } // namespace povu::unit_tests_spanning_tree
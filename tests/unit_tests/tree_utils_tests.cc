@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+
+#include "povu/graph/tree_utils.hpp"
+
+namespace povu::unit_tests_tree_utils
+{
+namespace ptu = povu::tree_utils;
+
+TEST(TreeUtilsTest, RMQMatchesLinearScan)
+{
+	// spans several blocks with many repeated values so that ties between
+	// equal minima are exercised
+	std::vector<pt::idx_t> a;
+	for (pt::idx_t i{}; i < 300; ++i)
+		a.push_back((i * 37) % 11);
+
+	ptu::RMQ rmq(a);
+
+	for (pt::idx_t l{}; l < a.size(); l += 7) {
+		for (pt::idx_t r{l}; r < a.size(); r += 5) {
+			pt::idx_t exp{l};
+			for (pt::idx_t i{l}; i <= r; ++i)
+				if (a[i] < a[exp])
+					exp = i;
+
+			EXPECT_EQ(rmq.query(a, l, r), exp);
+		}
+	}
+}
+
+} // namespace povu::unit_tests_tree_utils